@@ -0,0 +1,805 @@
+//==============================================================================
+//! Dynamic bounding volume hierarchy.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "assert.hpp"
+#include "math.hpp"
+#include "task_pool.hpp"
+#include "spatial_index.hpp"
+
+namespace bklib {
+//==============================================================================
+//! A binary tree of bounding rects over float bounds, for objects that move
+//! every frame; @see spatial_index.hpp for the interface.
+//!
+//! Each leaf stores "fat" bounds: the object's bounds enlarged by a margin.
+//! An update only touches the tree once the object leaves its fat bounds;
+//! otherwise, just the exact bounds are stored. Leaves are inserted next to the
+//! sibling that grows the tree's total perimeter least, and the path back to
+//! the root is rebalanced by rotations (as an AVL tree), so insert, remove and
+//! (moving) update are O(log n).
+//!
+//! Nodes live in one contiguous pool, with unused nodes in a free list. The
+//! exact bounds and values are kept apart, by slot: each leaf names its slot,
+//! and each slot its leaf and a generation (odd while live, as in slot_map).
+//! A handle is a slot and its generation, rather than a node: the pool is
+//! shared with the internal nodes, which reuse the nodes of removed leaves.
+//! Queries prune by the fat bounds and test the exact bounds; pairs are
+//! found by walking the tree against itself, in parallel by subtree with
+//! find_pairs().
+//==============================================================================
+template <typename T>
+class aabb_tree {
+public:
+    using rect       = axis_aligned_rect<float>;
+    using point      = point2d<float>;
+    using vector     = vector2d<float>;
+    using circle     = bklib::circle<float>;
+    using handle     = spatial_handle;
+    using value_type = T;
+
+    //--------------------------------------------------------------------------
+    //! @param margin How far leaves are enlarged on each side.
+    //! @pre margin >= 0.
+    //--------------------------------------------------------------------------
+    explicit aabb_tree(float const margin)
+      : margin_ {margin}
+    {
+        BK_ASSERT(margin >= 0.0f);
+    }
+
+    //--------------------------------------------------------------------------
+    handle insert(rect const bounds, T value) {
+        auto const s    = acquire_slot_();
+        auto const leaf = allocate_();
+
+        auto& n = nodes_[leaf];
+        n.bounds = enlarge_(bounds);
+        n.left   = s;
+        n.height = 0;
+
+        slots_[s].leaf = leaf;
+        exact_[s]  = bounds;
+        values_[s] = std::move(value);
+
+        insert_leaf_(leaf);
+        ++size_;
+
+        return handle {s, slots_[s].generation};
+    }
+
+    //! @pre contains(h).
+    void remove(handle const h) {
+        BK_ASSERT(contains(h));
+
+        auto const leaf = slots_[h.index].leaf;
+
+        remove_leaf_(leaf);
+        release_(leaf);
+        release_slot_(h.index);
+
+        --size_;
+    }
+
+    //! @pre contains(h).
+    //! @returns true if the value left its fat bounds (and was reinserted).
+    bool update(handle const h, rect const bounds) {
+        BK_ASSERT(contains(h));
+
+        auto const leaf  = slots_[h.index].leaf;
+        auto const moved = bounds.top_left() - exact_[h.index].top_left();
+        exact_[h.index] = bounds;
+
+        if (contains_(nodes_[leaf].bounds, bounds)) {
+            return false;
+        }
+
+        remove_leaf_(leaf);
+        nodes_[leaf].bounds = enlarge_(bounds, moved);
+        insert_leaf_(leaf);
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    bool contains(handle const h) const BK_NOEXCEPT {
+        return h.index < slots_.size() && slots_[h.index].generation == h.generation;
+    }
+
+    //! @pre contains(h).
+    rect const& bounds(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return exact_[h.index];
+    }
+
+    //! The enlarged bounds stored in the tree.
+    //! @pre contains(h).
+    rect const& fat_bounds(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return nodes_[slots_[h.index].leaf].bounds;
+    }
+
+    //! @pre contains(h).
+    T const& value(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    //! @pre contains(h).
+    T& value(handle const h) BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    size_t size()  const BK_NOEXCEPT { return size_; }
+    bool   empty() const BK_NOEXCEPT { return size_ == 0; }
+
+    float  margin() const BK_NOEXCEPT { return margin_; }
+
+    //! The height of the tree: 0 for a single leaf, -1 if empty.
+    int height() const BK_NOEXCEPT {
+        return root_ == NONE ? -1 : nodes_[root_].height;
+    }
+
+    //! Remove every value; the slots are kept, so that the handles to them
+    //! stay stale.
+    void clear() {
+        for (index s = 0; s < slots_.size(); ++s) {
+            if (slots_[s].generation & 1) {
+                release_slot_(s);
+            }
+        }
+
+        nodes_.clear();
+        root_ = NONE;
+        free_ = NONE;
+        size_ = 0;
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds intersect @c r.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(rect const r, F&& f) const {
+        visit_(
+            [&](rect const& b) { return intersects(b, r); }
+          , [&](index const s) {
+                if (intersects(exact_[s], r)) {
+                    f(values_[s]);
+                }
+                return true;
+            }
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds contain @c p.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(point const p, F&& f) const {
+        visit_(
+            [&](rect const& b) { return intersects(b, p); }
+          , [&](index const s) {
+                if (intersects(exact_[s], p)) {
+                    f(values_[s]);
+                }
+                return true;
+            }
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds intersect @c c.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(circle const c, F&& f) const {
+        rect const box {rect::allow_malformed {}
+          , c.p.x - c.r, c.p.y - c.r, c.p.x + c.r, c.p.y + c.r};
+
+        visit_(
+            [&](rect const& b) { return intersects(b, box); }
+          , [&](index const s) {
+                if (intersects_circle_(exact_[s], c)) {
+                    f(values_[s]);
+                }
+                return true;
+            }
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    //! Cast the ray origin + t * dir for t in [0, max_t].
+    //!
+    //! f(T const& value, float t) is called for the values whose bounds the ray
+    //! hits, with the t at which it enters them (0 if it starts inside), in no
+    //! particular order. f returns the new max_t: t to find the nearest hit,
+    //! max_t to find every hit, or a negative value to stop.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void ray_cast(point const origin, vector const dir, float max_t, F&& f) const {
+        visit_(
+            [&](rect const& b) {
+                float t;
+                return ray_hits_(b, origin, dir, max_t, t);
+            }
+          , [&](index const s) {
+                float t;
+                if (ray_hits_(exact_[s], origin, dir, max_t, t)) {
+                    max_t = f(values_[s], t);
+                }
+                return max_t >= 0.0f;
+            }
+        );
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const& a, T const& b) once for each pair of values whose bounds
+    //! intersect.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void for_each_pair(F&& f) const {
+        if (root_ == NONE) {
+            return;
+        }
+
+        auto const g = [&](index const a, index const b) { f(values_[a], values_[b]); };
+        pairs_within_(root_, g);
+    }
+
+    //--------------------------------------------------------------------------
+    //! Every pair of handles whose bounds intersect, {lower, higher}, found in
+    //! parallel on @c pool; the result does not depend on the pool's size.
+    //--------------------------------------------------------------------------
+    std::vector<spatial_pair> find_pairs(task_pool& pool) const {
+        std::vector<spatial_pair> result;
+        if (root_ == NONE) {
+            return result;
+        }
+
+        // the top of the recursion, unrolled into independent tasks.
+        std::vector<pair_task> tasks {pair_task {root_, root_}};
+        std::vector<pair_task> next;
+
+        for (int level = 0; level < SPLIT_LEVELS; ++level) {
+            next.clear();
+            for (auto const t : tasks) {
+                split_(t, next);
+            }
+            tasks.swap(next);
+        }
+
+        std::vector<std::vector<spatial_pair>> found (tasks.size());
+
+        pool.parallel_for(0, tasks.size(), [&](size_t const i) {
+            auto&      out = found[i];
+            auto const g   = [&](index const a, index const b) {
+                out.emplace_back(handle_of_(std::min(a, b)), handle_of_(std::max(a, b)));
+            };
+
+            auto const t = tasks[i];
+            if (t.a == t.b) {
+                pairs_within_(t.a, g);
+            } else {
+                pairs_between_(t.a, t.b, g);
+            }
+        });
+
+        size_t n = 0;
+        for (auto const& pairs : found) {
+            n += pairs.size();
+        }
+
+        result.reserve(n);
+        for (auto const& pairs : found) {
+            result.insert(result.end(), pairs.begin(), pairs.end());
+        }
+
+        return result;
+    }
+private:
+    using index = uint32_t;
+
+    static index const NONE = 0xFFFFFFFFu;
+
+    //! The deepest tree a query can walk; far more than balance allows.
+    static size_t const MAX_HEIGHT = 128;
+
+    //! How many levels of the pair recursion find_pairs splits into tasks.
+    static int const SPLIT_LEVELS = 6;
+
+    struct node {
+        rect    bounds; //!< Fat for leaves; the union of the children otherwise.
+        index   parent; //!< The next free node, while free.
+        index   left;   //!< The slot, for leaves.
+        index   right;
+        int32_t height; //!< 0 for leaves; -1 while free.
+
+        bool  is_leaf() const BK_NOEXCEPT { return height == 0; }
+        index slot()    const BK_NOEXCEPT { return left; }
+    };
+
+    struct leaf_slot {
+        index    leaf;       //!< The next free slot, while free.
+        uint32_t generation; //!< Odd while live.
+    };
+
+    //! Pairs within the subtree a (if a == b), or between subtrees a and b.
+    struct pair_task {
+        index a;
+        index b;
+    };
+
+    //--------------------------------------------------------------------------
+    static rect union_of_(rect const& a, rect const& b) BK_NOEXCEPT {
+        return rect {rect::allow_malformed {}
+          , std::min(a.left(),  b.left()),  std::min(a.top(),    b.top())
+          , std::max(a.right(), b.right()), std::max(a.bottom(), b.bottom())
+        };
+    }
+
+    static float perimeter_(rect const& r) BK_NOEXCEPT {
+        return 2.0f * (r.width() + r.height());
+    }
+
+    static bool contains_(rect const& outer, rect const& inner) BK_NOEXCEPT {
+        return outer.left()  <= inner.left()  && outer.top()    <= inner.top()
+            && outer.right() >= inner.right() && outer.bottom() >= inner.bottom();
+    }
+
+    //! c intersects r if the point of r nearest its center is inside it.
+    static bool intersects_circle_(rect const& r, circle const& c) BK_NOEXCEPT {
+        point const nearest {
+            std::min(std::max(c.p.x, r.left()), r.right())
+          , std::min(std::max(c.p.y, r.top()),  r.bottom())
+        };
+
+        return intersects(c, nearest);
+    }
+
+    //! The slab test: whether origin + t * dir enters r for some t in
+    //! [0, max_t], and the first such t.
+    static bool ray_hits_(rect const& r, point const origin, vector const dir, float const max_t, float& t) BK_NOEXCEPT {
+        float t0 = 0.0f;
+        float t1 = max_t;
+
+        auto const slab = [&](float const p, float const d, float const lo, float const hi) {
+            if (d == 0.0f) {
+                return lo <= p && p <= hi;
+            }
+
+            auto const inverse = 1.0f / d;
+            auto a = (lo - p) * inverse;
+            auto b = (hi - p) * inverse;
+            if (a > b) {
+                std::swap(a, b);
+            }
+
+            t0 = std::max(t0, a);
+            t1 = std::min(t1, b);
+
+            return t0 <= t1;
+        };
+
+        if (!slab(origin.x, dir.x, r.left(), r.right())
+         || !slab(origin.y, dir.y, r.top(),  r.bottom())
+        ) {
+            return false;
+        }
+
+        t = t0;
+        return true;
+    }
+
+    //! r enlarged by the margin, and further ahead along its last move (by
+    //! four times the move, up to four margins) so that objects moving
+    //! steadily stay in their fat bounds longer.
+    rect enlarge_(rect const& r, vector const moved = vector {0.0f, 0.0f}) const BK_NOEXCEPT {
+        float const prediction = 4.0f;
+
+        auto const limit = prediction * margin_;
+        auto const dx    = std::min(std::max(prediction * moved.x, -limit), limit);
+        auto const dy    = std::min(std::max(prediction * moved.y, -limit), limit);
+
+        return rect {rect::allow_malformed {}
+          , r.left()  - margin_ + std::min(dx, 0.0f), r.top()    - margin_ + std::min(dy, 0.0f)
+          , r.right() + margin_ + std::max(dx, 0.0f), r.bottom() + margin_ + std::max(dy, 0.0f)
+        };
+    }
+
+    //--------------------------------------------------------------------------
+    //! Depth first: descend into nodes for which enter(bounds) is true, and
+    //! call leaf(slot) for each leaf entered; stop once it returns false.
+    //--------------------------------------------------------------------------
+    template <typename Enter, typename Leaf>
+    void visit_(Enter&& enter, Leaf&& leaf) const {
+        if (root_ == NONE) {
+            return;
+        }
+
+        // each pop pushes at most two, so the stack never exceeds height + 1.
+        BK_ASSERT(static_cast<size_t>(nodes_[root_].height) < MAX_HEIGHT);
+
+        std::array<index, MAX_HEIGHT> stack;
+        size_t top = 0;
+        stack[top++] = root_;
+
+        while (top) {
+            auto const  i = stack[--top];
+            auto const& n = nodes_[i];
+
+            if (!enter(n.bounds)) {
+                continue;
+            }
+
+            if (n.is_leaf()) {
+                if (!leaf(n.slot())) {
+                    return;
+                }
+            } else {
+                stack[top++] = n.left;
+                stack[top++] = n.right;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(a, b) for each pair of intersecting leaves in the subtree at @c n, by
+    //! slot.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void pairs_within_(index const n, F& f) const {
+        auto const& node = nodes_[n];
+        if (node.is_leaf()) {
+            return;
+        }
+
+        pairs_within_(node.left,  f);
+        pairs_within_(node.right, f);
+        pairs_between_(node.left, node.right, f);
+    }
+
+    //! f(a, b) for each intersecting leaf a under @c a and leaf b under @c b;
+    //! descends into the larger of the two first.
+    template <typename F>
+    void pairs_between_(index const a, index const b, F& f) const {
+        auto const& na = nodes_[a];
+        auto const& nb = nodes_[b];
+
+        if (!intersects(na.bounds, nb.bounds)) {
+            return;
+        }
+
+        if (na.is_leaf() && nb.is_leaf()) {
+            if (intersects(exact_[na.slot()], exact_[nb.slot()])) {
+                f(na.slot(), nb.slot());
+            }
+        } else if (descend_a_(na, nb)) {
+            pairs_between_(na.left,  b, f);
+            pairs_between_(na.right, b, f);
+        } else {
+            pairs_between_(a, nb.left,  f);
+            pairs_between_(a, nb.right, f);
+        }
+    }
+
+    //! Whether to split a (rather than b): the larger, unless it is a leaf.
+    static bool descend_a_(node const& a, node const& b) BK_NOEXCEPT {
+        return b.is_leaf() || (!a.is_leaf() && perimeter_(a.bounds) >= perimeter_(b.bounds));
+    }
+
+    //! The tasks pairs_within_ / pairs_between_ would recurse into, or the task
+    //! itself if it is a single pair of leaves (or nothing, if it finds none).
+    void split_(pair_task const t, std::vector<pair_task>& out) const {
+        auto const& na = nodes_[t.a];
+        auto const& nb = nodes_[t.b];
+
+        if (t.a == t.b) {
+            if (!na.is_leaf()) {
+                out.push_back(pair_task {na.left,  na.left});
+                out.push_back(pair_task {na.right, na.right});
+                out.push_back(pair_task {na.left,  na.right});
+            }
+        } else if (!intersects(na.bounds, nb.bounds)) {
+            return;
+        } else if (na.is_leaf() && nb.is_leaf()) {
+            out.push_back(t);
+        } else if (descend_a_(na, nb)) {
+            out.push_back(pair_task {na.left,  t.b});
+            out.push_back(pair_task {na.right, t.b});
+        } else {
+            out.push_back(pair_task {t.a, nb.left});
+            out.push_back(pair_task {t.a, nb.right});
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    index allocate_() {
+        if (free_ == NONE) {
+            nodes_.push_back(node {});
+            return static_cast<index>(nodes_.size() - 1);
+        }
+
+        auto const i = free_;
+        free_ = nodes_[i].parent;
+        return i;
+    }
+
+    void release_(index const i) BK_NOEXCEPT {
+        nodes_[i].parent = free_;
+        nodes_[i].height = -1;
+        free_ = i;
+    }
+
+    index acquire_slot_() {
+        if (free_slot_ == NONE) {
+            BK_ASSERT(slots_.size() < NONE);
+
+            slots_.push_back(leaf_slot {NONE, 1});
+            exact_.emplace_back();
+            values_.emplace_back();
+            return static_cast<index>(slots_.size() - 1);
+        }
+
+        auto const s = free_slot_;
+        free_slot_ = slots_[s].leaf;
+        ++slots_[s].generation;
+        return s;
+    }
+
+    void release_slot_(index const s) {
+        ++slots_[s].generation;
+        slots_[s].leaf = free_slot_;
+        values_[s] = T {};
+        free_slot_ = s;
+    }
+
+    handle handle_of_(index const s) const BK_NOEXCEPT {
+        return handle {s, slots_[s].generation};
+    }
+
+    //--------------------------------------------------------------------------
+    //! Pair @c leaf with the sibling that least increases the sum of the
+    //! perimeters of the internal nodes. A single descent, toward the child
+    //! with the lower bound on that cost, stopping once neither child can beat
+    //! the best sibling seen; children that both contain the leaf (and so have
+    //! equal bounds) are told apart by the distance to their centers.
+    //--------------------------------------------------------------------------
+    void insert_leaf_(index const leaf) {
+        if (root_ == NONE) {
+            root_ = leaf;
+            nodes_[leaf].parent = NONE;
+            return;
+        }
+
+        auto const bounds    = nodes_[leaf].bounds;
+        auto const perimeter = perimeter_(bounds);
+        auto const center    = bounds.center();
+
+        auto const infinity = std::numeric_limits<float>::infinity();
+
+        // the cost of pairing with a node is the perimeter of the new parent
+        // (direct), plus how much the node's ancestors grow (inherited).
+        auto  i         = root_;
+        auto  area      = perimeter_(nodes_[i].bounds);
+        auto  direct    = perimeter_(union_of_(nodes_[i].bounds, bounds));
+        float inherited = 0.0f;
+
+        auto sibling   = root_;
+        auto best_cost = direct;
+
+        while (!nodes_[i].is_leaf()) {
+            auto const& n = nodes_[i];
+
+            auto const cost = direct + inherited;
+            if (cost < best_cost) {
+                best_cost = cost;
+                sibling   = i;
+            }
+
+            inherited += direct - area;
+
+            index const children[] = {n.left, n.right};
+            float       areas[2];
+            float       directs[2];
+            float       lower[2];
+            bool        leaves[2];
+
+            for (int k = 0; k < 2; ++k) {
+                auto const& c = nodes_[children[k]];
+
+                areas[k]   = perimeter_(c.bounds);
+                directs[k] = perimeter_(union_of_(c.bounds, bounds));
+                leaves[k]  = c.is_leaf();
+                lower[k]   = infinity;
+
+                if (leaves[k]) {
+                    auto const leaf_cost = directs[k] + inherited;
+                    if (leaf_cost < best_cost) {
+                        best_cost = leaf_cost;
+                        sibling   = children[k];
+                    }
+                } else {
+                    lower[k] = inherited + directs[k] + std::min(perimeter - areas[k], 0.0f);
+                }
+            }
+
+            if ((leaves[0] && leaves[1]) || (best_cost <= lower[0] && best_cost <= lower[1])) {
+                break;
+            }
+
+            if (lower[0] == lower[1] && !leaves[0]) {
+                lower[0] = distance2(nodes_[children[0]].bounds.center(), center);
+                lower[1] = distance2(nodes_[children[1]].bounds.center(), center);
+            }
+
+            auto const k = (lower[0] < lower[1] && !leaves[0]) ? 0 : 1;
+
+            i      = children[k];
+            area   = areas[k];
+            direct = directs[k];
+        }
+
+        // new parent of sibling and leaf, in sibling's place.
+        auto const old_parent = nodes_[sibling].parent;
+        auto const parent     = allocate_();
+
+        {
+            auto& p = nodes_[parent];
+            p.parent = old_parent;
+            p.left   = sibling;
+            p.right  = leaf;
+            p.bounds = union_of_(bounds, nodes_[sibling].bounds);
+            p.height = nodes_[sibling].height + 1;
+        }
+
+        replace_child_(old_parent, sibling, parent);
+        nodes_[sibling].parent = parent;
+        nodes_[leaf].parent    = parent;
+
+        refit_(old_parent);
+    }
+
+    //--------------------------------------------------------------------------
+    //! Unlink @c leaf; its sibling takes the place of their parent.
+    //--------------------------------------------------------------------------
+    void remove_leaf_(index const leaf) BK_NOEXCEPT {
+        if (leaf == root_) {
+            root_ = NONE;
+            return;
+        }
+
+        auto const parent      = nodes_[leaf].parent;
+        auto const grandparent = nodes_[parent].parent;
+        auto const sibling     = (nodes_[parent].left == leaf)
+          ? nodes_[parent].right : nodes_[parent].left;
+
+        replace_child_(grandparent, parent, sibling);
+        nodes_[sibling].parent = grandparent;
+        release_(parent);
+
+        refit_(grandparent);
+    }
+
+    //! Point the parent of @c from (or root_, if none) at @c to.
+    void replace_child_(index const parent, index const from, index const to) BK_NOEXCEPT {
+        if (parent == NONE) {
+            root_ = to;
+        } else if (nodes_[parent].left == from) {
+            nodes_[parent].left = to;
+        } else {
+            nodes_[parent].right = to;
+        }
+    }
+
+    //! Rebalance and recompute the bounds and height of @c i and its ancestors.
+    void refit_(index i) BK_NOEXCEPT {
+        while (i != NONE) {
+            i = balance_(i);
+
+            auto&       n = nodes_[i];
+            auto const& l = nodes_[n.left];
+            auto const& r = nodes_[n.right];
+
+            n.height = 1 + std::max(l.height, r.height);
+            n.bounds = union_of_(l.bounds, r.bounds);
+
+            i = n.parent;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! If the subtrees of @c a differ in height by more than one, promote the
+    //! taller child c in a's place, with a taking c's shorter child.
+    //! @returns The root of the subtree.
+    //--------------------------------------------------------------------------
+    index balance_(index const a) BK_NOEXCEPT {
+        auto& na = nodes_[a];
+        if (na.is_leaf() || na.height < 2) {
+            return a;
+        }
+
+        auto const b = na.left;
+        auto const c = na.right;
+
+        auto const balance = nodes_[c].height - nodes_[b].height;
+
+        if (balance > 1) {
+            return rotate_(a, c, b);
+        } else if (balance < -1) {
+            return rotate_(a, b, c);
+        }
+
+        return a;
+    }
+
+    //! Promote @c up (a child of @c a) over @c a; @c other is a's other child.
+    index rotate_(index const a, index const up, index const other) BK_NOEXCEPT {
+        auto& na = nodes_[a];
+        auto& nu = nodes_[up];
+
+        auto const f = nu.left;
+        auto const g = nu.right;
+
+        // up takes a's place.
+        nu.parent = na.parent;
+        na.parent = up;
+        replace_child_(nu.parent, a, up);
+
+        // the taller of up's children stays with it; a adopts the other.
+        auto const keep  = (nodes_[f].height > nodes_[g].height) ? f : g;
+        auto const adopt = (keep == f) ? g : f;
+
+        nu.left  = a;
+        nu.right = keep;
+
+        if (na.left == up) {
+            na.left = adopt;
+        } else {
+            na.right = adopt;
+        }
+        nodes_[adopt].parent = a;
+
+        na.bounds = union_of_(nodes_[other].bounds, nodes_[adopt].bounds);
+        na.height = 1 + std::max(nodes_[other].height, nodes_[adopt].height);
+
+        nu.bounds = union_of_(na.bounds, nodes_[keep].bounds);
+        nu.height = 1 + std::max(na.height, nodes_[keep].height);
+
+        return up;
+    }
+
+    float margin_;
+
+    std::vector<node> nodes_;
+
+    // by slot.
+    std::vector<leaf_slot> slots_;
+    std::vector<rect>      exact_;
+    std::vector<T>         values_;
+
+    index  root_      = NONE;
+    index  free_      = NONE;
+    index  free_slot_ = NONE;
+    size_t size_      = 0;
+};
+
+template <typename T>
+typename aabb_tree<T>::index const aabb_tree<T>::NONE;
+
+template <typename T>
+size_t const aabb_tree<T>::MAX_HEIGHT;
+
+template <typename T>
+int const aabb_tree<T>::SPLIT_LEVELS;
+
+} //namespace bklib
@@ -15,11 +15,3 @@
 
 #define BK_PRECOND(condition) BK_IF_NOT_THEN((condition), BK_BREAK_AND_EXIT());
 #define BK_ASSERT(condition) BK_IF_NOT_THEN((condition), BK_BREAK_AND_EXIT());
-
-//#define BK_ASSERT(condition) \
-//do { \
-//    if (!(condition)) { \
-//        BK_DEBUG_BREAK(); \
-//        std::abort(); \
-//    } \
-//} while (!(condition))
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include "circle_collision.hpp"
+#include "spatial_grid.hpp"
+#include "task_pool.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+//==============================================================================
+//! Circles of uniform density, with the candidate pairs of a spatial_grid.
+//==============================================================================
+struct circle_world {
+    static int const SIZE = 4096;
+
+    explicit circle_world(size_t const n) {
+        std::mt19937 rng {42};
+        std::uniform_real_distribution<float> coord  {16, SIZE - 16};
+        std::uniform_real_distribution<float> radius {2, 8};
+
+        bklib::spatial_grid<uint32_t> grid {bklib::axis_aligned_rect<int> {0, 0, SIZE, SIZE}, 32};
+
+        for (size_t i = 0; i < n; ++i) {
+            bklib::circle<float> const c {{coord(rng), coord(rng)}, radius(rng)};
+            circles.push_back(c);
+
+            auto const x = static_cast<int>(c.p.x);
+            auto const y = static_cast<int>(c.p.y);
+            auto const r = static_cast<int>(c.r) + 2;
+            grid.insert(bklib::axis_aligned_rect<int> {x - r, y - r, x + r, y + r}, static_cast<uint32_t>(i));
+        }
+
+        grid.for_each_pair([&](uint32_t const a, uint32_t const b) {
+            candidates.emplace_back(a, b);
+        });
+    }
+
+    bklib::circle_array              circles;
+    std::vector<bklib::circle_pair>  candidates;
+};
+
+circle_world const& world() {
+    static circle_world const result {100000};
+    return result;
+}
+} //namespace
+
+//==============================================================================
+// Narrowing the candidates to contacts.
+//==============================================================================
+//! One pair at a time, with the two square roots of distance and direction.
+void find_contacts_two_sqrt(benchmark::State& state) {
+    auto const& w = world();
+    std::vector<bklib::circle<float>> circles;
+    for (size_t i = 0; i < w.circles.size(); ++i) {
+        circles.push_back(w.circles[i]);
+    }
+
+    std::vector<bklib::circle_pair>     pairs;
+    std::vector<bklib::vector2d<float>> vectors;
+
+    for (auto _ : state) {
+        pairs.clear();
+        vectors.clear();
+
+        for (auto const& p : w.candidates) {
+            auto const a = circles[p.first];
+            auto const b = circles[p.second];
+            if (intersects(a, b)) {
+                pairs.push_back(p);
+                vectors.push_back(-bklib::distance<float>(a, b) * bklib::direction<float>(a.p - b.p));
+            }
+        }
+
+        benchmark::DoNotOptimize(vectors.data());
+    }
+
+    state.counters["contacts"] = static_cast<double>(pairs.size());
+    state.SetItemsProcessed(state.iterations() * w.candidates.size());
+}
+BENCHMARK(find_contacts_two_sqrt)->Unit(benchmark::kMicrosecond);
+
+void find_contacts(benchmark::State& state) {
+    auto const& w = world();
+    bklib::circle_contacts contacts;
+
+    for (auto _ : state) {
+        bklib::find_contacts(w.circles, w.candidates.data(), w.candidates.size(), contacts);
+        benchmark::DoNotOptimize(contacts.x.data());
+    }
+
+    state.counters["contacts"] = static_cast<double>(contacts.size());
+    state.SetItemsProcessed(state.iterations() * w.candidates.size());
+}
+BENCHMARK(find_contacts)->Unit(benchmark::kMicrosecond);
+
+//==============================================================================
+// Applying the contacts.
+//==============================================================================
+void resolve_contacts(benchmark::State& state) {
+    auto const& w = world();
+    auto circles = w.circles;
+
+    bklib::circle_contacts contacts;
+    bklib::find_contacts(circles, w.candidates.data(), w.candidates.size(), contacts);
+
+    for (auto _ : state) {
+        bklib::resolve_contacts(circles, contacts);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * contacts.size());
+}
+BENCHMARK(resolve_contacts)->Unit(benchmark::kMicrosecond);
+
+void resolve_contacts_pool(benchmark::State& state) {
+    auto const& w = world();
+    auto circles = w.circles;
+    auto& pool = bklib::task_pool::shared();
+
+    bklib::circle_contacts contacts;
+    bklib::find_contacts(circles, w.candidates.data(), w.candidates.size(), contacts);
+
+    for (auto _ : state) {
+        bklib::resolve_contacts(circles, contacts, pool);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["threads"] = static_cast<double>(pool.size() + 1);
+    state.SetItemsProcessed(state.iterations() * contacts.size());
+}
+BENCHMARK(resolve_contacts_pool)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+#include "macros.hpp"
+#include "concurrent_queue.hpp"
+
+namespace {
+struct item {
+    int    value;
+    size_t producer;
+};
+} //namespace
+
+//==============================================================================
+//! Every benchmark thread produces and consumes an item per iteration, so the
+//! queue stays short (see the debug check in push) while the lock is contended
+//! by 1..N threads.
+//==============================================================================
+void concurrent_queue_push_pop(benchmark::State& state) {
+    static bklib::concurrent_queue<item> queue;
+
+    auto const producer = static_cast<size_t>(state.thread_index());
+
+    int i = 0;
+    for (auto _ : state) {
+        queue.push(item {i++, producer});
+        benchmark::DoNotOptimize(queue.pop());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(concurrent_queue_push_pop)->ThreadRange(1, 8)->UseRealTime();
+
+//==============================================================================
+//! Push a burst of items then drain it, uncontended.
+//==============================================================================
+void concurrent_queue_burst(benchmark::State& state) {
+    bklib::concurrent_queue<item> queue;
+
+    auto const n = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        for (int i = 0; i < n; ++i) {
+            queue.push(item {i, 0});
+        }
+
+        for (int i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(queue.pop());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(concurrent_queue_burst)->RangeMultiplier(4)->Range(1, 128);
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include "json.hpp"
+
+#include <string>
+
+namespace json = bklib::json;
+
+namespace {
+//! {"items": [{"id": 0, "name": "item 0", "tags": ["a", "b"]}, ...]}
+bklib::utf8string make_items(int const n) {
+    bklib::utf8string result = "{\"items\": [";
+
+    for (int i = 0; i < n; ++i) {
+        if (i) {
+            result += ", ";
+        }
+
+        auto const id = std::to_string(i);
+        result += "{\"id\": " + id + ", \"name\": \"item " + id + "\", \"tags\": [\"a\", \"b\"]}";
+    }
+
+    result += "]}";
+
+    return result;
+}
+} //namespace
+
+//==============================================================================
+//! Walk every item as a loader would.
+//==============================================================================
+void json_require_walk(benchmark::State& state) {
+    auto const n      = static_cast<int>(state.range(0));
+    auto const source = make_items(n);
+    auto const doc    = json::parse(source);
+
+    for (auto _ : state) {
+        auto const items = json::require_array(json::require_key(doc.root(), "items"));
+
+        for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+            auto const item = json::require_key(items, i);
+
+            benchmark::DoNotOptimize(json::require_int(json::require_key(item, "id")));
+            benchmark::DoNotOptimize(json::require_string_ref(json::require_key(item, "name")));
+            benchmark::DoNotOptimize(json::require_size(json::require_key(item, "tags"), 2));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(json_require_walk)->RangeMultiplier(8)->Range(8, 4096);
+
+//==============================================================================
+//! Look a key up in an object with @c n keys.
+//==============================================================================
+void json_require_key(benchmark::State& state) {
+    auto const n = static_cast<int>(state.range(0));
+
+    bklib::utf8string source = "{";
+    for (int i = 0; i < n; ++i) {
+        source += (i ? ", \"key" : "\"key") + std::to_string(i) + "\": " + std::to_string(i);
+    }
+    source += "}";
+
+    auto const doc  = json::parse(source);
+    auto const last = "key" + std::to_string(n - 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::require_int(json::require_key(doc.root(), last)));
+    }
+}
+BENCHMARK(json_require_key)->RangeMultiplier(4)->Range(1, 256);
+
+//==============================================================================
+//! The cost of a failed lookup, including building the exception.
+//==============================================================================
+void json_require_key_missing(benchmark::State& state) {
+    auto const source = make_items(1);
+    auto const doc    = json::parse(source);
+
+    for (auto _ : state) {
+        try {
+            json::require_key(doc.root(), "missing");
+        } catch (json::error::bad_index const&) {
+            benchmark::ClobberMemory();
+        }
+    }
+}
+BENCHMARK(json_require_key_missing);
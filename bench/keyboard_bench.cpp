@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include "keyboard.hpp"
+
+#include <vector>
+
+using bklib::keycode;
+using bklib::key_combo;
+using bklib::keyboard;
+
+namespace {
+//! Keys that have names; @see keyboard::translate.
+std::vector<keycode> const& named_keys() {
+    static std::vector<keycode> const result = [] {
+        std::vector<keycode> keys;
+
+        for (size_t i = 0; i < keyboard::KEY_COUNT; ++i) {
+            auto const k = static_cast<keycode>(i);
+            if (!keyboard::translate(k).empty()) {
+                keys.push_back(k);
+            }
+        }
+
+        return keys;
+    }();
+
+    return result;
+}
+} //namespace
+
+//==============================================================================
+// key_combo::includes
+//==============================================================================
+void key_combo_includes_combo(benchmark::State& state) {
+    key_combo const held  {keycode::CTRL_L, keycode::SHIFT_L, keycode::A, keycode::S, keycode::LEFT};
+    key_combo const combo {keycode::CTRL_L, keycode::S};
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(held.includes(combo));
+    }
+}
+BENCHMARK(key_combo_includes_combo);
+
+void key_combo_includes_key(benchmark::State& state) {
+    key_combo const held {keycode::CTRL_L, keycode::SHIFT_L, keycode::A, keycode::S, keycode::LEFT};
+
+    auto k = keycode::A;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(held.includes(k));
+        k = (k == keycode::A) ? keycode::Z : keycode::A;
+    }
+}
+BENCHMARK(key_combo_includes_key);
+
+//==============================================================================
+// keyboard::translate
+//==============================================================================
+void keyboard_translate_key(benchmark::State& state) {
+    auto const& keys = named_keys();
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(keyboard::translate(keys[i]));
+        i = (i + 1) % keys.size();
+    }
+}
+BENCHMARK(keyboard_translate_key);
+
+void keyboard_translate_name(benchmark::State& state) {
+    std::vector<bklib::string_ref> names;
+    for (auto const k : named_keys()) {
+        names.push_back(keyboard::translate(k));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(keyboard::translate(names[i]));
+        i = (i + 1) % names.size();
+    }
+}
+BENCHMARK(keyboard_translate_name);
@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+#include "math_batch.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+using bklib::simd_level;
+
+size_t const COUNT = 4096;
+
+struct random_vectors {
+    random_vectors() {
+        std::mt19937 rng {42};
+        std::uniform_real_distribution<float> value {-1000.0f, 1000.0f};
+
+        for (size_t i = 0; i < COUNT; ++i) {
+            auto const v = bklib::vector2d<float> {value(rng), value(rng)};
+            aos.push_back(v);
+            points.push_back({v.x, v.y});
+            x.push_back(v.x);
+            y.push_back(v.y);
+        }
+    }
+
+    std::vector<bklib::vector2d<float>> aos;
+    std::vector<bklib::point2d<float>>  points;
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+random_vectors const& vectors() {
+    static random_vectors const result;
+    return result;
+}
+
+//! Run at the level given by the first argument; skipped if unsupported.
+template <typename F>
+void at_level(benchmark::State& state, F f) {
+    auto const level = static_cast<simd_level>(state.range(0));
+    if (bklib::set_simd_level(level) != level) {
+        state.SkipWithError("not supported");
+        return;
+    }
+
+    for (auto _ : state) {
+        f();
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * COUNT);
+    bklib::set_simd_level(bklib::detected_simd_level());
+}
+
+void levels(benchmark::internal::Benchmark* b) {
+    b->ArgName("level")->DenseRange(0, static_cast<int>(simd_level::avx512));
+}
+
+bklib::transform2d const TRANSFORM = [] {
+    bklib::transform2d m;
+    m.a = 0.8f; m.b = 0.6f; m.c = -0.6f; m.d = 0.8f; m.tx = 10.0f; m.ty = 20.0f;
+    return m;
+}();
+} //namespace
+
+//==============================================================================
+// The scalar loops the batch functions replace, for comparison.
+//==============================================================================
+void transform_points_loop(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<bklib::point2d<float>> out(COUNT);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            out[i] = bklib::transform(TRANSFORM, v.points[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(transform_points_loop);
+
+void directions_loop(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<bklib::vector2d<float>> out(COUNT);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            out[i] = bklib::direction<float>(v.aos[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(directions_loop);
+
+void separation_vectors_loop(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<bklib::vector2d<float>> out(COUNT);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < COUNT; ++i) {
+            auto const j = (i + 1) % COUNT;
+            out[i] = bklib::separation_vector(
+                bklib::circle<float> {v.points[i], v.y[j]}
+              , bklib::circle<float> {v.points[j], v.x[i]}
+            );
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(separation_vectors_loop);
+
+//==============================================================================
+// Batch functions at each level.
+//==============================================================================
+void transform_points_aos(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<bklib::point2d<float>> out(COUNT);
+
+    at_level(state, [&] {
+        bklib::transform_points(v.points.data(), COUNT, TRANSFORM, out.data());
+    });
+}
+BENCHMARK(transform_points_aos)->Apply(levels);
+
+void transform_points_soa(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<float> x(COUNT), y(COUNT);
+
+    at_level(state, [&] {
+        bklib::transform_points(v.x.data(), v.y.data(), COUNT, TRANSFORM, x.data(), y.data());
+    });
+}
+BENCHMARK(transform_points_soa)->Apply(levels);
+
+void magnitudes_aos(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<float> out(COUNT);
+
+    at_level(state, [&] {
+        bklib::magnitudes(v.aos.data(), COUNT, out.data());
+    });
+}
+BENCHMARK(magnitudes_aos)->Apply(levels);
+
+void magnitudes_soa(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<float> out(COUNT);
+
+    at_level(state, [&] {
+        bklib::magnitudes(v.x.data(), v.y.data(), COUNT, out.data());
+    });
+}
+BENCHMARK(magnitudes_soa)->Apply(levels);
+
+void directions_aos(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<bklib::vector2d<float>> out(COUNT);
+
+    at_level(state, [&] {
+        bklib::directions(v.aos.data(), COUNT, out.data());
+    });
+}
+BENCHMARK(directions_aos)->Apply(levels);
+
+void directions_soa(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<float> x(COUNT), y(COUNT);
+
+    at_level(state, [&] {
+        bklib::directions(v.x.data(), v.y.data(), COUNT, x.data(), y.data());
+    });
+}
+BENCHMARK(directions_soa)->Apply(levels);
+
+void separation_vectors_soa(benchmark::State& state) {
+    auto const& v = vectors();
+    std::vector<float> x(COUNT), y(COUNT);
+
+    // the circles {(x[i], y[i]), y[j]} and {(x[j], y[j]), x[i]}, j = i + 1.
+    std::vector<float> bx (v.x.begin() + 1, v.x.end());
+    std::vector<float> by (v.y.begin() + 1, v.y.end());
+    bx.push_back(v.x.front());
+    by.push_back(v.y.front());
+
+    at_level(state, [&] {
+        bklib::separation_vectors(
+            v.x.data(), v.y.data(), by.data(), bx.data(), by.data(), v.x.data(), COUNT, x.data(), y.data()
+        );
+    });
+}
+BENCHMARK(separation_vectors_soa)->Apply(levels);
@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include "math.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+//! Enough shapes that the loop does not fit in a branch predictor's history.
+size_t const SHAPES = 1024;
+
+template <typename T>
+T random_value(std::mt19937& rng, T const lo, T const hi, std::true_type) {
+    return std::uniform_int_distribution<T>{lo, hi}(rng);
+}
+
+template <typename T>
+T random_value(std::mt19937& rng, T const lo, T const hi, std::false_type) {
+    return std::uniform_real_distribution<T>{lo, hi}(rng);
+}
+
+template <typename T>
+T random_value(std::mt19937& rng, T const lo, T const hi) {
+    return random_value(rng, lo, hi, std::is_integral<T>{});
+}
+
+template <typename T>
+struct random_shapes {
+    using point = bklib::point2d<T>;
+    using rect  = bklib::axis_aligned_rect<T>;
+    using circ  = bklib::circle<T>;
+
+    random_shapes() {
+        std::mt19937 rng {42};
+
+        auto const coord = [&] { return random_value<T>(rng, T{0}, T{100}); };
+        auto const size  = [&] { return random_value<T>(rng, T{1}, T{20}); };
+
+        for (size_t i = 0; i < SHAPES; ++i) {
+            auto const x = coord();
+            auto const y = coord();
+
+            points.push_back(point {coord(), coord()});
+            rects.push_back(rect {x, y, static_cast<T>(x + size()), static_cast<T>(y + size())});
+            circles.push_back(circ {point {coord(), coord()}, size()});
+        }
+    }
+
+    std::vector<point> points;
+    std::vector<rect>  rects;
+    std::vector<circ>  circles;
+};
+
+template <typename T>
+random_shapes<T> const& shapes() {
+    static random_shapes<T> const result;
+    return result;
+}
+
+//! Run @c f over successive pairs of shapes from @c as and @c bs.
+template <typename A, typename B, typename F>
+void pairwise(benchmark::State& state, A const& as, B const& bs, F f) {
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(f(as[i], bs[(i + 1) % SHAPES]));
+        i = (i + 1) % SHAPES;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+} //namespace
+
+//==============================================================================
+// intersects
+//==============================================================================
+template <typename T>
+void intersects_rect_point(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.rects, s.points, [](auto const& a, auto const& b) {
+        return bklib::intersects(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(intersects_rect_point, int16_t);
+BENCHMARK_TEMPLATE(intersects_rect_point, int);
+BENCHMARK_TEMPLATE(intersects_rect_point, float);
+
+template <typename T>
+void intersects_rect_rect(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.rects, s.rects, [](auto const& a, auto const& b) {
+        return bklib::intersects(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(intersects_rect_rect, int16_t);
+BENCHMARK_TEMPLATE(intersects_rect_rect, int);
+BENCHMARK_TEMPLATE(intersects_rect_rect, float);
+
+template <typename T>
+void intersects_circle_point(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.circles, s.points, [](auto const& a, auto const& b) {
+        return bklib::intersects(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(intersects_circle_point, int16_t);
+BENCHMARK_TEMPLATE(intersects_circle_point, int);
+BENCHMARK_TEMPLATE(intersects_circle_point, float);
+
+template <typename T>
+void intersects_circle_circle(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.circles, s.circles, [](auto const& a, auto const& b) {
+        return bklib::intersects(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(intersects_circle_circle, int16_t);
+BENCHMARK_TEMPLATE(intersects_circle_circle, int);
+BENCHMARK_TEMPLATE(intersects_circle_circle, float);
+
+template <typename T>
+void intersects_rect_circle(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.rects, s.circles, [](auto const& a, auto const& b) {
+        return bklib::intersects(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(intersects_rect_circle, int16_t);
+BENCHMARK_TEMPLATE(intersects_rect_circle, int);
+BENCHMARK_TEMPLATE(intersects_rect_circle, float);
+
+//==============================================================================
+// distance
+//==============================================================================
+template <typename T>
+void distance_point_point(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.points, s.points, [](auto const& a, auto const& b) {
+        return bklib::distance(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(distance_point_point, int);
+BENCHMARK_TEMPLATE(distance_point_point, float);
+
+template <typename T>
+void distance2_point_point(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.points, s.points, [](auto const& a, auto const& b) {
+        return bklib::distance2(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(distance2_point_point, int);
+BENCHMARK_TEMPLATE(distance2_point_point, float);
+
+template <typename T>
+void distance_circle_circle(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.circles, s.circles, [](auto const& a, auto const& b) {
+        return bklib::distance(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(distance_circle_circle, int);
+BENCHMARK_TEMPLATE(distance_circle_circle, float);
+
+template <typename T>
+void distance2_rect_rect(benchmark::State& state) {
+    auto const& s = shapes<T>();
+    pairwise(state, s.rects, s.rects, [](auto const& a, auto const& b) {
+        return bklib::distance2(a, b);
+    });
+}
+BENCHMARK_TEMPLATE(distance2_rect_rect, int16_t);
+BENCHMARK_TEMPLATE(distance2_rect_rect, int);
+BENCHMARK_TEMPLATE(distance2_rect_rect, float);
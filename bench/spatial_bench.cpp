@@ -0,0 +1,238 @@
+#include <benchmark/benchmark.h>
+#include "spatial_grid.hpp"
+#include "aabb_tree.hpp"
+#include "sweep_and_prune.hpp"
+
+#include <random>
+#include <vector>
+
+namespace {
+//==============================================================================
+//! Objects of uniform density moving in straight lines, bouncing off the
+//! edges of the world.
+//==============================================================================
+struct moving_world {
+    using rect = bklib::axis_aligned_rect<int>;
+
+    static int const SIZE = 8192;
+
+    explicit moving_world(size_t const n) {
+        std::mt19937 rng {42};
+        std::uniform_int_distribution<int> coord {0, SIZE - 16};
+        std::uniform_int_distribution<int> size  {4, 16};
+        std::uniform_int_distribution<int> speed {-2, 2};
+
+        for (size_t i = 0; i < n; ++i) {
+            auto const x = coord(rng);
+            auto const y = coord(rng);
+            bounds.push_back(rect {x, y, x + size(rng), y + size(rng)});
+            velocity.push_back({speed(rng), speed(rng)});
+        }
+    }
+
+    void step() {
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            auto& r = bounds[i];
+            auto& v = velocity[i];
+
+            if (r.left() + v.x < 0 || r.right()  + v.x > SIZE) { v.x = -v.x; }
+            if (r.top()  + v.y < 0 || r.bottom() + v.y > SIZE) { v.y = -v.y; }
+
+            r.translate(v.x, v.y);
+        }
+    }
+
+    static rect world() { return rect {0, 0, SIZE, SIZE}; }
+
+    std::vector<rect>                    bounds;
+    std::vector<bklib::vector2d<int>>    velocity;
+};
+
+//! The bounds of an object in the coordinates of Index.
+template <typename Index>
+typename Index::rect bounds_for(moving_world::rect const r) {
+    using rect  = typename Index::rect;
+    using coord = decltype(std::declval<rect>().left());
+
+    return rect {typename rect::allow_malformed {}
+      , static_cast<coord>(r.left()),  static_cast<coord>(r.top())
+      , static_cast<coord>(r.right()), static_cast<coord>(r.bottom())
+    };
+}
+
+//! Insert every object of @c world into @c index, with its position as value.
+template <typename Index>
+std::vector<bklib::spatial_handle> insert_all(Index& index, moving_world const& world) {
+    std::vector<bklib::spatial_handle> result;
+    for (size_t i = 0; i < world.bounds.size(); ++i) {
+        result.push_back(index.insert(bounds_for<Index>(world.bounds[i]), static_cast<uint32_t>(i)));
+    }
+
+    return result;
+}
+
+//! One frame: move everything, update the index and find every pair.
+template <typename Index>
+void moving_frames(benchmark::State& state, Index& index) {
+    moving_world world {static_cast<size_t>(state.range(0))};
+    auto const handles = insert_all(index, world);
+
+    size_t pairs = 0;
+    for (auto _ : state) {
+        world.step();
+        for (size_t i = 0; i < handles.size(); ++i) {
+            index.update(handles[i], bounds_for<Index>(world.bounds[i]));
+        }
+
+        pairs = 0;
+        index.for_each_pair([&](uint32_t, uint32_t) { ++pairs; });
+        benchmark::DoNotOptimize(pairs);
+    }
+
+    state.counters["pairs"] = static_cast<double>(pairs);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} //namespace
+
+//==============================================================================
+// spatial_grid
+//==============================================================================
+void spatial_grid_frame(benchmark::State& state) {
+    bklib::spatial_grid<uint32_t> grid {moving_world::world(), 32};
+    moving_frames(state, grid);
+}
+BENCHMARK(spatial_grid_frame)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+void spatial_grid_rebuild(benchmark::State& state) {
+    bklib::spatial_grid<uint32_t> grid {moving_world::world(), 32};
+    moving_world world {static_cast<size_t>(state.range(0))};
+    auto const handles = insert_all(grid, world);
+
+    for (auto _ : state) {
+        // a move across cells forces the rebuild.
+        grid.update(handles[0], moving_world::rect {1000, 1000, 1001, 1001});
+        grid.update(handles[0], world.bounds[0]);
+        grid.rebuild();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(spatial_grid_rebuild)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+void spatial_grid_query(benchmark::State& state) {
+    bklib::spatial_grid<uint32_t> grid {moving_world::world(), 32};
+    moving_world world {200000};
+    insert_all(grid, world);
+
+    std::mt19937 rng {1};
+    std::uniform_int_distribution<int> coord {0, moving_world::SIZE - 64};
+
+    for (auto _ : state) {
+        auto const x = coord(rng);
+        auto const y = coord(rng);
+
+        size_t n = 0;
+        grid.query(moving_world::rect {x, y, x + 64, y + 64}, [&](uint32_t) { ++n; });
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(spatial_grid_query);
+
+//==============================================================================
+// aabb_tree
+//==============================================================================
+void aabb_tree_frame(benchmark::State& state) {
+    bklib::aabb_tree<uint32_t> tree {4.0f};
+    moving_frames(state, tree);
+}
+BENCHMARK(aabb_tree_frame)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+//! The pair pass alone, on the shared pool.
+void aabb_tree_find_pairs(benchmark::State& state) {
+    bklib::aabb_tree<uint32_t> tree {4.0f};
+    moving_world world {static_cast<size_t>(state.range(0))};
+    insert_all(tree, world);
+
+    auto& pool = bklib::task_pool::shared();
+
+    for (auto _ : state) {
+        auto const pairs = tree.find_pairs(pool);
+        benchmark::DoNotOptimize(pairs.data());
+    }
+
+    state.counters["threads"] = static_cast<double>(pool.size() + 1);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(aabb_tree_find_pairs)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+void aabb_tree_query(benchmark::State& state) {
+    bklib::aabb_tree<uint32_t> tree {4.0f};
+    moving_world world {200000};
+    insert_all(tree, world);
+
+    std::mt19937 rng {1};
+    std::uniform_real_distribution<float> coord {0, moving_world::SIZE - 64};
+
+    for (auto _ : state) {
+        auto const x = coord(rng);
+        auto const y = coord(rng);
+
+        size_t n = 0;
+        tree.query(bklib::aabb_tree<uint32_t>::rect {x, y, x + 64, y + 64}, [&](uint32_t) { ++n; });
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(aabb_tree_query);
+
+//==============================================================================
+// sweep_and_prune
+//==============================================================================
+void sweep_and_prune_frame(benchmark::State& state) {
+    bklib::sweep_and_prune<uint32_t, int> sap;
+    moving_frames(state, sap);
+}
+BENCHMARK(sweep_and_prune_frame)->Arg(10000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+void sweep_and_prune_query(benchmark::State& state) {
+    bklib::sweep_and_prune<uint32_t, int> sap;
+    moving_world world {200000};
+    insert_all(sap, world);
+
+    std::mt19937 rng {1};
+    std::uniform_int_distribution<int> coord {0, moving_world::SIZE - 64};
+
+    for (auto _ : state) {
+        auto const x = coord(rng);
+        auto const y = coord(rng);
+
+        size_t n = 0;
+        sap.query(moving_world::rect {x, y, x + 64, y + 64}, [&](uint32_t) { ++n; });
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(sweep_and_prune_query);
+
+//==============================================================================
+// Every pair against every other, as the baseline.
+//==============================================================================
+void brute_force_frame(benchmark::State& state) {
+    moving_world world {static_cast<size_t>(state.range(0))};
+    auto const& bounds = world.bounds;
+
+    size_t pairs = 0;
+    for (auto _ : state) {
+        world.step();
+
+        pairs = 0;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            for (size_t j = i + 1; j < bounds.size(); ++j) {
+                pairs += intersects(bounds[i], bounds[j]) ? 1 : 0;
+            }
+        }
+        benchmark::DoNotOptimize(pairs);
+    }
+
+    state.counters["pairs"] = static_cast<double>(pairs);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(brute_force_frame)->Arg(10000)->Unit(benchmark::kMicrosecond);
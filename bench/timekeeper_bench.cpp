@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "timekeeper.hpp"
+
+namespace {
+//! Register @c n callbacks every @c period, each counting into @c calls.
+void fill(
+    bklib::timekeeper&             tk
+  , int64_t                  const n
+  , bklib::timekeeper::duration const period
+  , size_t&                        calls
+) {
+    for (int64_t i = 0; i < n; ++i) {
+        tk.register_event(period, [&calls](bklib::timekeeper::delta) { ++calls; });
+    }
+}
+} //namespace
+
+//==============================================================================
+//! No callback is due: the cost of checking the earliest deadline.
+//==============================================================================
+void timekeeper_update_idle(benchmark::State& state) {
+    bklib::timekeeper tk;
+    size_t calls = 0;
+
+    fill(tk, state.range(0), std::chrono::hours {1}, calls);
+
+    for (auto _ : state) {
+        tk.update();
+    }
+
+    benchmark::DoNotOptimize(calls);
+}
+BENCHMARK(timekeeper_update_idle)->RangeMultiplier(8)->Range(1, 4096);
+
+//==============================================================================
+//! Every callback is due on every update: the cost per callback of the heap.
+//==============================================================================
+void timekeeper_update_due(benchmark::State& state) {
+    bklib::timekeeper tk;
+    size_t calls = 0;
+
+    fill(tk, state.range(0), std::chrono::nanoseconds {1}, calls);
+
+    for (auto _ : state) {
+        tk.update();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(calls));
+}
+BENCHMARK(timekeeper_update_due)->RangeMultiplier(8)->Range(1, 4096);
@@ -0,0 +1,167 @@
+//==============================================================================
+//! Little-endian binary encoding primitives.
+//!
+//! Scalars are written as fixed width little-endian values whatever the host;
+//! unsigned varints use 7 bits per byte (LEB128) and signed varints are zigzag
+//! encoded first, so that small magnitudes of either sign are short.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "exception.hpp"
+
+namespace bklib {
+namespace binary {
+//==============================================================================
+namespace error {
+    struct base      : virtual bklib::exception_base {};
+    //! The input ended, or a varint was too long.
+    struct bad_input : virtual base {};
+
+    BK_DEFINE_EXCEPTION_INFO(info_offset, size_t);
+    BK_DEFINE_EXCEPTION_INFO(info_reason, bklib::string_ref);
+} //namespace error
+
+//! Whether the host stores scalars in the encoded (little-endian) order.
+static BK_CONSTEXPR bool const HOST_IS_LITTLE_ENDIAN =
+#if BOOST_ENDIAN_LITTLE_BYTE
+    true;
+#else
+    false;
+#endif
+
+//! The longest encoding of a 64 bit varint.
+static BK_CONSTEXPR size_t const MAX_VARINT_SIZE = 10;
+
+//==============================================================================
+//! The unsigned integer type with the representation of a scalar @c T.
+//==============================================================================
+template <typename T>
+using scalar_bits_t = std::conditional_t<sizeof(T) == 1, uint8_t
+                    , std::conditional_t<sizeof(T) == 2, uint16_t
+                    , std::conditional_t<sizeof(T) == 4, uint32_t
+                    , uint64_t>>>;
+
+inline uint64_t zigzag(int64_t const n) BK_NOEXCEPT {
+    return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+}
+
+inline int64_t unzigzag(uint64_t const n) BK_NOEXCEPT {
+    return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+}
+
+//==============================================================================
+//! Appends encoded values to a byte vector.
+//==============================================================================
+class writer {
+public:
+    explicit writer(std::vector<char>& out) BK_NOEXCEPT : out_ (out) {}
+
+    void write_bytes(void const* const data, size_t const size) {
+        auto const p = static_cast<char const*>(data);
+        out_.insert(out_.end(), p, p + size);
+    }
+
+    //! A fixed width little-endian arithmetic value.
+    template <typename T>
+    void write(T const value) {
+        static_assert(std::is_arithmetic<T>::value, "scalars only");
+
+        scalar_bits_t<T> bits;
+        std::memcpy(&bits, &value, sizeof(T));
+
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = static_cast<char>(bits >> (i * 8));
+        }
+
+        write_bytes(bytes, sizeof(T));
+    }
+
+    void write_varint(uint64_t value);
+
+    void write_svarint(int64_t const value) {
+        write_varint(zigzag(value));
+    }
+
+    //! Make room for @c size more bytes.
+    void reserve(size_t const size) {
+        out_.reserve(out_.size() + size);
+    }
+
+    size_t size() const BK_NOEXCEPT { return out_.size(); }
+private:
+    std::vector<char>& out_;
+};
+
+//==============================================================================
+//! Decodes values from a (non-owning) buffer, such as a memory mapped file.
+//!
+//! @throws binary::error::bad_input if the buffer is too short or malformed.
+//==============================================================================
+class reader {
+public:
+    explicit reader(string_ref const data) BK_NOEXCEPT
+      : first_ {data.data()}
+      , pos_   {data.data()}
+      , last_  {data.data() + data.size()}
+    {
+    }
+
+    //! A view of the next @c size bytes.
+    char const* read_bytes(size_t const size) {
+        if (remaining() < size) {
+            fail_("unexpected end of input");
+        }
+
+        auto const result = pos_;
+        pos_ += size;
+        return result;
+    }
+
+    void read_bytes(void* const out, size_t const size) {
+        std::memcpy(out, read_bytes(size), size);
+    }
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_arithmetic<T>::value, "scalars only");
+
+        auto const bytes = reinterpret_cast<unsigned char const*>(read_bytes(sizeof(T)));
+
+        scalar_bits_t<T> bits {0};
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bits |= static_cast<scalar_bits_t<T>>(static_cast<scalar_bits_t<T>>(bytes[i]) << (i * 8));
+        }
+
+        T result;
+        std::memcpy(&result, &bits, sizeof(T));
+        return result;
+    }
+
+    uint64_t read_varint();
+
+    int64_t read_svarint() {
+        return unzigzag(read_varint());
+    }
+
+    size_t remaining() const BK_NOEXCEPT { return static_cast<size_t>(last_ - pos_); }
+    size_t offset()    const BK_NOEXCEPT { return static_cast<size_t>(pos_ - first_); }
+    char const* position() const BK_NOEXCEPT { return pos_; }
+private:
+    //! Always throws.
+    void fail_(char const* reason) const;
+
+    char const* first_;
+    char const* pos_;
+    char const* last_;
+};
+
+} //namespace binary
+} //namespace bklib
@@ -0,0 +1,106 @@
+//==============================================================================
+//! Batched collision resolution of circles.
+//!
+//! Circles are kept as a structure of arrays. Candidate pairs from any
+//! broadphase (spatial_grid, aabb_tree, sweep_and_prune, ...) are narrowed to
+//! contacts: the pairs that intersect, each with its separation vector. The
+//! contacts then push their circles apart.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "math.hpp"
+
+namespace bklib {
+
+class task_pool;
+
+//==============================================================================
+//! The indices {a, b} of two circles.
+//==============================================================================
+using circle_pair = std::pair<uint32_t, uint32_t>;
+
+//==============================================================================
+//! Circles as a structure of arrays.
+//==============================================================================
+struct circle_array {
+    size_t size()  const BK_NOEXCEPT { return r.size(); }
+    bool   empty() const BK_NOEXCEPT { return r.empty(); }
+
+    circle<float> operator[](size_t const i) const BK_NOEXCEPT {
+        return {{x[i], y[i]}, r[i]};
+    }
+
+    void push_back(circle<float> const c) {
+        x.push_back(c.p.x);
+        y.push_back(c.p.y);
+        r.push_back(c.r);
+    }
+
+    void clear() BK_NOEXCEPT {
+        x.clear();
+        y.clear();
+        r.clear();
+    }
+
+    std::vector<float> x; //!< Centers.
+    std::vector<float> y;
+    std::vector<float> r; //!< Radii.
+};
+//==============================================================================
+//! Intersecting pairs of circles, each with separation_vector(a, b): the
+//! displacement of a that would leave it just touching b.
+//==============================================================================
+struct circle_contacts {
+    size_t size()  const BK_NOEXCEPT { return pairs.size(); }
+    bool   empty() const BK_NOEXCEPT { return pairs.empty(); }
+
+    void clear() BK_NOEXCEPT {
+        pairs.clear();
+        x.clear();
+        y.clear();
+    }
+
+    std::vector<circle_pair> pairs;
+    std::vector<float>       x;     //!< The separation vectors.
+    std::vector<float>       y;
+};
+
+//==============================================================================
+//! Replace @c out with the contacts among @c candidates, in the same order.
+//!
+//! @param candidates Pairs of indices into @c circles, each at most once: say
+//!        the values of a spatial index holding circle i as the value i.
+//!
+//! Candidates are first tested with intersects(), which takes no square root;
+//! the separation vectors of those that remain are computed in batches with
+//! separation_vectors(), at one square root each.
+//==============================================================================
+void find_contacts(
+    circle_array const& circles
+  , circle_pair const* candidates, size_t n
+  , circle_contacts& out
+);
+//==============================================================================
+//! Push the circles of each contact apart: a by half its separation vector,
+//! and b by minus that.
+//!
+//! The corrections of all contacts add up, each as computed by find_contacts()
+//! (as in a Jacobi iteration). A circle with several contacts may thus be
+//! moved too far or not far enough; repeating find_contacts() and
+//! resolve_contacts() converges.
+//==============================================================================
+void resolve_contacts(circle_array& circles, circle_contacts const& contacts) BK_NOEXCEPT;
+
+//! As above, in parallel on @c pool, without atomics: the contacts are first
+//! grouped by circle, and each circle then adds up its own corrections in the
+//! order of the contacts. The result is that of the serial form, bit for bit.
+void resolve_contacts(circle_array& circles, circle_contacts const& contacts, task_pool& pool);
+
+} //namespace bklib
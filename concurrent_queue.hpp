@@ -11,17 +11,23 @@ namespace bklib {
 template <typename T>
 class concurrent_queue {
 public:
-    void push(T&& e) {
+    //! @returns The number of elements queued, including @c e.
+    size_t push(T&& e) {
+        size_t size = 0;
+
         { //lock
             std::unique_lock<std::mutex> lock(mutex_);
             elements_.push(std::move(e));
+            size = elements_.size();
         } //unlock
 
-        if (elements_.size() > 200) {
+        if (size > 200) {
             BK_DEBUG_BREAK();
         }
 
         empty_condition_.notify_all();
+
+        return size;
     }
 
     T pop() {
@@ -2,14 +2,24 @@
 
 #include <boost/predef.h>
 
-#if defined(BOOST_COMP_MSVC)
-#   if BOOST_COMP_MSVC < BOOST_VERSION_NUMBER(12,0,21005)
-#       define BK_NOEXCEPT throw()
-#       define BK_NOEXCEPT_OP(x)
-#       define BK_CONSTEXPR
-#   else if BOOST_COMP_MSVC < BOOST_VERSION_NUMBER(13,0,0)
-#       define BK_NOEXCEPT noexcept
-#       define BK_NOEXCEPT_OP(x)
-#       define BK_CONSTEXPR constexpr
+#if BOOST_COMP_MSVC && BOOST_COMP_MSVC < BOOST_VERSION_NUMBER(12,0,21005)
+#   define BK_NOEXCEPT throw()
+#   define BK_NOEXCEPT_OP(x)
+#   define BK_CONSTEXPR
+#else
+#   define BK_NOEXCEPT noexcept
+#   define BK_NOEXCEPT_OP(x) noexcept(x)
+#   define BK_CONSTEXPR constexpr
+#endif
+
+//==============================================================================
+// Instruction set availability; define BK_NO_SIMD to force the scalar paths.
+//==============================================================================
+#if !defined(BK_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define BK_SIMD_SSE2
+#   endif
+#   if defined(__AVX2__)
+#       define BK_SIMD_AVX2
 #   endif
 #endif
@@ -0,0 +1,143 @@
+//==============================================================================
+//! Smoothing filters for noisy samples.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <cmath>
+#include <utility>
+#include <type_traits>
+
+#include "config.hpp"
+#include "assert.hpp"
+#include "math.hpp"
+
+namespace bklib {
+//==============================================================================
+namespace detail {
+    inline float filter_magnitude(float const x) BK_NOEXCEPT {
+        return std::abs(x);
+    }
+
+    template <typename T>
+    float filter_magnitude(vector2d<T> const v) BK_NOEXCEPT {
+        return magnitude<float>(v);
+    }
+} //namespace detail
+//==============================================================================
+//! The smoothing factor of a first order low pass filter with a @c cutoff
+//! frequency (Hz), for samples @c dt seconds apart.
+//==============================================================================
+inline float low_pass_alpha(float const cutoff, float const dt) BK_NOEXCEPT {
+    BK_ASSERT(cutoff > 0.0f && dt > 0.0f);
+
+    auto const tau = 1.0f / (2.0f * 3.14159265f * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+//==============================================================================
+//! Exponential moving average: value += alpha * (x - value).
+//!
+//! T may be a scalar, a vector2d or a point2d; the first sample is taken as is.
+//==============================================================================
+template <typename T>
+class ema_filter {
+public:
+    //! @pre 0 < alpha <= 1; larger values follow the samples more closely.
+    explicit ema_filter(float const alpha = 0.5f) BK_NOEXCEPT
+      : alpha_ {alpha}
+    {
+        BK_ASSERT(alpha > 0.0f && alpha <= 1.0f);
+    }
+
+    T operator()(T const x) BK_NOEXCEPT {
+        return update(x, alpha_);
+    }
+
+    //! Filter @c x with a one-off smoothing factor.
+    T update(T const x, float const alpha) BK_NOEXCEPT {
+        if (empty_) {
+            value_ = x;
+            empty_ = false;
+        } else {
+            value_ = value_ + (x - value_) * alpha;
+        }
+
+        return value_;
+    }
+
+    //! The filtered value; T{} before the first sample.
+    T     value() const BK_NOEXCEPT { return value_; }
+    bool  empty() const BK_NOEXCEPT { return empty_; }
+    float alpha() const BK_NOEXCEPT { return alpha_; }
+
+    void reset() BK_NOEXCEPT {
+        value_ = T {};
+        empty_ = true;
+    }
+private:
+    T     value_ = T {};
+    float alpha_;
+    bool  empty_ = true;
+};
+//==============================================================================
+//! The "1 euro" filter (Casiez et al., CHI 2012): a low pass filter whose
+//! cutoff rises with the speed of the signal, so that it removes jitter when
+//! the signal is slow and lags little when it is fast.
+//!
+//! T may be a scalar or a point2d / vector2d (speed is then the magnitude of
+//! the rate of change).
+//==============================================================================
+template <typename T>
+class one_euro_filter {
+public:
+    using derivative = std::decay_t<decltype(std::declval<T>() - std::declval<T>())>;
+
+    struct params {
+        float min_cutoff = 1.0f;  //!< Cutoff (Hz) at rest; lower is smoother.
+        float beta       = 0.01f; //!< Cutoff increase per unit of speed.
+        float d_cutoff   = 1.0f;  //!< Cutoff (Hz) for the speed estimate.
+    };
+
+    explicit one_euro_filter(params const p = params {}) BK_NOEXCEPT
+      : params_ (p)
+    {
+    }
+
+    //! Filter @c x, sampled @c dt seconds after the previous sample; samples
+    //! with dt <= 0 leave the filter unchanged.
+    T operator()(T const x, float const dt) BK_NOEXCEPT {
+        if (x_.empty()) {
+            return x_(x);
+        }
+
+        if (dt <= 0.0f) {
+            return x_.value();
+        }
+
+        auto const rate = (x - x_.value()) / dt;
+        auto const dx   = dx_.update(rate, low_pass_alpha(params_.d_cutoff, dt));
+
+        auto const cutoff = params_.min_cutoff
+          + params_.beta * detail::filter_magnitude(dx);
+
+        return x_.update(x, low_pass_alpha(cutoff, dt));
+    }
+
+    T          value() const BK_NOEXCEPT { return x_.value(); }
+    derivative rate()  const BK_NOEXCEPT { return dx_.value(); }
+    bool       empty() const BK_NOEXCEPT { return x_.empty(); }
+
+    params const& get_params() const BK_NOEXCEPT { return params_; }
+    void set_params(params const p) BK_NOEXCEPT { params_ = p; }
+
+    void reset() BK_NOEXCEPT {
+        x_.reset();
+        dx_.reset();
+    }
+private:
+    params                 params_;
+    ema_filter<T>          x_  {1.0f};
+    ema_filter<derivative> dx_ {1.0f};
+};
+
+} //namespace bklib
@@ -0,0 +1,96 @@
+//==============================================================================
+//! High dynamic range histograms.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+#include "util.hpp"
+
+namespace bklib {
+//==============================================================================
+//! The contents of a histogram at some point; @see hdr_histogram::snapshot.
+//==============================================================================
+class histogram_snapshot {
+public:
+    histogram_snapshot() = default;
+    histogram_snapshot(std::vector<uint64_t> counts, uint64_t sum);
+
+    uint64_t count() const BK_NOEXCEPT { return count_; }
+    bool     empty() const BK_NOEXCEPT { return count_ == 0; }
+
+    double mean() const BK_NOEXCEPT;
+
+    //! The smallest and largest values recorded, to within bucket precision.
+    uint64_t min() const BK_NOEXCEPT;
+    uint64_t max() const BK_NOEXCEPT;
+
+    //! The value below which @c p percent of values fall, to within bucket
+    //! precision (rounded up); 0 if empty.
+    uint64_t percentile(double p) const BK_NOEXCEPT;
+
+    //! Add the values of @c other.
+    histogram_snapshot& operator+=(histogram_snapshot const& other);
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t              count_ = 0;
+    uint64_t              sum_   = 0;
+};
+
+//==============================================================================
+//! A histogram of unsigned 64 bit values with a bounded relative error.
+//!
+//! Buckets are exact below 2^PRECISION_BITS; above, each power of two is split
+//! into 2^(PRECISION_BITS-1) buckets, so every value is counted to within
+//! about 3% whatever its magnitude (nanoseconds to hours, say).
+//!
+//! record() is a couple of relaxed atomic increments, so any number of threads
+//! can record without locks; snapshot() and snapshot_and_reset() may run
+//! concurrently with recording, and see each value either entirely or not at
+//! all (though not necessarily both its bucket and the sum at once).
+//==============================================================================
+class hdr_histogram {
+public:
+    static BK_CONSTEXPR unsigned const PRECISION_BITS = 6;
+    static BK_CONSTEXPR size_t   const SUB_BUCKETS    = size_t {1} << PRECISION_BITS;
+    static BK_CONSTEXPR size_t   const BUCKETS
+        = SUB_BUCKETS + (64 - PRECISION_BITS) * (SUB_BUCKETS / 2);
+
+    //! The bucket counting @c value.
+    static size_t bucket(uint64_t const value) BK_NOEXCEPT {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+
+        auto const shift    = highest_set_bit(value) - PRECISION_BITS + 1;
+        auto const mantissa = static_cast<size_t>(value >> shift); // [SUB/2, SUB)
+
+        return SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + (mantissa - SUB_BUCKETS / 2);
+    }
+
+    //! The smallest and largest values counted by bucket @c i.
+    static uint64_t bucket_min(size_t i) BK_NOEXCEPT;
+    static uint64_t bucket_max(size_t i) BK_NOEXCEPT;
+
+    hdr_histogram() BK_NOEXCEPT;
+    BK_DELETE_ALL(hdr_histogram);
+
+    void record(uint64_t const value) BK_NOEXCEPT {
+        counts_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    histogram_snapshot snapshot() const;
+    histogram_snapshot snapshot_and_reset();
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> counts_;
+    std::atomic<uint64_t>                      sum_;
+};
+
+} //namespace bklib
@@ -0,0 +1,49 @@
+#include "binary.hpp"
+
+namespace binary = bklib::binary;
+namespace error  = bklib::binary::error;
+
+using bklib::uint64_t;
+
+//==============================================================================
+void binary::writer::write_varint(uint64_t value) {
+    char bytes[MAX_VARINT_SIZE];
+    size_t size = 0;
+
+    while (value >= 0x80) {
+        bytes[size++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+
+    bytes[size++] = static_cast<char>(value);
+
+    write_bytes(bytes, size);
+}
+//==============================================================================
+uint64_t binary::reader::read_varint() {
+    uint64_t result = 0;
+
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos_ == last_) {
+            fail_("unexpected end of input");
+        }
+
+        auto const byte = static_cast<unsigned char>(*pos_++);
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            return result;
+        }
+    }
+
+    fail_("varint too long");
+    return result;
+}
+//==============================================================================
+void binary::reader::fail_(char const* const reason) const {
+    BOOST_THROW_EXCEPTION(error::bad_input{}
+      << error::info_offset{offset()}
+      << error::info_reason{reason}
+    );
+}
+//==============================================================================
@@ -0,0 +1,121 @@
+#include "circle_collision.hpp"
+#include "assert.hpp"
+#include "math_batch.hpp"
+#include "task_pool.hpp"
+
+#include <algorithm>
+
+using bklib::circle_array;
+using bklib::circle_contacts;
+using bklib::circle_pair;
+
+namespace {
+//! Candidates gathered for each call of separation_vectors.
+size_t const BATCH = 256;
+
+//! Circles each task of the parallel resolve_contacts adds up, at least.
+size_t const GRAIN = 1024;
+} //namespace
+
+//==============================================================================
+void bklib::find_contacts(
+    circle_array const& circles
+  , circle_pair const* const candidates, size_t const n
+  , circle_contacts& out
+) {
+    out.clear();
+
+    float ax[BATCH], ay[BATCH], ar[BATCH];
+    float bx[BATCH], by[BATCH], br[BATCH];
+    circle_pair pairs[BATCH];
+
+    for (size_t first = 0; first < n; first += BATCH) {
+        auto const last = std::min(n, first + BATCH);
+
+        // every candidate is written, and kept by advancing past it: whether
+        // a pair intersects is as good as random, and would be mispredicted.
+        size_t m = 0;
+        for (size_t i = first; i < last; ++i) {
+            auto const p = candidates[i];
+            BK_ASSERT(p.first < circles.size() && p.second < circles.size());
+
+            auto const a = circles[p.first];
+            auto const b = circles[p.second];
+
+            pairs[m] = p;
+            ax[m] = a.p.x; ay[m] = a.p.y; ar[m] = a.r;
+            bx[m] = b.p.x; by[m] = b.p.y; br[m] = b.r;
+            m += intersects(a, b) ? 1 : 0;
+        }
+
+        out.pairs.insert(out.pairs.end(), pairs, pairs + m);
+
+        auto const size = out.x.size();
+        out.x.resize(size + m);
+        out.y.resize(size + m);
+
+        separation_vectors(ax, ay, ar, bx, by, br, m, out.x.data() + size, out.y.data() + size);
+    }
+}
+//==============================================================================
+void bklib::resolve_contacts(circle_array& circles, circle_contacts const& contacts) BK_NOEXCEPT {
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        auto const a  = contacts.pairs[i].first;
+        auto const b  = contacts.pairs[i].second;
+        auto const dx = 0.5f * contacts.x[i];
+        auto const dy = 0.5f * contacts.y[i];
+
+        circles.x[a] += dx;
+        circles.y[a] += dy;
+        circles.x[b] -= dx;
+        circles.y[b] -= dy;
+    }
+}
+//==============================================================================
+void bklib::resolve_contacts(circle_array& circles, circle_contacts const& contacts, task_pool& pool) {
+    auto const n = circles.size();
+
+    // the contacts of circle i are entries [first[i], first[i + 1]), each the
+    // index of the contact times two, plus one where the circle is b.
+    std::vector<uint32_t> first (n + 1, 0);
+    for (auto const& p : contacts.pairs) {
+        ++first[p.first + 1];
+        ++first[p.second + 1];
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        first[i + 1] += first[i];
+    }
+
+    std::vector<uint32_t> entries (first[n]);
+    {
+        auto next = first;
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            auto const c = static_cast<uint32_t>(i);
+            entries[next[contacts.pairs[i].first]++]  = (c << 1);
+            entries[next[contacts.pairs[i].second]++] = (c << 1) | 1u;
+        }
+    }
+
+    pool.parallel_for(0, n, [&](size_t const i) {
+        auto x = circles.x[i];
+        auto y = circles.y[i];
+
+        for (auto k = first[i]; k < first[i + 1]; ++k) {
+            auto const c  = entries[k] >> 1;
+            auto const dx = 0.5f * contacts.x[c];
+            auto const dy = 0.5f * contacts.y[c];
+
+            if (entries[k] & 1u) {
+                x -= dx;
+                y -= dy;
+            } else {
+                x += dx;
+                y += dy;
+            }
+        }
+
+        circles.x[i] = x;
+        circles.y[i] = y;
+    }, GRAIN);
+}
@@ -0,0 +1,141 @@
+#include "histogram.hpp"
+#include "assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using bklib::hdr_histogram;
+using bklib::histogram_snapshot;
+using bklib::uint64_t;
+
+BK_CONSTEXPR unsigned const hdr_histogram::PRECISION_BITS;
+BK_CONSTEXPR size_t   const hdr_histogram::SUB_BUCKETS;
+BK_CONSTEXPR size_t   const hdr_histogram::BUCKETS;
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::hdr_histogram
+////////////////////////////////////////////////////////////////////////////////
+uint64_t hdr_histogram::bucket_min(size_t const i) BK_NOEXCEPT {
+    BK_ASSERT(i < BUCKETS);
+
+    if (i < SUB_BUCKETS) {
+        return i;
+    }
+
+    auto const k        = i - SUB_BUCKETS;
+    auto const shift    = k / (SUB_BUCKETS / 2) + 1;
+    auto const mantissa = static_cast<uint64_t>(k % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2);
+
+    return mantissa << shift;
+}
+//==============================================================================
+uint64_t hdr_histogram::bucket_max(size_t const i) BK_NOEXCEPT {
+    // the last bucket's successor would start at 2^64, which wraps to 0.
+    return (i + 1 < BUCKETS) ? bucket_min(i + 1) - 1 : ~uint64_t {0};
+}
+//==============================================================================
+hdr_histogram::hdr_histogram() BK_NOEXCEPT
+  : sum_ {0}
+{
+    for (auto& c : counts_) {
+        c.store(0, std::memory_order_relaxed);
+    }
+}
+//==============================================================================
+histogram_snapshot hdr_histogram::snapshot() const {
+    std::vector<uint64_t> counts(BUCKETS);
+
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = counts_[i].load(std::memory_order_relaxed);
+    }
+
+    return histogram_snapshot {std::move(counts), sum_.load(std::memory_order_relaxed)};
+}
+//==============================================================================
+histogram_snapshot hdr_histogram::snapshot_and_reset() {
+    std::vector<uint64_t> counts(BUCKETS);
+
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    return histogram_snapshot {std::move(counts), sum_.exchange(0, std::memory_order_relaxed)};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::histogram_snapshot
+////////////////////////////////////////////////////////////////////////////////
+histogram_snapshot::histogram_snapshot(std::vector<uint64_t> counts, uint64_t const sum)
+  : counts_ (std::move(counts))
+  , sum_    {sum}
+{
+    BK_ASSERT(counts_.size() == hdr_histogram::BUCKETS);
+
+    for (auto const c : counts_) {
+        count_ += c;
+    }
+}
+//==============================================================================
+double histogram_snapshot::mean() const BK_NOEXCEPT {
+    return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+}
+//==============================================================================
+uint64_t histogram_snapshot::min() const BK_NOEXCEPT {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i]) {
+            return hdr_histogram::bucket_min(i);
+        }
+    }
+
+    return 0;
+}
+//==============================================================================
+uint64_t histogram_snapshot::max() const BK_NOEXCEPT {
+    for (auto i = counts_.size(); i-- > 0; ) {
+        if (counts_[i]) {
+            return hdr_histogram::bucket_max(i);
+        }
+    }
+
+    return 0;
+}
+//==============================================================================
+uint64_t histogram_snapshot::percentile(double const p) const BK_NOEXCEPT {
+    if (count_ == 0) {
+        return 0;
+    }
+
+    auto const clamped = std::min(std::max(p, 0.0), 100.0);
+    auto const rank    = std::max(uint64_t {1}, static_cast<uint64_t>(
+        std::ceil(clamped / 100.0 * static_cast<double>(count_))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return hdr_histogram::bucket_max(i);
+        }
+    }
+
+    return max();
+}
+//==============================================================================
+histogram_snapshot& histogram_snapshot::operator+=(histogram_snapshot const& other) {
+    if (other.counts_.empty()) {
+        return *this;
+    }
+
+    if (counts_.empty()) {
+        counts_.resize(hdr_histogram::BUCKETS);
+    }
+
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+
+    count_ += other.count_;
+    sum_   += other.sum_;
+
+    return *this;
+}
+//==============================================================================
@@ -1,7 +1,21 @@
 #include "json.hpp"
+#include "json_index.hpp"
 #include "util.hpp"
 #include "assert.hpp"
 
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include <locale.h>
+#include <stdlib.h>
+#if BOOST_OS_MACOS
+#   include <xlocale.h>
+#endif
+
+#include <boost/log/trivial.hpp>
+
 namespace json   = bklib::json;
 namespace error  = bklib::json::error;
 namespace detail = bklib::json::detail;
@@ -11,8 +25,29 @@ using bklib::string_ref;
 
 using json::cref;
 using json::cref_wrapped;
+using json::value_ref;
+using json::document;
+
+namespace {
+//==============================================================================
+//! strtod in the "C" locale: the decimal point of json is '.', whatever the
+//! global locale says.
+//==============================================================================
+#if BOOST_OS_WINDOWS
+double strtod_c(char const* const str) BK_NOEXCEPT {
+    static _locale_t const c_locale = _create_locale(LC_ALL, "C");
+    return _strtod_l(str, nullptr, c_locale);
+}
+#else
+double strtod_c(char const* const str) BK_NOEXCEPT {
+    static locale_t const c_locale = newlocale(LC_ALL_MASK, "C", locale_t {});
+    return strtod_l(str, nullptr, c_locale);
+}
+#endif
+} //namespace
 
-error::bad_type make_bad_type(json::type const expected, json::type const actual) {
+//==============================================================================
+error::bad_type error::make_bad_type(json::type const expected, json::type const actual) {
     error::bad_type e;
 
     e << error::info_expected_type{{expected}}
@@ -38,109 +73,261 @@ string_ref json::type_info::to_string() const {
         switch (this->type) {
         default:
             //fall through to null
-        case type::nullValue:
+        case type::null:
             return "null";
-        case type::intValue:
+        case type::signed_int:
             return "signed";
-        case type::uintValue:
+        case type::unsigned_int:
             return "unsigned";
-        case type::realValue:
+        case type::real:
             return "float";
-        case type::stringValue:
+        case type::string:
             return "string";
-        case type::booleanValue:
+        case type::boolean:
             return "bool";
-        case type::arrayValue:
+        case type::array:
             return "array";
-        case type::objectValue:
+        case type::object:
             return "object";
         }
     }();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// bklib::json::value_ref
+////////////////////////////////////////////////////////////////////////////////
+value_ref value_ref::find(string_ref const key) const BK_NOEXCEPT {
+    BK_ASSERT(is_object());
+
+    auto const members = node_->first_child();
+    auto const count   = node_->size;
+
+    if (auto const index = node_->hash_index()) {
+        auto const mask = detail::hash_index_size(count) - 1;
+
+        for (auto slot = detail::hash_name(key) & mask; index[slot]; slot = (slot + 1) & mask) {
+            auto const member = members + (index[slot] - 1) * 2;
+            if (member->str() == key) {
+                return value_ref{member + 1};
+            }
+        }
+
+        return value_ref{};
+    }
+
+    // the first of any duplicate names.
+    uint32_t first = 0;
+    uint32_t last  = count;
+
+    while (first != last) {
+        auto const mid = first + (last - first) / 2;
+
+        if (members[mid * 2].str() < key) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+
+    return (first != count && members[first * 2].str() == key)
+      ? value_ref{members + first * 2 + 1}
+      : value_ref{};
+}
 //==============================================================================
-cref_wrapped json::require_size(cref json, size_t const min, size_t const max) {
+string_ref value_ref::raw() const BK_NOEXCEPT {
+    if (node_ == nullptr) {
+        return string_ref{"null"};
+    }
+
+    return (is_array() || is_object()) ? string_ref{} : node_->str();
+}
+//==============================================================================
+bool value_ref::as_int(int64_t& out) const BK_NOEXCEPT {
+    BK_ASSERT(is_integral());
+    return detail::parse_integer(raw(), out);
+}
+//==============================================================================
+double value_ref::as_double() const {
+    BK_ASSERT(is_number());
+
+    // the source need not be null terminated: copy it, onto the stack for
+    // any number of sensible length.
+    auto const str = raw();
+
+    char buffer[128];
+    if (str.size() < sizeof(buffer)) {
+        std::memcpy(buffer, str.data(), str.size());
+        buffer[str.size()] = '\0';
+        return strtod_c(buffer);
+    }
+
+    std::string const copy {str.data(), str.size()};
+    return strtod_c(copy.c_str());
+}
+//==============================================================================
+value_ref::iterator value_ref::begin() const BK_NOEXCEPT {
+    if (!is_array() && !is_object()) {
+        return iterator{};
+    }
+
+    return iterator{node_->first_child(), is_object()};
+}
+//==============================================================================
+value_ref::iterator value_ref::end() const BK_NOEXCEPT {
+    if (!is_array() && !is_object()) {
+        return iterator{};
+    }
+
+    auto const stride = is_object() ? 2 : 1;
+    return iterator{node_->first_child() + node_->size * stride, is_object()};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::json::document
+////////////////////////////////////////////////////////////////////////////////
+document::document(string_ref const source)
+  : arena_ {new detail::arena}
+{
+    arena_->text = source;
+    build_();
+}
+//==============================================================================
+document::document(utf8string&& source)
+  : arena_ {new detail::arena}
+{
+    arena_->storage = std::move(source);
+    arena_->text    = arena_->storage;
+    build_();
+}
+//==============================================================================
+void document::build_() {
+    detail::tape tape;
+    tape.text = arena_->text;
+
+    detail::build_tape(tape);
+    detail::build_arena(tape, *arena_);
+}
+
+//==============================================================================
+json::expected<cref> json::try_size(cref json, size_t const min, size_t const max) BK_NOEXCEPT {
     auto const size = json.size();
 
     if (size < min || (max > 0 && size > max)) {
-        BOOST_THROW_EXCEPTION(error::bad_size{}
-         << error::info_expected_size{std::make_pair(min, max)}
-         << error::info_actual_size{size}
-        );
+        return json::error_record::make_bad_size(min, max, size);
     }
 
     return json;
 }
 //==============================================================================
-cref_wrapped json::require_array(cref json) {
-    if (json.isArray()) {
+json::expected<cref> json::try_array(cref json) BK_NOEXCEPT {
+    if (json.is_array()) {
         return json;
     }
 
-    BOOST_THROW_EXCEPTION(
-        make_bad_type(Json::arrayValue, json.type())
-    );
+    return json::error_record::make_bad_type(type::array, json.type());
 }
 //==============================================================================
-cref_wrapped json::require_object(cref json) {
-    if (json.isObject()) {
+json::expected<cref> json::try_object(cref json) BK_NOEXCEPT {
+    if (json.is_object()) {
         return json;
     }
 
-    BOOST_THROW_EXCEPTION(
-        make_bad_type(Json::objectValue, json.type())
-    );
+    return json::error_record::make_bad_type(type::object, json.type());
 }
 //==============================================================================
-cref_wrapped json::require_key(cref json, size_t index) {
-    BK_ASSERT(json.isArray());
-
-    if (json.size() >= index) {
-        return json[index];
+json::expected<cref> json::try_key(cref json, size_t const index) BK_NOEXCEPT {
+    if (!json.is_array()) {
+        return json::error_record::make_bad_type(type::array, json.type());
+    } else if (auto const result = json[index]) {
+        return result;
     }
 
-    BOOST_THROW_EXCEPTION(
-        error::bad_index{} << error::info_index{index}
-    );
+    return json::error_record::make_bad_index(index);
 }
 //==============================================================================
-cref_wrapped json::require_key(cref json, char const* index) {
-    BK_ASSERT(json.isObject());
-
-    if (json.isMember(index)) {
-        return json[index];
+json::expected<cref> json::try_key(cref json, string_ref const index) BK_NOEXCEPT {
+    if (!json.is_object()) {
+        return json::error_record::make_bad_type(type::object, json.type());
+    } else if (auto const result = json.find(index)) {
+        return result;
     }
 
-    BOOST_THROW_EXCEPTION(
-        error::bad_index{} << error::info_index{index}
-    );
+    return json::error_record::make_bad_index(index);
 }
+//==============================================================================
+json::expected<utf8string> json::try_string(cref json) {
+    if (json.is_string()) {
+        return json.as_string();
+    }
 
+    return json::error_record::make_bad_type(type::string, json.type());
+}
 //==============================================================================
-utf8string json::require_string(cref json) {
-    if (json.isString()) {
-        return json.asString();
+json::expected<string_ref> json::try_string_ref(cref json) BK_NOEXCEPT {
+    if (json.is_string()) {
+        return json.raw();
     }
 
-    BOOST_THROW_EXCEPTION(
-        make_bad_type(Json::stringValue, json.type())
-    );
+    return json::error_record::make_bad_type(type::string, json.type());
 }
 //==============================================================================
-int json::require_int(cref json) {
-    if (json.isIntegral()) {
-        return json.asInt();
+json::expected<int> json::try_int(cref json) BK_NOEXCEPT {
+    if (!json.is_integral()) {
+        return json::error_record::make_bad_type(type::signed_int, json.type());
+    }
+
+    int64_t value;
+    if (!json.as_int(value)
+     || value < std::numeric_limits<int>::min()
+     || value > std::numeric_limits<int>::max()
+    ) {
+        return json::error_record::make_bad_value(json.raw());
     }
 
-    BOOST_THROW_EXCEPTION(
-        make_bad_type(Json::intValue, json.type())
-    );
+    return static_cast<int>(value);
+}
+
+//==============================================================================
+cref_wrapped json::require_size(cref json, size_t const min, size_t const max) {
+    return json::try_size(json, min, max).value();
+}
+//==============================================================================
+cref_wrapped json::require_array(cref json) {
+    return json::try_array(json).value();
+}
+//==============================================================================
+cref_wrapped json::require_object(cref json) {
+    return json::try_object(json).value();
+}
+//==============================================================================
+cref_wrapped json::require_key(cref json, size_t const index) {
+    BK_ASSERT(json.is_array());
+    return json::try_key(json, index).value();
+}
+//==============================================================================
+cref_wrapped json::require_key(cref json, string_ref const index) {
+    BK_ASSERT(json.is_object());
+    return json::try_key(json, index).value();
+}
+
+//==============================================================================
+utf8string json::require_string(cref json) {
+    auto result = json::try_string(json);
+    return std::move(result.value());
+}
+//==============================================================================
+string_ref json::require_string_ref(cref json) {
+    return json::try_string_ref(json).value();
+}
+//==============================================================================
+int json::require_int(cref json) {
+    return json::try_int(json).value();
 }
 
 //==============================================================================
 cref_wrapped json::optional_key(cref json, size_t const index) {
-    BK_ASSERT(json.isArray());
-    return (index < json.size()) ? json[index] : Json::Value::null;
+    BK_ASSERT(json.is_array());
+    return json[index];
 }
 
 //==============================================================================
@@ -162,6 +349,15 @@ std::ostream& error::operator<<(std::ostream& out, base const& e) {
     if (auto const ptr = boost::get_error_info<info_index>(e)) {
         out << "\n  index         = " << *ptr;
     }
+    if (auto const ptr = boost::get_error_info<info_value>(e)) {
+        out << "\n  value         = " << *ptr;
+    }
+    if (auto const ptr = boost::get_error_info<info_offset>(e)) {
+        out << "\n  offset        = " << *ptr;
+    }
+    if (auto const ptr = boost::get_error_info<info_reason>(e)) {
+        out << "\n  reason        = " << *ptr;
+    }
 
     out << std::endl;
     return out;
@@ -178,3 +374,11 @@ void json::detail::for_each_element_skip_on_fail_on_fail_(
     ;
 }
 //==============================================================================
+void json::detail::log_element_failure(element_failure const& failure) {
+    try {
+        std::rethrow_exception(failure.error);
+    } catch (error::base const& e) {
+        for_each_element_skip_on_fail_on_fail_(e, failure.index);
+    }
+}
+//==============================================================================
@@ -0,0 +1,337 @@
+#include "json_arena.hpp"
+#include "json_index.hpp"
+#include "json.hpp"
+#include "assert.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace json   = bklib::json;
+namespace error  = bklib::json::error;
+namespace detail = bklib::json::detail;
+
+using bklib::string_ref;
+using bklib::uint32_t;
+
+using detail::node;
+using detail::tape;
+
+namespace {
+//==============================================================================
+inline bool is_whitespace(char const c) BK_NOEXCEPT {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+//------------------------------------------------------------------------------
+//! @returns The index of the tape entry following the value at @c i.
+inline uint32_t next_index(tape const& t, uint32_t const i) BK_NOEXCEPT {
+    auto const c = t.at(i);
+    return (c == '{' || c == '[') ? t.links[i] + 1 : i + 1;
+}
+//------------------------------------------------------------------------------
+//! Scalars end before the next entry, less any whitespace.
+inline char const* scalar_end(tape const& t, uint32_t const i) BK_NOEXCEPT {
+    auto last = t.position(i + 1);
+    while (is_whitespace(last[-1])) {
+        --last;
+    }
+
+    return last;
+}
+//==============================================================================
+//! Fills the arena breadth first, so that the children of each container are
+//! laid out contiguously.
+//==============================================================================
+class arena_builder {
+public:
+    arena_builder(tape const& source, node* const nodes, uint32_t* const index, char* const strings)
+      : tape_          (source)
+      , nodes_         {nodes}
+      , index_cursor_  {index}
+      , string_cursor_ {strings}
+      , tape_index_    (source.value_count)
+    {
+    }
+
+    void run();
+private:
+    //! tape_index_ value of nodes that have already been filled in.
+    static BK_CONSTEXPR uint32_t const FILLED = std::numeric_limits<uint32_t>::max();
+
+    struct member {
+        node     name;
+        uint32_t value; //!< Tape index.
+    };
+
+    node& emplace_(uint32_t const n) {
+        return *::new (static_cast<void*>(nodes_ + n)) node();
+    }
+
+    //! Reserve @c count nodes for the children of nodes_[n].
+    uint32_t add_children_(uint32_t n, uint32_t count) BK_NOEXCEPT;
+
+    void fill_(uint32_t n, uint32_t i);
+    void fill_array_(uint32_t n, uint32_t i);
+    void fill_object_(uint32_t n, uint32_t i);
+    void fill_string_(node& out, uint32_t i);
+    void fill_number_(node& out, uint32_t i) BK_NOEXCEPT;
+    void fill_literal_(node& out, json::type type, uint32_t i, uint32_t size) BK_NOEXCEPT;
+
+    void build_hash_index_(node& object) BK_NOEXCEPT;
+
+    tape const&           tape_;
+    node*                 nodes_;
+    uint32_t*             index_cursor_;
+    char*                 string_cursor_;
+    std::vector<uint32_t> tape_index_; //!< The tape entry of each node.
+    std::vector<member>   members_;    //!< Scratch space for sorting members.
+    uint32_t              next_ = 1;   //!< The next unused node.
+};
+//==============================================================================
+void arena_builder::run() {
+    tape_index_[0] = 0;
+
+    for (uint32_t n = 0; n < next_; ++n) {
+        auto const i = tape_index_[n];
+        if (i != FILLED) {
+            fill_(n, i);
+        }
+    }
+
+    BK_ASSERT(next_ == tape_index_.size());
+}
+//==============================================================================
+uint32_t arena_builder::add_children_(uint32_t const n, uint32_t const count) BK_NOEXCEPT {
+    auto const first = next_;
+    next_ += count;
+
+    nodes_[n].children.first = first - n;
+
+    return first;
+}
+//==============================================================================
+void arena_builder::fill_(uint32_t const n, uint32_t const i) {
+    switch (tape_.at(i)) {
+    case '{' : fill_object_(n, i); break;
+    case '[' : fill_array_(n, i);  break;
+    case '"' : fill_string_(emplace_(n), i); break;
+    case 't' : fill_literal_(emplace_(n), json::type::boolean, i, 4); break;
+    case 'f' : fill_literal_(emplace_(n), json::type::boolean, i, 5); break;
+    case 'n' : fill_literal_(emplace_(n), json::type::null,    i, 4); break;
+    default  : fill_number_(emplace_(n), i); break;
+    }
+}
+//==============================================================================
+void arena_builder::fill_array_(uint32_t const n, uint32_t const i) {
+    auto& array = emplace_(n);
+    auto const count = tape_.links[tape_.links[i]];
+
+    array.type = json::type::array;
+    array.size = count;
+
+    auto const first = add_children_(n, count);
+
+    for (uint32_t k = 0, j = i + 1; k < count; ++k) {
+        tape_index_[first + k] = j;
+        j = next_index(tape_, j) + 1; // skip the ','
+    }
+}
+//==============================================================================
+void arena_builder::fill_object_(uint32_t const n, uint32_t const i) {
+    auto& object = emplace_(n);
+    auto const count = tape_.links[tape_.links[i]];
+
+    object.type = json::type::object;
+    object.size = count;
+
+    auto const first = add_children_(n, count * 2);
+
+    // names are filled in now so that members can be sorted; values later.
+    members_.resize(count);
+
+    for (uint32_t k = 0, j = i + 1; k < count; ++k) {
+        auto& m = members_[k];
+
+        m.name = node();
+        fill_string_(m.name, j);
+        m.value = j + 2; // skip the ':'
+
+        j = next_index(tape_, j + 2) + 1; // skip the ','
+    }
+
+    // stable, so that of duplicate names the first is found.
+    std::stable_sort(begin(members_), end(members_), [](member const& a, member const& b) {
+        return a.name.str() < b.name.str();
+    });
+
+    for (uint32_t k = 0; k < count; ++k) {
+        auto const name = first + k * 2;
+
+        emplace_(name) = members_[k].name;
+
+        tape_index_[name]     = FILLED;
+        tape_index_[name + 1] = members_[k].value;
+    }
+
+    if (count > detail::HASH_THRESHOLD) {
+        build_hash_index_(object);
+    }
+}
+//==============================================================================
+void arena_builder::fill_string_(node& out, uint32_t const i) {
+    auto const first = tape_.position(i) + 1;
+    auto const last  = scalar_end(tape_, i) - 1;
+    auto const size  = static_cast<size_t>(last - first);
+
+    out.type = json::type::string;
+
+    if (!std::memchr(first, '\\', size)) {
+        out.text = first;
+        out.size = static_cast<uint32_t>(size);
+        return;
+    }
+
+    auto const decoded = json::unescape(string_ref{first, size}, string_cursor_);
+
+    out.flags = node::flag_escaped;
+    out.text  = string_cursor_;
+    out.size  = static_cast<uint32_t>(decoded);
+
+    string_cursor_ += decoded;
+}
+//==============================================================================
+void arena_builder::fill_number_(node& out, uint32_t const i) BK_NOEXCEPT {
+    auto const first = tape_.position(i);
+    auto const last  = scalar_end(tape_, i);
+
+    out.text = first;
+    out.size = static_cast<uint32_t>(last - first);
+
+    auto const is_integral = std::none_of(first, last, [](char const c) {
+        return c == '.' || c == 'e' || c == 'E';
+    });
+
+    if (!is_integral) {
+        out.type = json::type::real;
+        return;
+    }
+
+    out.flags = node::flag_integral;
+
+    int64_t value;
+    if (detail::parse_integer(out.str(), value)) {
+        out.type = json::type::signed_int;
+    } else {
+        out.type = (*first == '-') ? json::type::real : json::type::unsigned_int;
+    }
+}
+//==============================================================================
+void arena_builder::fill_literal_(
+    node&            out
+  , json::type const type
+  , uint32_t   const i
+  , uint32_t   const size
+) BK_NOEXCEPT {
+    out.type = type;
+    out.text = tape_.position(i);
+    out.size = size;
+}
+//==============================================================================
+void arena_builder::build_hash_index_(node& object) BK_NOEXCEPT {
+    auto const size    = detail::hash_index_size(object.size);
+    auto const mask    = size - 1;
+    auto const index   = index_cursor_;
+    auto const members = object.first_child();
+
+    index_cursor_ += size;
+    std::fill_n(index, size, 0u);
+
+    object.children.index = static_cast<uint32_t>(
+        reinterpret_cast<char const*>(index) - reinterpret_cast<char const*>(&object)
+    );
+
+    // slots hold the member number + 1; 0 is empty.
+    for (uint32_t k = 0; k < object.size; ++k) {
+        auto const name = members[k * 2].str();
+
+        auto slot = detail::hash_name(name) & mask;
+        for (; index[slot]; slot = (slot + 1) & mask) {
+            if (members[(index[slot] - 1) * 2].str() == name) {
+                break;
+            }
+        }
+
+        if (!index[slot]) {
+            index[slot] = k + 1;
+        }
+    }
+}
+} //namespace
+
+//==============================================================================
+bklib::uint32_t detail::hash_name(string_ref const name) BK_NOEXCEPT {
+    // FNV-1a
+    uint32_t result = 2166136261u;
+
+    for (auto const c : name) {
+        result ^= static_cast<unsigned char>(c);
+        result *= 16777619u;
+    }
+
+    return result;
+}
+//==============================================================================
+bool detail::parse_integer(string_ref const str, int64_t& out) BK_NOEXCEPT {
+    auto       p    = str.data();
+    auto const last = str.data() + str.size();
+
+    auto const negative = (*p == '-');
+    if (negative) ++p;
+
+    uint64_t value {0};
+    auto const limit = negative
+      ? static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1
+      : static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+
+    for (; p != last; ++p) {
+        auto const digit = static_cast<uint64_t>(*p - '0');
+        if (value > (limit - digit) / 10) {
+            return false;
+        }
+
+        value = value * 10 + digit;
+    }
+
+    out = negative
+      ? static_cast<int64_t>(0 - value)
+      : static_cast<int64_t>(value);
+
+    return true;
+}
+//==============================================================================
+void detail::build_arena(tape const& source, arena& result) {
+    auto const node_bytes   = source.value_count * sizeof(node);
+    auto const index_bytes  = source.index_size * sizeof(uint32_t);
+    auto const string_bytes = source.escaped_size;
+    auto const total        = node_bytes + index_bytes + string_bytes;
+
+    // hash indices are found by a 32 bit offset from their object.
+    if (total > std::numeric_limits<uint32_t>::max()) {
+        BOOST_THROW_EXCEPTION(error::parse_error{}
+          << error::info_reason{"document too large"}
+        );
+    }
+
+    result.buffer.reset(new char[total]);
+
+    auto const first = result.buffer.get();
+
+    arena_builder {
+        source
+      , reinterpret_cast<node*>(first)
+      , reinterpret_cast<uint32_t*>(first + node_bytes)
+      , first + node_bytes + index_bytes
+    }.run();
+}
+//==============================================================================
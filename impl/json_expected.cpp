@@ -0,0 +1,54 @@
+#include "json_expected.hpp"
+#include "json.hpp"
+
+namespace json  = bklib::json;
+namespace error = bklib::json::error;
+
+using json::error_kind;
+
+namespace {
+//==============================================================================
+template <typename Exception>
+void raise_(json::error_record const& record, Exception&& e) {
+    if (record.trace_size > 0) {
+        e << error::info_rule_trace{std::vector<bklib::string_ref>(
+            record.trace, record.trace + record.trace_size
+        )};
+    }
+
+    BOOST_THROW_EXCEPTION(e);
+}
+} //namespace
+
+//==============================================================================
+BK_CONSTEXPR size_t const json::error_record::MAX_TRACE;
+//==============================================================================
+void json::error_record::raise() const {
+    switch (kind) {
+    case error_kind::bad_type :
+        raise_(*this, error::make_bad_type(expected_type, actual_type));
+        break;
+    case error_kind::bad_size :
+        raise_(*this, error::bad_size{}
+          << error::info_expected_size{std::make_pair(expected_min, expected_max)}
+          << error::info_actual_size{actual_size}
+        );
+        break;
+    case error_kind::bad_index :
+        if (has_key) {
+            raise_(*this, error::bad_index{} << error::info_index{key.to_string()});
+        } else {
+            raise_(*this, error::bad_index{} << error::info_index{index});
+        }
+        break;
+    case error_kind::bad_value :
+        raise_(*this, error::bad_value{} << error::info_value{value.to_string()});
+        break;
+    case error_kind::none :
+    default :
+        break;
+    }
+
+    BK_ASSERT(false && "raise() called on an empty error_record");
+}
+//==============================================================================
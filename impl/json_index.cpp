@@ -0,0 +1,624 @@
+#include "json_index.hpp"
+#include "json_arena.hpp"
+#include "json.hpp"
+#include "utf8.hpp"
+#include "util.hpp"
+#include "assert.hpp"
+
+#include <cstring>
+#include <limits>
+
+#if defined(BK_SIMD_AVX2)
+#   include <immintrin.h>
+#elif defined(BK_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+
+namespace json   = bklib::json;
+namespace error  = bklib::json::error;
+namespace detail = bklib::json::detail;
+
+using bklib::string_ref;
+using bklib::uint32_t;
+using bklib::uint64_t;
+
+using detail::tape;
+
+namespace {
+//==============================================================================
+inline bool is_whitespace(char const c) BK_NOEXCEPT {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_operator(char const c) BK_NOEXCEPT {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+inline bool is_digit(char const c) BK_NOEXCEPT {
+    return c >= '0' && c <= '9';
+}
+
+inline bool is_hex(char const c) BK_NOEXCEPT {
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+//==============================================================================
+// Stage 1.
+//==============================================================================
+using byte_ptr = unsigned char const*;
+
+static BK_CONSTEXPR size_t const BLOCK_SIZE = 64;
+
+//! One bit per byte of a 64 byte block.
+struct block_masks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t op;
+};
+
+#if defined(BK_SIMD_AVX2) || defined(BK_SIMD_SSE2)
+#if defined(BK_SIMD_AVX2)
+using vec = __m256i;
+static BK_CONSTEXPR size_t const VEC_SIZE = 32;
+
+inline vec load(byte_ptr const p) BK_NOEXCEPT {
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+}
+
+inline vec splat(char const c) BK_NOEXCEPT { return _mm256_set1_epi8(c); }
+inline vec eq(vec const a, vec const b) BK_NOEXCEPT { return _mm256_cmpeq_epi8(a, b); }
+inline vec or_(vec const a, vec const b) BK_NOEXCEPT { return _mm256_or_si256(a, b); }
+
+inline uint64_t to_bits(vec const v) BK_NOEXCEPT {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+}
+#else
+using vec = __m128i;
+static BK_CONSTEXPR size_t const VEC_SIZE = 16;
+
+inline vec load(byte_ptr const p) BK_NOEXCEPT {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+}
+
+inline vec splat(char const c) BK_NOEXCEPT { return _mm_set1_epi8(c); }
+inline vec eq(vec const a, vec const b) BK_NOEXCEPT { return _mm_cmpeq_epi8(a, b); }
+inline vec or_(vec const a, vec const b) BK_NOEXCEPT { return _mm_or_si128(a, b); }
+
+inline uint64_t to_bits(vec const v) BK_NOEXCEPT {
+    return static_cast<uint32_t>(_mm_movemask_epi8(v));
+}
+#endif
+//------------------------------------------------------------------------------
+block_masks classify(byte_ptr const p) BK_NOEXCEPT {
+    block_masks result {0, 0, 0, 0};
+
+    for (size_t i = 0; i < BLOCK_SIZE; i += VEC_SIZE) {
+        auto const v = load(p + i);
+
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}'; nothing else maps to either.
+        auto const folded = or_(v, splat(0x20));
+
+        auto const ws = or_(
+            or_(eq(v, splat(' ')),  eq(v, splat('\n')))
+          , or_(eq(v, splat('\r')), eq(v, splat('\t')))
+        );
+
+        auto const op = or_(
+            or_(eq(folded, splat('{')), eq(folded, splat('}')))
+          , or_(eq(v, splat(':')), eq(v, splat(',')))
+        );
+
+        result.quote      |= to_bits(eq(v, splat('"')))  << i;
+        result.backslash  |= to_bits(eq(v, splat('\\'))) << i;
+        result.whitespace |= to_bits(ws) << i;
+        result.op         |= to_bits(op) << i;
+    }
+
+    return result;
+}
+//------------------------------------------------------------------------------
+//! Sets @c carry on unsigned overflow.
+inline uint64_t add_overflow(uint64_t const a, uint64_t const b, uint64_t& carry) BK_NOEXCEPT {
+    auto const sum = a + b;
+    carry = (sum < a) ? 1 : 0;
+    return sum;
+}
+//------------------------------------------------------------------------------
+//! The characters escaped by a backslash: those following an odd length run
+//! of backslashes. @c prev_escaped carries between blocks.
+inline uint64_t find_escaped(uint64_t backslash, uint64_t& prev_escaped) BK_NOEXCEPT {
+    static BK_CONSTEXPR uint64_t const even_bits = 0x5555555555555555ULL;
+
+    backslash &= ~prev_escaped;
+
+    auto const follows_escape      = (backslash << 1) | prev_escaped;
+    auto const odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+
+    uint64_t carry;
+    auto const sequences_starting_on_even_bits =
+        add_overflow(odd_sequence_starts, backslash, carry);
+
+    prev_escaped = carry;
+
+    auto const invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+//------------------------------------------------------------------------------
+//! Bit i of the result is the parity of bits [0, i] of @c x.
+inline uint64_t prefix_xor(uint64_t x) BK_NOEXCEPT {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+//------------------------------------------------------------------------------
+//! Write the offset of each set bit in @c bits to @c out, eight at a time;
+//! up to seven entries past the result may be overwritten.
+//! @returns One past the last offset written.
+inline uint32_t* flatten(uint64_t bits, uint32_t const base, uint32_t* const out) BK_NOEXCEPT {
+    auto const count = bklib::count_set_bits(bits);
+
+    // the high bit keeps count_trailing_zeros defined once bits runs out.
+    static BK_CONSTEXPR uint64_t const guard = 1ULL << 63;
+
+    for (unsigned i = 0; i < count; i += 8) {
+        for (unsigned j = 0; j < 8; ++j) {
+            out[i + j] = base + bklib::count_trailing_zeros(bits | guard);
+            bits &= bits - 1;
+        }
+    }
+
+    return out + count;
+}
+//------------------------------------------------------------------------------
+//! State carried from one block to the next.
+struct block_state {
+    uint64_t prev_escaped   = 0;
+    uint64_t prev_in_string = 0; //!< All ones or all zeros.
+    uint64_t prev_scalar    = 0;
+};
+//------------------------------------------------------------------------------
+inline uint64_t find_block_structurals(block_masks const& m, block_state& state) BK_NOEXCEPT {
+    auto const escaped   = find_escaped(m.backslash, state.prev_escaped);
+    auto const quote     = m.quote & ~escaped;
+    auto const in_string = prefix_xor(quote) ^ state.prev_in_string;
+
+    state.prev_in_string = static_cast<uint64_t>(static_cast<bklib::int64_t>(in_string) >> 63);
+
+    // the contents of each string and its closing quote.
+    auto const string_tail = in_string ^ quote;
+
+    auto const scalar          = ~(m.op | m.whitespace);
+    auto const nonquote_scalar = scalar & ~quote;
+    auto const follows_scalar  = (nonquote_scalar << 1) | state.prev_scalar;
+
+    state.prev_scalar = nonquote_scalar >> 63;
+
+    auto const scalar_start = scalar & ~follows_scalar;
+
+    // an opening quote directly after a scalar still starts a string.
+    return (m.op | scalar_start | quote) & ~string_tail;
+}
+#endif
+} //namespace
+
+//==============================================================================
+bool detail::find_structurals_scalar(string_ref const source, std::vector<uint32_t>& out) {
+    auto in_string   = false;
+    auto escaped     = false;
+    auto prev_scalar = false;
+
+    auto const size = static_cast<uint32_t>(source.size());
+
+    for (uint32_t i = 0; i < size; ++i) {
+        auto const c = source[i];
+
+        auto const is_quote  = (c == '"') && !escaped;
+        auto const is_scalar = !is_operator(c) && !is_whitespace(c);
+
+        escaped = (c == '\\') && !escaped;
+
+        if (in_string) {
+            in_string = !is_quote;
+        } else if (is_quote) {
+            out.push_back(i);
+            in_string = true;
+        } else if (is_operator(c) || (is_scalar && !prev_scalar)) {
+            out.push_back(i);
+        }
+
+        prev_scalar = is_scalar && !is_quote;
+    }
+
+    return !in_string;
+}
+//==============================================================================
+bool detail::find_structurals(string_ref const source, std::vector<uint32_t>& out) {
+#if defined(BK_SIMD_AVX2) || defined(BK_SIMD_SSE2)
+    auto const first = reinterpret_cast<byte_ptr>(source.data());
+    auto const size  = source.size();
+
+    // a block has at most one structural per byte (the padding of the last
+    // block is whitespace); grow the output a chunk of blocks at a time,
+    // leaving room for flatten to overrun, and trim it afterwards.
+    static BK_CONSTEXPR size_t const CHUNK_SIZE = BLOCK_SIZE * 64;
+
+    block_state state;
+
+    size_t count = out.size();
+    size_t i     = 0;
+
+    while (i != size) {
+        auto const chunk_end = (size - i > CHUNK_SIZE) ? i + CHUNK_SIZE : size;
+
+        out.resize(count + (chunk_end - i) + 8);
+        auto it = out.data() + count;
+
+        for (; chunk_end - i >= BLOCK_SIZE; i += BLOCK_SIZE) {
+            auto const bits = find_block_structurals(classify(first + i), state);
+            it = flatten(bits, static_cast<uint32_t>(i), it);
+        }
+
+        if (i != chunk_end) {
+            // pad the tail with whitespace, which is never structural.
+            unsigned char tail[BLOCK_SIZE];
+            std::memset(tail, ' ', BLOCK_SIZE);
+            std::memcpy(tail, first + i, chunk_end - i);
+
+            auto const bits = find_block_structurals(classify(tail), state);
+            it = flatten(bits, static_cast<uint32_t>(i), it);
+
+            i = chunk_end;
+        }
+
+        count = static_cast<size_t>(it - out.data());
+    }
+
+    out.resize(count);
+
+    return state.prev_in_string == 0;
+#else
+    return find_structurals_scalar(source, out);
+#endif
+}
+
+namespace {
+//==============================================================================
+// Stage 2.
+//==============================================================================
+class tape_builder {
+public:
+    explicit tape_builder(tape& result) BK_NOEXCEPT
+      : text_ {result.text}, offsets_ (result.offsets), links_ (result.links)
+      , result_ (result)
+    {
+    }
+
+    void run();
+private:
+    enum class state : uint8_t {
+        value           //!< Expecting a value.
+      , first_element   //!< Just after '['.
+      , first_member    //!< Just after '{'.
+      , member          //!< Just after ',' in an object.
+      , after_value     //!< Expecting ',' or a closing bracket.
+    };
+
+    struct container {
+        uint32_t index; //!< Of the opening bracket.
+        uint32_t count;
+        bool     is_object;
+    };
+
+    uint32_t size() const BK_NOEXCEPT {
+        return static_cast<uint32_t>(offsets_.size());
+    }
+
+    char at(uint32_t const i) const BK_NOEXCEPT {
+        return text_[offsets_[i]];
+    }
+
+    char const* position(uint32_t const i) const BK_NOEXCEPT {
+        return text_.data() + offsets_[i];
+    }
+
+    char const* last() const BK_NOEXCEPT {
+        return text_.data() + text_.size();
+    }
+
+    state value_(uint32_t i);
+    state open_(uint32_t i, bool is_object);
+    state close_(uint32_t i);
+
+    void check_string_(uint32_t i);
+    void check_number_(uint32_t i) const;
+    void check_literal_(uint32_t i, string_ref literal) const;
+    void check_end_(char const* p, char const* reason) const;
+
+    void fail_(char const* where, char const* reason) const;
+
+    void fail_(uint32_t const i, char const* const reason) const {
+        fail_(i == size() ? last() : position(i), reason);
+    }
+
+    string_ref                   text_;
+    std::vector<uint32_t> const& offsets_;
+    std::vector<uint32_t>&       links_;
+    tape&                        result_;
+    std::vector<container>       open_containers_;
+};
+//==============================================================================
+void tape_builder::fail_(char const* const where, char const* const reason) const {
+    BOOST_THROW_EXCEPTION(error::parse_error{}
+      << error::info_offset{static_cast<size_t>(where - text_.data())}
+      << error::info_reason{reason}
+    );
+}
+//==============================================================================
+void tape_builder::run() {
+    auto const n = size();
+    auto s = state::value;
+
+    for (uint32_t i = 0; ; ++i) {
+        if (i == n) {
+            if (s == state::after_value && open_containers_.empty()) {
+                return;
+            }
+
+            fail_(i, "unexpected end of input");
+        }
+
+        auto const c = at(i);
+
+        switch (s) {
+        case state::first_member :
+            if (c == '}') {
+                s = close_(i);
+                break;
+            }
+            // fall through
+        case state::member :
+            if (c != '"') {
+                fail_(i, "expected a member name");
+            }
+
+            check_string_(i);
+            ++result_.value_count;
+
+            if (++i == n || at(i) != ':') {
+                fail_(i, "expected ':'");
+            }
+
+            ++open_containers_.back().count;
+            s = state::value;
+            break;
+        case state::first_element :
+            if (c == ']') {
+                s = close_(i);
+                break;
+            }
+
+            ++open_containers_.back().count;
+            s = value_(i);
+            break;
+        case state::value :
+            s = value_(i);
+            break;
+        case state::after_value : {
+            if (open_containers_.empty()) {
+                fail_(i, "unexpected trailing characters");
+            }
+
+            auto& top = open_containers_.back();
+
+            if (c == ',') {
+                if (top.is_object) {
+                    s = state::member;
+                } else {
+                    ++top.count;
+                    s = state::value;
+                }
+            } else if (c == (top.is_object ? '}' : ']')) {
+                s = close_(i);
+            } else {
+                fail_(i, top.is_object ? "expected ',' or '}'" : "expected ',' or ']'");
+            }
+        } break;
+        }
+    }
+}
+//==============================================================================
+tape_builder::state tape_builder::value_(uint32_t const i) {
+    ++result_.value_count;
+
+    switch (at(i)) {
+    case '{' : return open_(i, true);
+    case '[' : return open_(i, false);
+    case '"' : check_string_(i);          break;
+    case 't' : check_literal_(i, "true");  break;
+    case 'f' : check_literal_(i, "false"); break;
+    case 'n' : check_literal_(i, "null");  break;
+    case '-' :
+    case '0' : case '1' : case '2' : case '3' : case '4' :
+    case '5' : case '6' : case '7' : case '8' : case '9' :
+        check_number_(i);
+        break;
+    default :
+        fail_(i, "expected a value");
+    }
+
+    return state::after_value;
+}
+//==============================================================================
+tape_builder::state tape_builder::open_(uint32_t const i, bool const is_object) {
+    if (open_containers_.size() == json::reader::MAX_DEPTH) {
+        fail_(i, "maximum nesting depth exceeded");
+    }
+
+    open_containers_.push_back(container {i, 0, is_object});
+
+    return is_object ? state::first_member : state::first_element;
+}
+//==============================================================================
+tape_builder::state tape_builder::close_(uint32_t const i) {
+    BK_ASSERT(!open_containers_.empty());
+
+    auto const& top = open_containers_.back();
+
+    links_[top.index] = i;
+    links_[i]         = top.count;
+
+    if (top.is_object && top.count > detail::HASH_THRESHOLD) {
+        result_.index_size += detail::hash_index_size(top.count);
+    }
+
+    open_containers_.pop_back();
+
+    return state::after_value;
+}
+//==============================================================================
+void tape_builder::check_string_(uint32_t const i) {
+    auto const end   = last();
+    auto const first = position(i) + 1;
+    auto       p     = first;
+
+    auto has_escapes = false;
+
+    // stage 1 guarantees a closing quote; the contents still need checking.
+    for (;;) {
+        auto const c = static_cast<unsigned char>(*p);
+
+        if (c == '"') {
+            break;
+        } else if (c < 0x20) {
+            fail_(p, "control character in string");
+        } else if (c != '\\') {
+            ++p;
+            continue;
+        }
+
+        if (end - p < 2) {
+            fail_(p, "unterminated string");
+        }
+
+        has_escapes = true;
+
+        switch (p[1]) {
+        case '"' : case '\\' : case '/' :
+        case 'b' : case 'f'  : case 'n' : case 'r' : case 't' :
+            p += 2;
+            break;
+        case 'u' :
+            if (end - p < 6
+             || !is_hex(p[2]) || !is_hex(p[3]) || !is_hex(p[4]) || !is_hex(p[5])
+            ) {
+                fail_(p, "bad unicode escape");
+            }
+            p += 6;
+            break;
+        default :
+            fail_(p, "bad escape sequence");
+        }
+    }
+
+    if (has_escapes) {
+        result_.escaped_size += static_cast<size_t>(p - first);
+    }
+}
+//==============================================================================
+void tape_builder::check_number_(uint32_t const i) const {
+    auto const end = last();
+    auto p = position(i);
+
+    auto const digits = [&] {
+        auto const start = p;
+        while (p != end && is_digit(*p)) ++p;
+        return p != start;
+    };
+
+    if (*p == '-') {
+        ++p;
+    }
+
+    if (p != end && *p == '0') {
+        ++p;
+    } else if (!digits()) {
+        fail_(p, "bad number");
+    }
+
+    if (p != end && *p == '.') {
+        ++p;
+        if (!digits()) fail_(p, "bad number");
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p != end && (*p == '+' || *p == '-')) ++p;
+        if (!digits()) fail_(p, "bad number");
+    }
+
+    check_end_(p, "bad number");
+}
+//==============================================================================
+void tape_builder::check_literal_(uint32_t const i, string_ref const literal) const {
+    auto const p    = position(i);
+    auto const size = literal.size();
+
+    if (static_cast<size_t>(last() - p) < size
+     || std::memcmp(p, literal.data(), size) != 0
+    ) {
+        fail_(p, "expected a value");
+    }
+
+    check_end_(p + size, "expected a value");
+}
+//==============================================================================
+//! Stage 1 only records where a scalar starts; make sure it ends at @c p.
+void tape_builder::check_end_(char const* const p, char const* const reason) const {
+    if (p != last() && !is_whitespace(*p) && !is_operator(*p)) {
+        fail_(p, reason);
+    }
+}
+} //namespace
+
+//==============================================================================
+void detail::build_tape(tape& result) {
+    auto const text = result.text;
+
+    if (text.size() >= std::numeric_limits<uint32_t>::max()) {
+        BOOST_THROW_EXCEPTION(error::parse_error{}
+          << error::info_reason{"document too large"}
+        );
+    }
+
+    if (!bklib::validate_utf8(text)) {
+        BOOST_THROW_EXCEPTION(error::parse_error{}
+          << error::info_reason{"invalid utf-8"}
+        );
+    }
+
+    auto& offsets = result.offsets;
+    offsets.clear();
+
+    result.value_count  = 0;
+    result.escaped_size = 0;
+    result.index_size   = 0;
+
+    if (!find_structurals(text, offsets)) {
+        BOOST_THROW_EXCEPTION(error::parse_error{}
+          << error::info_offset{text.size()}
+          << error::info_reason{"unterminated string"}
+        );
+    }
+
+    result.links.resize(offsets.size() + 1);
+
+    tape_builder {result}.run();
+
+    offsets.push_back(static_cast<uint32_t>(text.size()));
+}
+//==============================================================================
@@ -0,0 +1,394 @@
+#include "json_reader.hpp"
+#include "json.hpp"
+#include "assert.hpp"
+
+#include <cstring>
+
+namespace json  = bklib::json;
+namespace error = bklib::json::error;
+
+using bklib::string_ref;
+using bklib::utf8string;
+
+using json::reader;
+using json::token;
+
+namespace {
+//==============================================================================
+inline bool is_whitespace(char const c) BK_NOEXCEPT {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_digit(char const c) BK_NOEXCEPT {
+    return c >= '0' && c <= '9';
+}
+
+inline int hex_value(char const c) BK_NOEXCEPT {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+//! Write the UTF-8 encoding of @c cp to @c out. @returns One past the end.
+char* write_utf8(char* out, unsigned long const cp) BK_NOEXCEPT {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+
+    return out;
+}
+
+unsigned long read_hex4(char const* const p) BK_NOEXCEPT {
+    return (hex_value(p[0]) << 12)
+         | (hex_value(p[1]) << 8)
+         | (hex_value(p[2]) << 4)
+         | (hex_value(p[3]));
+}
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::json::reader
+////////////////////////////////////////////////////////////////////////////////
+reader::reader(string_ref const source) BK_NOEXCEPT
+  : first_ {source.data()}
+  , last_  {source.data() + source.size()}
+  , pos_   {source.data()}
+{
+}
+//==============================================================================
+token reader::fail_(char const* const reason) const {
+    BOOST_THROW_EXCEPTION(error::parse_error{}
+      << error::info_offset{static_cast<size_t>(pos_ - first_)}
+      << error::info_reason{reason}
+    );
+}
+//==============================================================================
+token reader::set_(token const type, char const* const first, char const* const last) BK_NOEXCEPT {
+    token_        = type;
+    value_        = string_ref{first, static_cast<size_t>(last - first)};
+    token_offset_ = static_cast<size_t>(first - first_);
+
+    return type;
+}
+//==============================================================================
+void reader::skip_whitespace_() BK_NOEXCEPT {
+    while (pos_ != last_ && is_whitespace(*pos_)) {
+        ++pos_;
+    }
+}
+//==============================================================================
+token reader::next() {
+    skip_whitespace_();
+
+    switch (state_) {
+    case state::value :
+        return parse_value_();
+    case state::first_element :
+        if (pos_ != last_ && *pos_ == ']') return close_(token::end_array);
+        return parse_value_();
+    case state::first_member :
+        if (pos_ != last_ && *pos_ == '}') return close_(token::end_object);
+        return parse_key_();
+    case state::after_value :
+        break;
+    case state::done :
+        return set_(token::end, pos_, pos_);
+    }
+
+    if (depth_ == 0) {
+        if (pos_ != last_) {
+            return fail_("unexpected trailing characters");
+        }
+
+        state_ = state::done;
+        return set_(token::end, pos_, pos_);
+    }
+
+    if (pos_ == last_) {
+        return fail_("unexpected end of input");
+    }
+
+    auto const is_object = in_object_();
+    auto const c = *pos_;
+
+    if (c == ',') {
+        ++pos_;
+        skip_whitespace_();
+        return is_object ? parse_key_() : parse_value_();
+    } else if (is_object && c == '}') {
+        return close_(token::end_object);
+    } else if (!is_object && c == ']') {
+        return close_(token::end_array);
+    }
+
+    return fail_(is_object ? "expected ',' or '}'" : "expected ',' or ']'");
+}
+//==============================================================================
+void reader::skip() {
+    if (token_ != token::begin_object && token_ != token::begin_array) {
+        return;
+    }
+
+    auto const target = depth_ - 1;
+
+    while (depth_ != target) {
+        next();
+    }
+}
+//==============================================================================
+token reader::open_(token const type, bool const is_object) {
+    if (depth_ == MAX_DEPTH) {
+        return fail_("maximum nesting depth exceeded");
+    }
+
+    is_object_[depth_++] = is_object;
+    state_ = is_object ? state::first_member : state::first_element;
+
+    ++pos_;
+    return set_(type, pos_ - 1, pos_);
+}
+//==============================================================================
+token reader::close_(token const type) {
+    BK_ASSERT(depth_ > 0);
+
+    --depth_;
+    state_ = state::after_value;
+
+    ++pos_;
+    return set_(type, pos_ - 1, pos_);
+}
+//==============================================================================
+token reader::parse_value_() {
+    if (pos_ == last_) {
+        return fail_("unexpected end of input");
+    }
+
+    switch (*pos_) {
+    case '{' : return open_(token::begin_object, true);
+    case '[' : return open_(token::begin_array, false);
+    case '"' : return parse_string_(token::string);
+    case 't' : return parse_literal_("true",  token::true_value);
+    case 'f' : return parse_literal_("false", token::false_value);
+    case 'n' : return parse_literal_("null",  token::null_value);
+    case '-' :
+    case '0' : case '1' : case '2' : case '3' : case '4' :
+    case '5' : case '6' : case '7' : case '8' : case '9' :
+        return parse_number_();
+    default :
+        break;
+    }
+
+    return fail_("expected a value");
+}
+//==============================================================================
+token reader::parse_key_() {
+    if (pos_ == last_ || *pos_ != '"') {
+        return fail_("expected a member name");
+    }
+
+    parse_string_(token::key);
+
+    skip_whitespace_();
+    if (pos_ == last_ || *pos_ != ':') {
+        return fail_("expected ':'");
+    }
+
+    ++pos_;
+    state_ = state::value;
+
+    return token::key;
+}
+//==============================================================================
+token reader::parse_string_(token const type) {
+    BK_ASSERT(*pos_ == '"');
+
+    auto const first = ++pos_;
+    has_escapes_ = false;
+
+    for (;;) {
+        // the common case: a run of plain characters.
+        while (pos_ != last_) {
+            auto const c = static_cast<unsigned char>(*pos_);
+            if (c == '"' || c == '\\' || c < 0x20) break;
+            ++pos_;
+        }
+
+        if (pos_ == last_) {
+            return fail_("unterminated string");
+        }
+
+        auto const c = *pos_;
+
+        if (c == '"') {
+            break;
+        } else if (c != '\\') {
+            return fail_("control character in string");
+        }
+
+        has_escapes_ = true;
+
+        if (last_ - pos_ < 2) {
+            return fail_("unterminated string");
+        }
+
+        switch (pos_[1]) {
+        case '"' : case '\\' : case '/' :
+        case 'b' : case 'f'  : case 'n' : case 'r' : case 't' :
+            pos_ += 2;
+            break;
+        case 'u' :
+            if (last_ - pos_ < 6
+             || hex_value(pos_[2]) < 0 || hex_value(pos_[3]) < 0
+             || hex_value(pos_[4]) < 0 || hex_value(pos_[5]) < 0
+            ) {
+                return fail_("bad unicode escape");
+            }
+            pos_ += 6;
+            break;
+        default :
+            return fail_("bad escape sequence");
+        }
+    }
+
+    set_(type, first, pos_);
+    ++pos_; // closing quote
+
+    state_ = state::after_value;
+    return type;
+}
+//==============================================================================
+token reader::parse_number_() {
+    auto const first = pos_;
+
+    auto const digits = [&] {
+        auto const start = pos_;
+        while (pos_ != last_ && is_digit(*pos_)) ++pos_;
+        return pos_ != start;
+    };
+
+    if (*pos_ == '-') {
+        ++pos_;
+    }
+
+    if (pos_ != last_ && *pos_ == '0') {
+        ++pos_;
+    } else if (!digits()) {
+        return fail_("bad number");
+    }
+
+    if (pos_ != last_ && *pos_ == '.') {
+        ++pos_;
+        if (!digits()) return fail_("bad number");
+    }
+
+    if (pos_ != last_ && (*pos_ == 'e' || *pos_ == 'E')) {
+        ++pos_;
+        if (pos_ != last_ && (*pos_ == '+' || *pos_ == '-')) ++pos_;
+        if (!digits()) return fail_("bad number");
+    }
+
+    state_ = state::after_value;
+    return set_(token::number, first, pos_);
+}
+//==============================================================================
+token reader::parse_literal_(string_ref const literal, token const type) {
+    auto const size = literal.size();
+
+    if (static_cast<size_t>(last_ - pos_) < size
+     || std::memcmp(pos_, literal.data(), size) != 0
+    ) {
+        return fail_("expected a value");
+    }
+
+    pos_ += size;
+
+    state_ = state::after_value;
+    return set_(type, pos_ - size, pos_);
+}
+//==============================================================================
+size_t json::unescape(string_ref const raw, char* const out) BK_NOEXCEPT {
+    auto       it  = raw.data();
+    auto const end = raw.data() + raw.size();
+    auto       dst = out;
+
+    while (it != end) {
+        auto const run = static_cast<char const*>(
+            std::memchr(it, '\\', static_cast<size_t>(end - it))
+        );
+
+        if (run == nullptr) {
+            std::memcpy(dst, it, static_cast<size_t>(end - it));
+            dst += end - it;
+            break;
+        }
+
+        std::memcpy(dst, it, static_cast<size_t>(run - it));
+        dst += run - it;
+        it   = run + 1;
+
+        BK_ASSERT(it != end);
+
+        switch (*it++) {
+        case '"'  : *dst++ = '"';  break;
+        case '\\' : *dst++ = '\\'; break;
+        case '/'  : *dst++ = '/';  break;
+        case 'b'  : *dst++ = '\b'; break;
+        case 'f'  : *dst++ = '\f'; break;
+        case 'n'  : *dst++ = '\n'; break;
+        case 'r'  : *dst++ = '\r'; break;
+        case 't'  : *dst++ = '\t'; break;
+        case 'u'  : {
+            BK_ASSERT(end - it >= 4);
+
+            auto cp = read_hex4(it);
+            it += 4;
+
+            // combine surrogate pairs; a lone surrogate becomes U+FFFD.
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                if (end - it >= 6 && it[0] == '\\' && it[1] == 'u') {
+                    auto const lo = read_hex4(it + 2);
+                    if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        it += 6;
+                    } else {
+                        cp = 0xFFFD;
+                    }
+                } else {
+                    cp = 0xFFFD;
+                }
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                cp = 0xFFFD;
+            }
+
+            dst = write_utf8(dst, cp);
+        } break;
+        default :
+            BK_ASSERT(false && "bad escape");
+            break;
+        }
+    }
+
+    return static_cast<size_t>(dst - out);
+}
+//==============================================================================
+void json::unescape(string_ref const raw, utf8string& out) {
+    auto const size = out.size();
+
+    // decoding never lengthens a string.
+    out.resize(size + raw.size());
+    out.resize(size + json::unescape(raw, &out[size]));
+}
+//==============================================================================
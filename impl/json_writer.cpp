@@ -0,0 +1,804 @@
+#include "json_writer.hpp"
+#include "json.hpp"
+#include "exception.hpp"
+#include "assert.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if BOOST_OS_WINDOWS
+#   include <io.h>
+#else
+#   include <unistd.h>
+#endif
+
+namespace json  = bklib::json;
+namespace error = bklib::json::error;
+
+using bklib::string_ref;
+using bklib::utf8string;
+using bklib::uint32_t;
+using bklib::uint64_t;
+using bklib::int64_t;
+using bklib::int16_t;
+
+using json::output_buffer;
+using json::writer;
+
+namespace {
+//==============================================================================
+// Grisu2; see Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+// with Integers".
+//==============================================================================
+
+//! A floating point value f * 2^e with a 64 bit significand.
+struct diy_fp {
+    uint64_t f;
+    int      e;
+};
+
+inline diy_fp operator-(diy_fp const a, diy_fp const b) BK_NOEXCEPT {
+    BK_ASSERT(a.e == b.e && a.f >= b.f);
+    return diy_fp {a.f - b.f, a.e};
+}
+
+//! The upper 64 bits of the product, rounded.
+inline diy_fp operator*(diy_fp const a, diy_fp const b) BK_NOEXCEPT {
+    uint64_t const m32 = 0xFFFFFFFFu;
+
+    uint64_t const ah = a.f >> 32, al = a.f & m32;
+    uint64_t const bh = b.f >> 32, bl = b.f & m32;
+
+    uint64_t const hh = ah * bh;
+    uint64_t const lh = al * bh;
+    uint64_t const hl = ah * bl;
+    uint64_t const ll = al * bl;
+
+    uint64_t const mid = (ll >> 32) + (hl & m32) + (lh & m32) + (1u << 31);
+
+    return diy_fp {hh + (hl >> 32) + (lh >> 32) + (mid >> 32), a.e + b.e + 64};
+}
+
+inline diy_fp normalize(diy_fp x) BK_NOEXCEPT {
+    BK_ASSERT(x.f != 0);
+
+    while (!(x.f & (uint64_t {1} << 63))) {
+        x.f <<= 1;
+        --x.e;
+    }
+
+    return x;
+}
+
+//! The layout of an IEEE binary floating point type.
+template <typename T> struct float_traits;
+
+template <> struct float_traits<double> {
+    using bits_t = uint64_t;
+    static int const significand_size = 52;
+    static int const exponent_bias    = 0x3FF + significand_size;
+};
+
+template <> struct float_traits<float> {
+    using bits_t = uint32_t;
+    static int const significand_size = 23;
+    static int const exponent_bias    = 0x7F + significand_size;
+};
+
+//! A positive finite @c value and the normalized midpoints between it and its
+//! neighbours.
+template <typename T>
+struct decomposed {
+    diy_fp v;
+    diy_fp minus;
+    diy_fp plus;
+};
+
+template <typename T>
+decomposed<T> decompose(T const value) BK_NOEXCEPT {
+    using traits = float_traits<T>;
+    using bits_t = typename traits::bits_t;
+
+    bits_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    auto const hidden   = uint64_t {1} << traits::significand_size;
+    auto const exponent = static_cast<int>(bits >> traits::significand_size);
+    auto const fraction = static_cast<uint64_t>(bits) & (hidden - 1);
+
+    diy_fp const v = exponent
+      ? diy_fp {fraction + hidden, exponent - traits::exponent_bias}
+      : diy_fp {fraction, 1 - traits::exponent_bias};
+
+    // the upper midpoint normalized; the lower shifted to the same exponent.
+    auto plus = diy_fp {(v.f << 1) + 1, v.e - 1};
+    while (!(plus.f & (hidden << 1))) {
+        plus.f <<= 1;
+        --plus.e;
+    }
+
+    auto const shift = 64 - traits::significand_size - 2;
+    plus.f <<= shift;
+    plus.e  -= shift;
+
+    // the gap below a power of two is half that above.
+    auto minus = (v.f == hidden)
+      ? diy_fp {(v.f << 2) - 1, v.e - 2}
+      : diy_fp {(v.f << 1) - 1, v.e - 1};
+
+    minus.f <<= minus.e - plus.e;
+    minus.e   = plus.e;
+
+    return decomposed<T> {normalize(v), minus, plus};
+}
+
+//! Normalized 10^k for k = -348, -340, ..., 340.
+uint64_t const cached_power_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+int16_t const cached_power_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007,  -980,
+     -954,  -927,  -901,  -874,  -847,  -821,  -794,  -768,  -741,  -715,
+     -688,  -661,  -635,  -608,  -582,  -555,  -529,  -502,  -475,  -449,
+     -422,  -396,  -369,  -343,  -316,  -289,  -263,  -236,  -210,  -183,
+     -157,  -130,  -103,   -77,   -50,   -24,     3,    30,    56,    83,
+      109,   136,   162,   189,   216,   242,   269,   295,   322,   348,
+      375,   402,   428,   455,   481,   508,   534,   561,   588,   614,
+      641,   667,   694,   720,   747,   774,   800,   827,   853,   880,
+      907,   933,   960,   986,  1013,  1039,  1066,
+};
+
+//! A cached power c = 10^-k such that the product of c and a value with
+//! binary exponent @c e has an exponent in [-60, -32].
+diy_fp cached_power(int const e, int& k) BK_NOEXCEPT {
+    // ceil((-61 - e) * log10(2)) + 347
+    auto const dk = (-61 - e) * 0.30102999566398114 + 347;
+    auto ik = static_cast<int>(dk);
+    if (dk - ik > 0.0) {
+        ++ik;
+    }
+
+    auto const index = static_cast<unsigned>((ik >> 3) + 1);
+    k = -(-348 + static_cast<int>(index << 3));
+
+    return diy_fp {cached_power_f[index], cached_power_e[index]};
+}
+
+uint32_t const pow10_32[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+inline int count_digits(uint32_t const n) BK_NOEXCEPT {
+    int result = 1;
+    while (result < 10 && n >= pow10_32[result]) {
+        ++result;
+    }
+
+    return result;
+}
+
+//! Move the last digit down while that brings it closer to the exact value
+//! and stays within the bounds.
+inline void grisu_round(
+    char* const    buffer
+  , int const      size
+  , uint64_t const delta
+  , uint64_t       rest
+  , uint64_t const ten_kappa
+  , uint64_t const wp_w
+) BK_NOEXCEPT {
+    while (rest < wp_w
+        && delta - rest >= ten_kappa
+        && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)
+    ) {
+        --buffer[size - 1];
+        rest += ten_kappa;
+    }
+}
+
+//! Generate the digits of w within the bounds given by mp and delta.
+int generate_digits(diy_fp const w, diy_fp const mp, uint64_t delta, char* const buffer, int& k) BK_NOEXCEPT {
+    diy_fp const one {uint64_t {1} << -mp.e, mp.e};
+    auto const wp_w = mp - w;
+
+    auto p1 = static_cast<uint32_t>(mp.f >> -one.e);
+    auto p2 = mp.f & (one.f - 1);
+
+    int size  = 0;
+    int kappa = count_digits(p1);
+
+    while (kappa > 0) {
+        auto const divisor = pow10_32[kappa - 1];
+        auto const d = p1 / divisor;
+        p1 %= divisor;
+
+        if (d || size) {
+            buffer[size++] = static_cast<char>('0' + d);
+        }
+
+        --kappa;
+
+        auto const rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        if (rest <= delta) {
+            k += kappa;
+            grisu_round(buffer, size, delta, rest, static_cast<uint64_t>(pow10_32[kappa]) << -one.e, wp_w.f);
+            return size;
+        }
+    }
+
+    for (;;) {
+        p2    *= 10;
+        delta *= 10;
+
+        auto const d = static_cast<char>(p2 >> -one.e);
+        if (d || size) {
+            buffer[size++] = static_cast<char>('0' + d);
+        }
+
+        p2 &= one.f - 1;
+        --kappa;
+
+        if (p2 < delta) {
+            k += kappa;
+            auto const index = -kappa;
+            grisu_round(buffer, size, delta, p2, one.f, wp_w.f * (index < 10 ? pow10_32[index] : 0));
+            return size;
+        }
+    }
+}
+
+//! The digits of a positive finite value; value = digits * 10^k.
+template <typename T>
+int grisu2(T const value, char* const buffer, int& k) BK_NOEXCEPT {
+    auto const d = decompose(value);
+
+    auto const c = cached_power(d.plus.e, k);
+
+    auto const w  = d.v * c;
+    auto       wp = d.plus * c;
+    auto       wm = d.minus * c;
+
+    // allow for the error of the products.
+    ++wm.f;
+    --wp.f;
+
+    return generate_digits(w, wp, wp.f - wm.f, buffer, k);
+}
+
+char* write_exponent(int e, char* out) BK_NOEXCEPT {
+    *out++ = 'e';
+
+    if (e < 0) {
+        *out++ = '-';
+        e = -e;
+    }
+
+    if (e >= 100) {
+        *out++ = static_cast<char>('0' + e / 100);
+        e %= 100;
+        *out++ = static_cast<char>('0' + e / 10);
+    } else if (e >= 10) {
+        *out++ = static_cast<char>('0' + e / 10);
+    }
+
+    *out++ = static_cast<char>('0' + e % 10);
+
+    return out;
+}
+
+//! Lay out the digits of digits * 10^k; in place, @c out holding the digits.
+char* prettify(char* const out, int const size, int const k) BK_NOEXCEPT {
+    auto const point = size + k; // the position of the decimal point.
+
+    if (k >= 0 && point <= 21) {
+        // 1234e7 -> 12340000000.0
+        std::fill(out + size, out + point, '0');
+        out[point]     = '.';
+        out[point + 1] = '0';
+        return out + point + 2;
+    } else if (point > 0 && point <= 21) {
+        // 1234e-2 -> 12.34
+        std::memmove(out + point + 1, out + point, static_cast<size_t>(size - point));
+        out[point] = '.';
+        return out + size + 1;
+    } else if (point > -6 && point <= 0) {
+        // 1234e-6 -> 0.001234
+        auto const offset = 2 - point;
+        std::memmove(out + offset, out, static_cast<size_t>(size));
+        out[0] = '0';
+        out[1] = '.';
+        std::fill(out + 2, out + offset, '0');
+        return out + size + offset;
+    } else if (size == 1) {
+        // 1e30
+        return write_exponent(point - 1, out + 1);
+    }
+
+    // 1234e30 -> 1.234e33
+    std::memmove(out + 2, out + 1, static_cast<size_t>(size - 1));
+    out[1] = '.';
+    return write_exponent(point - 1, out + size + 1);
+}
+
+template <typename T>
+char* format_real(T const value, char* out) BK_NOEXCEPT {
+    BK_ASSERT(std::isfinite(value));
+
+    if (std::signbit(value)) {
+        *out++ = '-';
+    }
+
+    if (value == 0) {
+        std::memcpy(out, "0.0", 3);
+        return out + 3;
+    }
+
+    int k;
+    auto const size = grisu2(std::fabs(value), out, k);
+
+    return prettify(out, size, k);
+}
+
+//! Pairs of digits 00 to 99.
+char const digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+//==============================================================================
+//! Characters that must be escaped in a json string: '"', '\\' and controls.
+bool const needs_escape[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+};
+
+char const hex_digits[] = "0123456789abcdef";
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// Number formatting.
+////////////////////////////////////////////////////////////////////////////////
+char* json::format_double(double const value, char* const out) BK_NOEXCEPT {
+    return format_real(value, out);
+}
+//==============================================================================
+char* json::format_float(float const value, char* const out) BK_NOEXCEPT {
+    return format_real(value, out);
+}
+//==============================================================================
+char* json::format_uint(uint64_t value, char* const out) BK_NOEXCEPT {
+    char buffer[20];
+    auto p = buffer + sizeof(buffer);
+
+    while (value >= 100) {
+        auto const pair = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+
+    if (value >= 10) {
+        auto const pair = static_cast<size_t>(value) * 2;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+
+    auto const size = static_cast<size_t>(buffer + sizeof(buffer) - p);
+    std::memcpy(out, p, size);
+
+    return out + size;
+}
+//==============================================================================
+char* json::format_int(int64_t const value, char* out) BK_NOEXCEPT {
+    auto magnitude = static_cast<uint64_t>(value);
+
+    if (value < 0) {
+        *out++ = '-';
+        magnitude = 0 - magnitude;
+    }
+
+    return format_uint(magnitude, out);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::json::output_buffer
+////////////////////////////////////////////////////////////////////////////////
+BK_CONSTEXPR size_t const output_buffer::CHUNK_SIZE;
+//==============================================================================
+void output_buffer::next_chunk_() {
+    if (fd_ >= 0 && pos_) {
+        // only ever one chunk.
+        write_fd_(first_(), static_cast<size_t>(pos_ - first_()));
+        pos_ = first_();
+        return;
+    }
+
+    if (pos_) {
+        used_.push_back(static_cast<size_t>(pos_ - first_()));
+    }
+
+    if (used_.size() == chunks_.size()) {
+        chunks_.emplace_back(new char[CHUNK_SIZE]);
+    }
+
+    pos_  = first_();
+    last_ = pos_ + CHUNK_SIZE;
+}
+//==============================================================================
+void output_buffer::write(char const* data, size_t size) {
+    while (size) {
+        if (pos_ == last_) {
+            next_chunk_();
+        }
+
+        auto const n = std::min(size, static_cast<size_t>(last_ - pos_));
+        std::memcpy(pos_, data, n);
+
+        pos_ += n;
+        data += n;
+        size -= n;
+    }
+}
+//==============================================================================
+size_t output_buffer::size() const BK_NOEXCEPT {
+    size_t result = 0;
+    for (auto const n : used_) {
+        result += n;
+    }
+
+    return result + static_cast<size_t>(pos_ - first_());
+}
+//==============================================================================
+void output_buffer::clear() BK_NOEXCEPT {
+    used_.clear();
+
+    pos_  = first_();
+    last_ = pos_ ? pos_ + CHUNK_SIZE : nullptr;
+}
+//==============================================================================
+void output_buffer::flush() {
+    if (fd_ >= 0 && pos_) {
+        write_fd_(first_(), static_cast<size_t>(pos_ - first_()));
+    }
+
+    clear();
+}
+//==============================================================================
+void output_buffer::write_fd_(char const* data, size_t size) {
+    while (size) {
+#if BOOST_OS_WINDOWS
+        auto const n = ::_write(fd_, data, static_cast<unsigned>(std::min<size_t>(size, CHUNK_SIZE)));
+#else
+        auto const n = ::write(fd_, data, size);
+#endif
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            BOOST_THROW_EXCEPTION(bklib::platform_error{}
+              << boost::errinfo_errno{errno}
+              << boost::errinfo_api_function{"write"}
+            );
+        }
+
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+//==============================================================================
+utf8string output_buffer::to_string() const {
+    utf8string result;
+    result.reserve(size());
+
+    for_each_chunk([&](string_ref const chunk) {
+        result.append(chunk.data(), chunk.size());
+    });
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::json::writer
+////////////////////////////////////////////////////////////////////////////////
+BK_CONSTEXPR size_t const writer::MAX_DEPTH;
+BK_CONSTEXPR size_t const writer::INDENT;
+//==============================================================================
+writer::writer(output_buffer& out, style const format) BK_NOEXCEPT
+  : out_   (out)
+  , style_ {format}
+{
+}
+//==============================================================================
+void writer::newline_(size_t const depth) {
+    out_.put('\n');
+
+    auto remaining = depth * INDENT;
+    while (remaining) {
+        auto const n   = std::min(remaining, output_buffer::CHUNK_SIZE);
+        auto const pos = out_.reserve(n);
+
+        std::memset(pos, ' ', n);
+        out_.commit(pos + n);
+
+        remaining -= n;
+    }
+}
+//==============================================================================
+void writer::prefix_() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+
+    if (depth_ == 0) {
+        BK_ASSERT(!has_root_ && "only one top level value");
+        has_root_ = true;
+        return;
+    }
+
+    BK_ASSERT(!in_object_() && "object members need a key");
+
+    if (!first_) {
+        out_.put(',');
+    }
+
+    first_ = false;
+
+    if (style_ == style::pretty) {
+        newline_(depth_);
+    }
+}
+//==============================================================================
+writer& writer::open_(char const c, bool const is_object) {
+    prefix_();
+
+    BK_ASSERT(depth_ < MAX_DEPTH);
+
+    out_.put(c);
+    is_object_[depth_++] = is_object;
+    first_ = true;
+
+    return *this;
+}
+//==============================================================================
+writer& writer::close_(char const c, bool const is_object) {
+    BK_ASSERT(depth_ > 0 && is_object_[depth_ - 1] == is_object);
+    BK_ASSERT(!after_key_ && "a key without a value");
+
+    --depth_;
+
+    if (style_ == style::pretty && !first_) {
+        newline_(depth_);
+    }
+
+    out_.put(c);
+    first_ = false;
+
+    return *this;
+}
+//==============================================================================
+writer& writer::begin_object() { return open_('{', true); }
+writer& writer::end_object()   { return close_('}', true); }
+writer& writer::begin_array()  { return open_('[', false); }
+writer& writer::end_array()    { return close_(']', false); }
+//==============================================================================
+writer& writer::key(string_ref const name) {
+    BK_ASSERT(in_object_() && !after_key_);
+
+    if (!first_) {
+        out_.put(',');
+    }
+
+    first_ = false;
+
+    if (style_ == style::pretty) {
+        newline_(depth_);
+    }
+
+    string_(name);
+
+    if (style_ == style::pretty) {
+        out_.write(": ", 2);
+    } else {
+        out_.put(':');
+    }
+
+    after_key_ = true;
+
+    return *this;
+}
+//==============================================================================
+void writer::string_(string_ref const str) {
+    out_.put('"');
+
+    auto       p    = str.data();
+    auto const last = p + str.size();
+
+    while (p != last) {
+        // the common case: a run of characters that need no escaping.
+        auto run = p;
+        while (run != last && !needs_escape[static_cast<unsigned char>(*run)]) {
+            ++run;
+        }
+
+        out_.write(p, static_cast<size_t>(run - p));
+
+        if (run == last) {
+            break;
+        }
+
+        auto const c   = static_cast<unsigned char>(*run);
+        auto const pos = out_.reserve(6);
+        auto       end = pos + 2;
+
+        pos[0] = '\\';
+
+        switch (c) {
+        case '"'  : pos[1] = '"';  break;
+        case '\\' : pos[1] = '\\'; break;
+        case '\b' : pos[1] = 'b';  break;
+        case '\f' : pos[1] = 'f';  break;
+        case '\n' : pos[1] = 'n';  break;
+        case '\r' : pos[1] = 'r';  break;
+        case '\t' : pos[1] = 't';  break;
+        default :
+            pos[1] = 'u';
+            pos[2] = '0';
+            pos[3] = '0';
+            pos[4] = hex_digits[c >> 4];
+            pos[5] = hex_digits[c & 0xF];
+            end = pos + 6;
+            break;
+        }
+
+        out_.commit(end);
+        p = run + 1;
+    }
+
+    out_.put('"');
+}
+//==============================================================================
+writer& writer::value(string_ref const str) {
+    prefix_();
+    string_(str);
+    return *this;
+}
+//==============================================================================
+writer& writer::value(bool const b) {
+    prefix_();
+    out_.write(b ? string_ref{"true"} : string_ref{"false"});
+    return *this;
+}
+//==============================================================================
+writer& writer::value(std::nullptr_t) {
+    prefix_();
+    out_.write("null", 4);
+    return *this;
+}
+//==============================================================================
+writer& writer::value(double const d) {
+    if (!std::isfinite(d)) {
+        BOOST_THROW_EXCEPTION(error::bad_value{}
+          << error::info_value{std::isnan(d) ? "nan" : "inf"}
+        );
+    }
+
+    prefix_();
+
+    auto const pos = out_.reserve(MAX_NUMBER_SIZE);
+    out_.commit(json::format_double(d, pos));
+
+    return *this;
+}
+//==============================================================================
+writer& writer::value(float const f) {
+    if (!std::isfinite(f)) {
+        BOOST_THROW_EXCEPTION(error::bad_value{}
+          << error::info_value{std::isnan(f) ? "nan" : "inf"}
+        );
+    }
+
+    prefix_();
+
+    auto const pos = out_.reserve(MAX_NUMBER_SIZE);
+    out_.commit(json::format_float(f, pos));
+
+    return *this;
+}
+//==============================================================================
+writer& writer::int_(int64_t const i) {
+    prefix_();
+
+    auto const pos = out_.reserve(MAX_NUMBER_SIZE);
+    out_.commit(json::format_int(i, pos));
+
+    return *this;
+}
+//==============================================================================
+writer& writer::uint_(uint64_t const i) {
+    prefix_();
+
+    auto const pos = out_.reserve(MAX_NUMBER_SIZE);
+    out_.commit(json::format_uint(i, pos));
+
+    return *this;
+}
+//==============================================================================
+writer& writer::value(json::cref json) {
+    switch (json.type()) {
+    case json::type::object :
+        begin_object();
+        for (auto it = json.begin(); it != json.end(); ++it) {
+            key(it.key());
+            value(*it);
+        }
+        return end_object();
+    case json::type::array :
+        begin_array();
+        for (auto const element : json) {
+            value(element);
+        }
+        return end_array();
+    case json::type::string :
+        return value(json.raw());
+    case json::type::boolean :
+        return value(json.as_bool());
+    case json::type::null :
+        return value(nullptr);
+    default :
+        break;
+    }
+
+    // numbers as written.
+    prefix_();
+    out_.write(json.raw());
+
+    return *this;
+}
+//==============================================================================
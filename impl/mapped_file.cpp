@@ -0,0 +1,253 @@
+#include "mapped_file.hpp"
+#include "assert.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <string>
+
+#if BOOST_OS_WINDOWS
+#   include "impl/win/win_platform.hpp"
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+using bklib::mapped_file;
+using bklib::access_hint;
+using bklib::string_ref;
+
+using view = mapped_file::view;
+
+namespace {
+//==============================================================================
+std::uintptr_t round_down(char const* const p, size_t const page) BK_NOEXCEPT {
+    return reinterpret_cast<std::uintptr_t>(p) & ~static_cast<std::uintptr_t>(page - 1);
+}
+
+std::uintptr_t round_up(char const* const p, size_t const page) BK_NOEXCEPT {
+    return round_down(p + page - 1, page);
+}
+
+#if BOOST_OS_WINDOWS
+//==============================================================================
+struct handle_closer {
+    explicit handle_closer(HANDLE const h) BK_NOEXCEPT : handle {h} {}
+    ~handle_closer() { if (handle && handle != INVALID_HANDLE_VALUE) ::CloseHandle(handle); }
+
+    HANDLE handle;
+};
+
+void throw_error(char const* const function, string_ref const path) {
+    BOOST_THROW_EXCEPTION(bklib::detail::make_windows_error(function)
+      << boost::errinfo_file_name{path.to_string()}
+    );
+}
+#else
+//==============================================================================
+void throw_error(char const* const function, string_ref const path) {
+    BOOST_THROW_EXCEPTION(bklib::platform_error{}
+      << boost::errinfo_errno{errno}
+      << boost::errinfo_api_function{function}
+      << boost::errinfo_file_name{path.to_string()}
+    );
+}
+#endif
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::mapped_file::view
+////////////////////////////////////////////////////////////////////////////////
+view view::sub(size_t const offset, size_t const size) const BK_NOEXCEPT {
+    auto const first = std::min(offset, size_);
+    auto const count = std::min(size, size_ - first);
+
+    return view{data_ + first, count};
+}
+//==============================================================================
+view view::page_aligned(mapped_file const& file) const BK_NOEXCEPT {
+    if (empty()) {
+        return *this;
+    }
+
+    BK_ASSERT(data_ >= file.data() && data_ + size_ <= file.data() + file.size());
+
+    auto const page  = mapped_file::page_size();
+    auto const first = std::max(
+        round_down(data_, page), reinterpret_cast<std::uintptr_t>(file.data()));
+    auto const last  = std::min(
+        round_up(data_ + size_, page), reinterpret_cast<std::uintptr_t>(file.data() + file.size()));
+
+    return view{reinterpret_cast<char const*>(first), static_cast<size_t>(last - first)};
+}
+//==============================================================================
+void view::advise(access_hint const hint) const BK_NOEXCEPT {
+    if (empty()) {
+        return;
+    }
+
+#if BOOST_OS_WINDOWS
+    // no portable equivalent before Windows 8; the hints are advisory anyway.
+    BK_UNUSED(hint);
+#else
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case access_hint::normal     : advice = MADV_NORMAL;     break;
+    case access_hint::sequential : advice = MADV_SEQUENTIAL; break;
+    case access_hint::random     : advice = MADV_RANDOM;     break;
+    case access_hint::will_need  : advice = MADV_WILLNEED;   break;
+    case access_hint::dont_need  : advice = MADV_DONTNEED;   break;
+    }
+
+    // the start must be page aligned; the length need not be.
+    auto const first = round_down(data_, mapped_file::page_size());
+    auto const last  = reinterpret_cast<std::uintptr_t>(data_ + size_);
+
+    ::madvise(reinterpret_cast<void*>(first), static_cast<size_t>(last - first), advice);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::mapped_file
+////////////////////////////////////////////////////////////////////////////////
+size_t mapped_file::page_size() BK_NOEXCEPT {
+#if BOOST_OS_WINDOWS
+    static size_t const size = [] {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwAllocationGranularity);
+    }();
+#else
+    static size_t const size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+
+    return size;
+}
+//==============================================================================
+#if BOOST_OS_WINDOWS
+mapped_file::mapped_file(string_ref const path) {
+    auto const path_size = ::MultiByteToWideChar(
+        CP_UTF8, 0, path.data(), static_cast<int>(path.size()), nullptr, 0);
+
+    std::wstring wide_path(static_cast<size_t>(path_size), L'\0');
+    ::MultiByteToWideChar(
+        CP_UTF8, 0, path.data(), static_cast<int>(path.size()), &wide_path[0], path_size);
+
+    handle_closer const file {::CreateFileW(
+        wide_path.c_str()
+      , GENERIC_READ
+      , FILE_SHARE_READ
+      , nullptr
+      , OPEN_EXISTING
+      , FILE_ATTRIBUTE_NORMAL
+      , nullptr
+    )};
+
+    if (file.handle == INVALID_HANDLE_VALUE) {
+        throw_error("CreateFileW", path);
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file.handle, &size)) {
+        throw_error("GetFileSizeEx", path);
+    }
+
+    if (size.QuadPart == 0) {
+        return;
+    }
+
+    handle_closer const mapping {
+        ::CreateFileMappingW(file.handle, nullptr, PAGE_READONLY, 0, 0, nullptr)
+    };
+
+    if (!mapping.handle) {
+        throw_error("CreateFileMappingW", path);
+    }
+
+    auto const data = ::MapViewOfFile(mapping.handle, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        throw_error("MapViewOfFile", path);
+    }
+
+    // the view keeps the mapping alive.
+    data_ = static_cast<char const*>(data);
+    size_ = static_cast<size_t>(size.QuadPart);
+}
+#else
+mapped_file::mapped_file(string_ref const path) {
+    std::string const path_str = path.to_string();
+
+    auto const fd = ::open(path_str.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw_error("open", path);
+    }
+
+    struct fd_closer {
+        ~fd_closer() { ::close(fd); }
+        int fd;
+    } const closer {fd};
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        throw_error("fstat", path);
+    }
+
+    if (info.st_size == 0) {
+        return;
+    }
+
+    auto const size = static_cast<size_t>(info.st_size);
+    auto const data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        throw_error("mmap", path);
+    }
+
+    // the mapping keeps the file alive.
+    data_ = static_cast<char const*>(data);
+    size_ = size;
+}
+#endif
+//==============================================================================
+mapped_file::mapped_file(mapped_file&& other) BK_NOEXCEPT
+  : data_ {other.data_}
+  , size_ {other.size_}
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+//==============================================================================
+mapped_file& mapped_file::operator=(mapped_file&& rhs) BK_NOEXCEPT {
+    if (this != &rhs) {
+        close_();
+
+        data_ = rhs.data_;
+        size_ = rhs.size_;
+
+        rhs.data_ = nullptr;
+        rhs.size_ = 0;
+    }
+
+    return *this;
+}
+//==============================================================================
+mapped_file::~mapped_file() {
+    close_();
+}
+//==============================================================================
+void mapped_file::close_() BK_NOEXCEPT {
+    if (!data_) {
+        return;
+    }
+
+#if BOOST_OS_WINDOWS
+    ::UnmapViewOfFile(data_);
+#else
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+//==============================================================================
@@ -0,0 +1,248 @@
+#include "math_batch.hpp"
+#include "math_batch_kernels.hpp"
+
+#include <atomic>
+
+#if BOOST_ARCH_X86 && BOOST_COMP_MSVC
+#   include <intrin.h>
+#endif
+
+using bklib::point2d;
+using bklib::vector2d;
+using bklib::transform2d;
+using bklib::simd_level;
+
+namespace detail = bklib::detail;
+
+namespace {
+//==============================================================================
+// The scalar kernels are the math.hpp functions themselves.
+//==============================================================================
+void scalar_transform_aos(float const* const in, size_t const n, transform2d const& m, float* const out) {
+    for (size_t i = 0; i < n; ++i) {
+        auto const p = bklib::transform(m, point2d<float> {in[2*i], in[2*i + 1]});
+        out[2*i]     = p.x;
+        out[2*i + 1] = p.y;
+    }
+}
+
+void scalar_transform_soa(
+    float const* const x, float const* const y, size_t const n
+  , transform2d const& m
+  , float* const out_x, float* const out_y
+) {
+    for (size_t i = 0; i < n; ++i) {
+        auto const p = bklib::transform(m, point2d<float> {x[i], y[i]});
+        out_x[i] = p.x;
+        out_y[i] = p.y;
+    }
+}
+
+void scalar_magnitude_aos(float const* const in, size_t const n, float* const out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = bklib::magnitude<float>(vector2d<float> {in[2*i], in[2*i + 1]});
+    }
+}
+
+void scalar_magnitude_soa(float const* const x, float const* const y, size_t const n, float* const out) {
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = bklib::magnitude<float>(vector2d<float> {x[i], y[i]});
+    }
+}
+
+void scalar_direction_aos(float const* const in, size_t const n, float* const out) {
+    for (size_t i = 0; i < n; ++i) {
+        auto const v = bklib::direction<float>(vector2d<float> {in[2*i], in[2*i + 1]});
+        out[2*i]     = v.x;
+        out[2*i + 1] = v.y;
+    }
+}
+
+void scalar_direction_soa(
+    float const* const x, float const* const y, size_t const n
+  , float* const out_x, float* const out_y
+) {
+    for (size_t i = 0; i < n; ++i) {
+        auto const v = bklib::direction<float>(vector2d<float> {x[i], y[i]});
+        out_x[i] = v.x;
+        out_y[i] = v.y;
+    }
+}
+void scalar_separation_soa(
+    float const* const ax, float const* const ay, float const* const ar
+  , float const* const bx, float const* const by, float const* const br
+  , size_t const n, float* const out_x, float* const out_y
+) {
+    for (size_t i = 0; i < n; ++i) {
+        auto const v = bklib::separation_vector(
+            bklib::circle<float> {{ax[i], ay[i]}, ar[i]}
+          , bklib::circle<float> {{bx[i], by[i]}, br[i]}
+        );
+        out_x[i] = v.x;
+        out_y[i] = v.y;
+    }
+}
+//==============================================================================
+// Processor support, including the operating system saving the registers.
+//==============================================================================
+#if BOOST_ARCH_X86 && !defined(BK_NO_SIMD) && BOOST_COMP_MSVC
+bool cpu_supports(simd_level const level) {
+    int info[4];
+
+    __cpuid(info, 0);
+    auto const max_leaf = info[0];
+
+    __cpuid(info, 1);
+    auto const sse41   = (info[2] & (1 << 19)) != 0;
+    auto const osxsave = (info[2] & (1 << 27)) != 0;
+
+    if (level == simd_level::sse41) {
+        return sse41;
+    }
+
+    if (!osxsave || max_leaf < 7) {
+        return false;
+    }
+
+    auto const xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+
+    switch (level) {
+    case simd_level::avx2 :
+        return (xcr0 & 0x06) == 0x06 && (info[1] & (1 << 5)) != 0;
+    case simd_level::avx512 :
+        return (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0;
+    default :
+        return level == simd_level::scalar;
+    }
+}
+#elif BOOST_ARCH_X86 && !defined(BK_NO_SIMD) && (BOOST_COMP_GNUC || BOOST_COMP_CLANG)
+bool cpu_supports(simd_level const level) {
+    switch (level) {
+    case simd_level::sse41  : return __builtin_cpu_supports("sse4.1");
+    case simd_level::avx2   : return __builtin_cpu_supports("avx2");
+    case simd_level::avx512 : return __builtin_cpu_supports("avx512f");
+    default                 : return level == simd_level::scalar;
+    }
+}
+#else
+bool cpu_supports(simd_level const level) {
+    return level == simd_level::scalar;
+}
+#endif
+//==============================================================================
+detail::batch_kernels const* kernels_for(simd_level const level) {
+    switch (level) {
+    case simd_level::sse41  : return detail::batch_kernels_sse41();
+    case simd_level::avx2   : return detail::batch_kernels_avx2();
+    case simd_level::avx512 : return detail::batch_kernels_avx512();
+    default                 : return detail::batch_kernels_scalar();
+    }
+}
+
+simd_level detect_simd_level() {
+    simd_level const levels[] = {simd_level::avx512, simd_level::avx2, simd_level::sse41};
+
+    for (auto const level : levels) {
+        if (kernels_for(level) && cpu_supports(level)) {
+            return level;
+        }
+    }
+
+    return simd_level::scalar;
+}
+
+std::atomic<simd_level>& active_level() {
+    static std::atomic<simd_level> level {bklib::detected_simd_level()};
+    return level;
+}
+
+detail::batch_kernels const& kernels() {
+    return *kernels_for(active_level().load(std::memory_order_relaxed));
+}
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::detail
+////////////////////////////////////////////////////////////////////////////////
+detail::batch_kernels const* detail::batch_kernels_scalar() {
+    static batch_kernels const result = {
+        &scalar_transform_aos, &scalar_transform_soa
+      , &scalar_magnitude_aos, &scalar_magnitude_soa
+      , &scalar_direction_aos, &scalar_direction_soa
+      , &scalar_separation_soa
+    };
+
+    return &result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib
+////////////////////////////////////////////////////////////////////////////////
+simd_level bklib::detected_simd_level() BK_NOEXCEPT {
+    static simd_level const level = detect_simd_level();
+    return level;
+}
+//==============================================================================
+simd_level bklib::current_simd_level() BK_NOEXCEPT {
+    return active_level().load(std::memory_order_relaxed);
+}
+//==============================================================================
+simd_level bklib::set_simd_level(simd_level level) BK_NOEXCEPT {
+    auto const detected = detected_simd_level();
+
+    // the levels are ordered, but a narrower one may not have been built.
+    while (level > detected || !kernels_for(level) || !cpu_supports(level)) {
+        level = static_cast<simd_level>(static_cast<int>(level) - 1);
+    }
+
+    active_level().store(level, std::memory_order_relaxed);
+    return level;
+}
+//==============================================================================
+void bklib::transform_points(
+    point2d<float> const* const in, size_t const n, transform2d const& m, point2d<float>* const out
+) BK_NOEXCEPT {
+    static_assert(sizeof(point2d<float>) == 2 * sizeof(float), "unexpected layout.");
+
+    kernels().transform_aos(
+        reinterpret_cast<float const*>(in), n, m, reinterpret_cast<float*>(out)
+    );
+}
+//==============================================================================
+void bklib::transform_points(
+    float const* const x, float const* const y, size_t const n, transform2d const& m
+  , float* const out_x, float* const out_y
+) BK_NOEXCEPT {
+    kernels().transform_soa(x, y, n, m, out_x, out_y);
+}
+//==============================================================================
+void bklib::magnitudes(vector2d<float> const* const in, size_t const n, float* const out) BK_NOEXCEPT {
+    static_assert(sizeof(vector2d<float>) == 2 * sizeof(float), "unexpected layout.");
+
+    kernels().magnitude_aos(reinterpret_cast<float const*>(in), n, out);
+}
+//==============================================================================
+void bklib::magnitudes(float const* const x, float const* const y, size_t const n, float* const out) BK_NOEXCEPT {
+    kernels().magnitude_soa(x, y, n, out);
+}
+//==============================================================================
+void bklib::directions(vector2d<float> const* const in, size_t const n, vector2d<float>* const out) BK_NOEXCEPT {
+    kernels().direction_aos(
+        reinterpret_cast<float const*>(in), n, reinterpret_cast<float*>(out)
+    );
+}
+//==============================================================================
+void bklib::directions(
+    float const* const x, float const* const y, size_t const n, float* const out_x, float* const out_y
+) BK_NOEXCEPT {
+    kernels().direction_soa(x, y, n, out_x, out_y);
+}
+//==============================================================================
+void bklib::separation_vectors(
+    float const* const ax, float const* const ay, float const* const ar
+  , float const* const bx, float const* const by, float const* const br
+  , size_t const n, float* const out_x, float* const out_y
+) BK_NOEXCEPT {
+    kernels().separation_soa(ax, ay, ar, bx, by, br, n, out_x, out_y);
+}
@@ -0,0 +1,60 @@
+//==============================================================================
+// AVX2 batch kernels; compiled with AVX2 enabled, and only run when the
+// processor supports it. @see math_batch_kernels.hpp.
+//==============================================================================
+#include "math_batch_kernels.hpp"
+
+#if BOOST_ARCH_X86 && !defined(BK_NO_SIMD) && (defined(__AVX2__) || BOOST_COMP_MSVC)
+#include <immintrin.h>
+
+namespace {
+struct avx2_ops {
+    using reg = __m256;
+
+    static size_t const WIDTH = 8;
+
+    static reg load(float const* const p) { return _mm256_loadu_ps(p); }
+    static void store(float* const p, reg const x) { _mm256_storeu_ps(p, x); }
+    static reg set1(float const x) { return _mm256_set1_ps(x); }
+
+    static reg add(reg const a, reg const b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg const a, reg const b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg const a, reg const b) { return _mm256_mul_ps(a, b); }
+    static reg div(reg const a, reg const b) { return _mm256_div_ps(a, b); }
+    static reg sqrt(reg const a) { return _mm256_sqrt_ps(a); }
+
+    //! Swap the middle two 64 bit quarters: {0 1 2 3} -> {0 2 1 3}.
+    static reg swap_middle(reg const a) {
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(a), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    static void load_pairs(float const* const p, reg& x, reg& y) {
+        auto const a = _mm256_loadu_ps(p);     // x0 y0 x1 y1 | x2 y2 x3 y3
+        auto const b = _mm256_loadu_ps(p + 8); // x4 y4 x5 y5 | x6 y6 x7 y7
+        // shuffles are within 128 bit lanes: x0 x1 x4 x5 | x2 x3 x6 x7.
+        x = swap_middle(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        y = swap_middle(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    static void store_pairs(float* const p, reg const x, reg const y) {
+        auto const xs = swap_middle(x); // x0 x1 x4 x5 | x2 x3 x6 x7
+        auto const ys = swap_middle(y);
+        _mm256_storeu_ps(p,     _mm256_unpacklo_ps(xs, ys));
+        _mm256_storeu_ps(p + 8, _mm256_unpackhi_ps(xs, ys));
+    }
+
+    static reg select_zero(reg const mag, reg const a, reg const b) {
+        auto const zero = _mm256_cmp_ps(mag, _mm256_set1_ps(BATCH_ZERO_LIMIT), _CMP_LE_OQ);
+        return _mm256_blendv_ps(b, a, zero);
+    }
+};
+} //namespace
+
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_avx2() {
+    return batch<avx2_ops>::kernels();
+}
+#else
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_avx2() {
+    return nullptr;
+}
+#endif
@@ -0,0 +1,60 @@
+//==============================================================================
+// AVX-512 batch kernels; compiled with AVX-512F enabled, and only run when the
+// processor supports it. @see math_batch_kernels.hpp.
+//==============================================================================
+#include "math_batch_kernels.hpp"
+
+#if BOOST_ARCH_X86 && !defined(BK_NO_SIMD) && (defined(__AVX512F__) || BOOST_COMP_MSVC)
+#include <immintrin.h>
+
+namespace {
+struct avx512_ops {
+    using reg = __m512;
+
+    static size_t const WIDTH = 16;
+
+    static reg load(float const* const p) { return _mm512_loadu_ps(p); }
+    static void store(float* const p, reg const x) { _mm512_storeu_ps(p, x); }
+    static reg set1(float const x) { return _mm512_set1_ps(x); }
+
+    static reg add(reg const a, reg const b) { return _mm512_add_ps(a, b); }
+    static reg sub(reg const a, reg const b) { return _mm512_sub_ps(a, b); }
+    static reg mul(reg const a, reg const b) { return _mm512_mul_ps(a, b); }
+    static reg div(reg const a, reg const b) { return _mm512_div_ps(a, b); }
+    // masked, as the unmasked form trips -Wmaybe-uninitialized in some gcc.
+    static reg sqrt(reg const a) { return _mm512_mask_sqrt_ps(a, 0xFFFF, a); }
+
+    // two register permutes; index bit 4 selects the second register.
+    static void load_pairs(float const* const p, reg& x, reg& y) {
+        auto const even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        auto const odd  = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+
+        auto const a = _mm512_loadu_ps(p);
+        auto const b = _mm512_loadu_ps(p + 16);
+        x = _mm512_permutex2var_ps(a, even, b);
+        y = _mm512_permutex2var_ps(a, odd,  b);
+    }
+
+    static void store_pairs(float* const p, reg const x, reg const y) {
+        auto const lo = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+        auto const hi = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+
+        _mm512_storeu_ps(p,      _mm512_permutex2var_ps(x, lo, y));
+        _mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(x, hi, y));
+    }
+
+    static reg select_zero(reg const mag, reg const a, reg const b) {
+        auto const zero = _mm512_cmp_ps_mask(mag, _mm512_set1_ps(BATCH_ZERO_LIMIT), _CMP_LE_OQ);
+        return _mm512_mask_blend_ps(zero, b, a);
+    }
+};
+} //namespace
+
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_avx512() {
+    return batch<avx512_ops>::kernels();
+}
+#else
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_avx512() {
+    return nullptr;
+}
+#endif
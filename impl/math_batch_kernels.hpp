@@ -0,0 +1,298 @@
+//==============================================================================
+//! The kernels behind math_batch.hpp, generic over the vector instruction set.
+//!
+//! Each math_batch_<isa>.cpp is compiled with that instruction set enabled,
+//! defines the operations of its vector type and instantiates the kernels
+//! below. The kernels have internal linkage so that no copy compiled for a
+//! wide instruction set can be shared with (and run by) another translation
+//! unit; for the same reason they use no inline functions from elsewhere.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "math_batch.hpp"
+
+namespace bklib {
+namespace detail {
+//==============================================================================
+//! One implementation of each batch function, operating on plain floats; the
+//! array of structures forms take interleaved {x, y} pairs.
+//==============================================================================
+struct batch_kernels {
+    void (*transform_aos)(float const* in, size_t n, transform2d const& m, float* out);
+    void (*transform_soa)(float const* x, float const* y, size_t n, transform2d const& m, float* out_x, float* out_y);
+    void (*magnitude_aos)(float const* in, size_t n, float* out);
+    void (*magnitude_soa)(float const* x, float const* y, size_t n, float* out);
+    void (*direction_aos)(float const* in, size_t n, float* out);
+    void (*direction_soa)(float const* x, float const* y, size_t n, float* out_x, float* out_y);
+    void (*separation_soa)(
+        float const* ax, float const* ay, float const* ar
+      , float const* bx, float const* by, float const* br
+      , size_t n, float* out_x, float* out_y
+    );
+};
+
+//! The kernels for each level; nullptr if not built for this target.
+batch_kernels const* batch_kernels_scalar();
+batch_kernels const* batch_kernels_sse41();
+batch_kernels const* batch_kernels_avx2();
+batch_kernels const* batch_kernels_avx512();
+} //namespace detail
+} //namespace bklib
+
+namespace {
+//==============================================================================
+// Generic kernels over V, which provides:
+//   reg, WIDTH
+//   load(float const*), store(float*, reg), set1(float)
+//   add, sub, mul, div, sqrt
+//   load_pairs(float const*, reg& x, reg& y)  2 * WIDTH interleaved floats.
+//   store_pairs(float*, reg x, reg y)
+//   select_zero(mag, a, b)  a where mag is within 4 ulps of 0 (@see
+//                           bklib::is_equal), otherwise b.
+//
+// Tails shorter than WIDTH go through a zero padded buffer, so that every
+// element takes exactly the same operations.
+//==============================================================================
+//! The largest float within 4 ulps of zero.
+float const BATCH_ZERO_LIMIT = 4.0f * 1.40129846e-45f;
+
+template <typename V>
+struct batch {
+    using reg = typename V::reg;
+
+    static size_t const WIDTH = V::WIDTH;
+
+    //--------------------------------------------------------------------------
+    struct transform_regs {
+        explicit transform_regs(bklib::transform2d const& m)
+          : a  {V::set1(m.a)},  b  {V::set1(m.b)}
+          , c  {V::set1(m.c)},  d  {V::set1(m.d)}
+          , tx {V::set1(m.tx)}, ty {V::set1(m.ty)}
+        {
+        }
+
+        void operator()(reg const x, reg const y, reg& out_x, reg& out_y) const {
+            out_x = V::add(V::add(V::mul(a, x), V::mul(c, y)), tx);
+            out_y = V::add(V::add(V::mul(b, x), V::mul(d, y)), ty);
+        }
+
+        reg a, b, c, d, tx, ty;
+    };
+
+    static reg magnitude(reg const x, reg const y) {
+        return V::sqrt(V::add(V::mul(x, x), V::mul(y, y)));
+    }
+
+    static void direction(reg const x, reg const y, reg& out_x, reg& out_y) {
+        auto const mag = magnitude(x, y);
+        out_x = V::select_zero(mag, x, V::div(x, mag));
+        out_y = V::select_zero(mag, y, V::div(y, mag));
+    }
+
+    //! -((len - ar) - br) is br - (len - ar), exactly.
+    static void separation(
+        reg const ax, reg const ay, reg const ar
+      , reg const bx, reg const by, reg const br
+      , reg& out_x, reg& out_y
+    ) {
+        auto const x   = V::sub(ax, bx);
+        auto const y   = V::sub(ay, by);
+        auto const len = magnitude(x, y);
+        auto const mag = V::sub(br, V::sub(len, ar));
+
+        out_x = V::mul(mag, V::select_zero(len, x, V::div(x, len)));
+        out_y = V::mul(mag, V::select_zero(len, y, V::div(y, len)));
+    }
+    //--------------------------------------------------------------------------
+    static void transform_aos(float const* const in, size_t const n, bklib::transform2d const& m, float* const out) {
+        transform_regs const f {m};
+
+        auto const block = [&](float const* const src, float* const dst) {
+            reg x, y, rx, ry;
+            V::load_pairs(src, x, y);
+            f(x, y, rx, ry);
+            V::store_pairs(dst, rx, ry);
+        };
+
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            block(in + 2*i, out + 2*i);
+        }
+
+        if (i != n) {
+            float buffer[2 * WIDTH] = {};
+            std::memcpy(buffer, in + 2*i, 2 * (n - i) * sizeof(float));
+            block(buffer, buffer);
+            std::memcpy(out + 2*i, buffer, 2 * (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void transform_soa(
+        float const* const x, float const* const y, size_t const n
+      , bklib::transform2d const& m
+      , float* const out_x, float* const out_y
+    ) {
+        transform_regs const f {m};
+
+        auto const block = [&](float const* const sx, float const* const sy, float* const dx, float* const dy) {
+            reg rx, ry;
+            f(V::load(sx), V::load(sy), rx, ry);
+            V::store(dx, rx);
+            V::store(dy, ry);
+        };
+
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            block(x + i, y + i, out_x + i, out_y + i);
+        }
+
+        if (i != n) {
+            float bx[WIDTH] = {};
+            float by[WIDTH] = {};
+            std::memcpy(bx, x + i, (n - i) * sizeof(float));
+            std::memcpy(by, y + i, (n - i) * sizeof(float));
+            block(bx, by, bx, by);
+            std::memcpy(out_x + i, bx, (n - i) * sizeof(float));
+            std::memcpy(out_y + i, by, (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void magnitude_aos(float const* const in, size_t const n, float* const out) {
+        auto const block = [&](float const* const src, float* const dst) {
+            reg x, y;
+            V::load_pairs(src, x, y);
+            V::store(dst, magnitude(x, y));
+        };
+
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            block(in + 2*i, out + i);
+        }
+
+        if (i != n) {
+            float src[2 * WIDTH] = {};
+            float dst[WIDTH];
+            std::memcpy(src, in + 2*i, 2 * (n - i) * sizeof(float));
+            block(src, dst);
+            std::memcpy(out + i, dst, (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void magnitude_soa(float const* const x, float const* const y, size_t const n, float* const out) {
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            V::store(out + i, magnitude(V::load(x + i), V::load(y + i)));
+        }
+
+        if (i != n) {
+            float bx[WIDTH] = {};
+            float by[WIDTH] = {};
+            std::memcpy(bx, x + i, (n - i) * sizeof(float));
+            std::memcpy(by, y + i, (n - i) * sizeof(float));
+            V::store(bx, magnitude(V::load(bx), V::load(by)));
+            std::memcpy(out + i, bx, (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void direction_aos(float const* const in, size_t const n, float* const out) {
+        auto const block = [&](float const* const src, float* const dst) {
+            reg x, y, rx, ry;
+            V::load_pairs(src, x, y);
+            direction(x, y, rx, ry);
+            V::store_pairs(dst, rx, ry);
+        };
+
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            block(in + 2*i, out + 2*i);
+        }
+
+        if (i != n) {
+            float buffer[2 * WIDTH] = {};
+            std::memcpy(buffer, in + 2*i, 2 * (n - i) * sizeof(float));
+            block(buffer, buffer);
+            std::memcpy(out + 2*i, buffer, 2 * (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void direction_soa(
+        float const* const x, float const* const y, size_t const n
+      , float* const out_x, float* const out_y
+    ) {
+        auto const block = [&](float const* const sx, float const* const sy, float* const dx, float* const dy) {
+            reg rx, ry;
+            direction(V::load(sx), V::load(sy), rx, ry);
+            V::store(dx, rx);
+            V::store(dy, ry);
+        };
+
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            block(x + i, y + i, out_x + i, out_y + i);
+        }
+
+        if (i != n) {
+            float bx[WIDTH] = {};
+            float by[WIDTH] = {};
+            std::memcpy(bx, x + i, (n - i) * sizeof(float));
+            std::memcpy(by, y + i, (n - i) * sizeof(float));
+            block(bx, by, bx, by);
+            std::memcpy(out_x + i, bx, (n - i) * sizeof(float));
+            std::memcpy(out_y + i, by, (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static void separation_soa(
+        float const* const ax, float const* const ay, float const* const ar
+      , float const* const bx, float const* const by, float const* const br
+      , size_t const n, float* const out_x, float* const out_y
+    ) {
+        size_t i = 0;
+        for (; n - i >= WIDTH; i += WIDTH) {
+            reg rx, ry;
+            separation(
+                V::load(ax + i), V::load(ay + i), V::load(ar + i)
+              , V::load(bx + i), V::load(by + i), V::load(br + i)
+              , rx, ry
+            );
+            V::store(out_x + i, rx);
+            V::store(out_y + i, ry);
+        }
+
+        if (i != n) {
+            float buffer[6][WIDTH] = {};
+            float const* const in[6] = {ax, ay, ar, bx, by, br};
+            for (size_t j = 0; j < 6; ++j) {
+                std::memcpy(buffer[j], in[j] + i, (n - i) * sizeof(float));
+            }
+
+            reg rx, ry;
+            separation(
+                V::load(buffer[0]), V::load(buffer[1]), V::load(buffer[2])
+              , V::load(buffer[3]), V::load(buffer[4]), V::load(buffer[5])
+              , rx, ry
+            );
+            V::store(buffer[0], rx);
+            V::store(buffer[1], ry);
+            std::memcpy(out_x + i, buffer[0], (n - i) * sizeof(float));
+            std::memcpy(out_y + i, buffer[1], (n - i) * sizeof(float));
+        }
+    }
+    //--------------------------------------------------------------------------
+    static bklib::detail::batch_kernels const* kernels() {
+        static bklib::detail::batch_kernels const result = {
+            &transform_aos, &transform_soa
+          , &magnitude_aos, &magnitude_soa
+          , &direction_aos, &direction_soa
+          , &separation_soa
+        };
+
+        return &result;
+    }
+};
+
+} //namespace
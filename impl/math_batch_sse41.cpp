@@ -0,0 +1,51 @@
+//==============================================================================
+// SSE4.1 batch kernels; compiled with SSE4.1 enabled, and only run when the
+// processor supports it. @see math_batch_kernels.hpp.
+//==============================================================================
+#include "math_batch_kernels.hpp"
+
+#if BOOST_ARCH_X86 && !defined(BK_NO_SIMD) && (defined(__SSE4_1__) || BOOST_COMP_MSVC)
+#include <smmintrin.h>
+
+namespace {
+struct sse41_ops {
+    using reg = __m128;
+
+    static size_t const WIDTH = 4;
+
+    static reg load(float const* const p) { return _mm_loadu_ps(p); }
+    static void store(float* const p, reg const x) { _mm_storeu_ps(p, x); }
+    static reg set1(float const x) { return _mm_set1_ps(x); }
+
+    static reg add(reg const a, reg const b) { return _mm_add_ps(a, b); }
+    static reg sub(reg const a, reg const b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg const a, reg const b) { return _mm_mul_ps(a, b); }
+    static reg div(reg const a, reg const b) { return _mm_div_ps(a, b); }
+    static reg sqrt(reg const a) { return _mm_sqrt_ps(a); }
+
+    static void load_pairs(float const* const p, reg& x, reg& y) {
+        auto const a = _mm_loadu_ps(p);     // x0 y0 x1 y1
+        auto const b = _mm_loadu_ps(p + 4); // x2 y2 x3 y3
+        x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    static void store_pairs(float* const p, reg const x, reg const y) {
+        _mm_storeu_ps(p,     _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(p + 4, _mm_unpackhi_ps(x, y));
+    }
+
+    static reg select_zero(reg const mag, reg const a, reg const b) {
+        return _mm_blendv_ps(b, a, _mm_cmple_ps(mag, _mm_set1_ps(BATCH_ZERO_LIMIT)));
+    }
+};
+} //namespace
+
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_sse41() {
+    return batch<sse41_ops>::kernels();
+}
+#else
+bklib::detail::batch_kernels const* bklib::detail::batch_kernels_sse41() {
+    return nullptr;
+}
+#endif
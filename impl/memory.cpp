@@ -0,0 +1,122 @@
+#include "memory.hpp"
+
+#include <algorithm>
+
+using bklib::frame_arena;
+using bklib::fixed_pool;
+using bklib::allocator_stats;
+
+BK_CONSTEXPR size_t const frame_arena::DEFAULT_BLOCK_SIZE;
+BK_CONSTEXPR size_t const fixed_pool::DEFAULT_CHUNK_OBJECTS;
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::frame_arena
+////////////////////////////////////////////////////////////////////////////////
+frame_arena::frame_arena(size_t const block_size)
+  : block_size_ {std::max(block_size, sizeof(std::max_align_t))}
+{
+    add_block_(block_size_);
+}
+//==============================================================================
+frame_arena::~frame_arena() {
+    free_blocks_();
+}
+//==============================================================================
+void* frame_arena::allocate_slow_(size_t const size, size_t const align) {
+    retired_ += static_cast<size_t>(pos_ - blocks_.back().data);
+
+    // enough for the request whatever the alignment of the new block.
+    add_block_(std::max(block_size_, size + align - 1));
+
+    return allocate(size, align);
+}
+//==============================================================================
+void frame_arena::add_block_(size_t const size) {
+    blocks_.reserve(blocks_.size() + 1);
+    blocks_.push_back(block {static_cast<char*>(::operator new(size)), size});
+
+    ++heap_allocations_;
+
+    pos_ = blocks_.back().data;
+    end_ = pos_ + size;
+}
+//==============================================================================
+void frame_arena::free_blocks_() BK_NOEXCEPT {
+    for (auto const& b : blocks_) {
+        ::operator delete(b.data);
+    }
+
+    blocks_.clear();
+}
+//==============================================================================
+void frame_arena::reset() {
+    high_water_ = std::max(high_water_, used());
+
+    if (blocks_.size() > 1) {
+        // the next frame of this size fits in a single block.
+        auto const size = capacity();
+        free_blocks_();
+        add_block_(size);
+    }
+
+    retired_ = 0;
+    pos_     = blocks_.front().data;
+    end_     = pos_ + blocks_.front().size;
+}
+//==============================================================================
+size_t frame_arena::used() const BK_NOEXCEPT {
+    return retired_ + static_cast<size_t>(pos_ - blocks_.back().data);
+}
+//==============================================================================
+size_t frame_arena::capacity() const BK_NOEXCEPT {
+    size_t result = 0;
+    for (auto const& b : blocks_) {
+        result += b.size;
+    }
+
+    return result;
+}
+//==============================================================================
+allocator_stats frame_arena::stats() const BK_NOEXCEPT {
+    auto const in_use = used();
+    return allocator_stats {in_use, std::max(high_water_, in_use), heap_allocations_};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::fixed_pool
+////////////////////////////////////////////////////////////////////////////////
+fixed_pool::fixed_pool(
+    size_t const size
+  , size_t const align
+  , size_t const objects_per_chunk
+)
+  : size_  {0}
+  , align_ {std::max(align, alignof(free_node))}
+  , objects_per_chunk_ {std::max(objects_per_chunk, size_t {1})}
+{
+    BK_ASSERT(align && !(align & (align - 1)));
+    BK_ASSERT(align <= alignof(std::max_align_t));
+
+    // a multiple of the alignment with room for the free list link.
+    auto const n = std::max(size, sizeof(free_node));
+    size_ = (n + align_ - 1) & ~(align_ - 1);
+}
+//==============================================================================
+void fixed_pool::add_chunk_() {
+    chunks_.reserve(chunks_.size() + 1);
+    chunks_.emplace_back(new char[size_ * objects_per_chunk_]);
+
+    auto const first = chunks_.back().get();
+
+    // link in address order, so that a fresh chunk is handed out sequentially.
+    for (size_t i = objects_per_chunk_; i-- > 0; ) {
+        auto const node = reinterpret_cast<free_node*>(first + i * size_);
+        node->next = free_;
+        free_ = node;
+    }
+}
+//==============================================================================
+allocator_stats fixed_pool::stats() const BK_NOEXCEPT {
+    return allocator_stats {in_use_, high_water_, chunks_.size()};
+}
+//==============================================================================
@@ -3,10 +3,193 @@
 
 using mouse = bklib::mouse;
 using record = bklib::mouse::record;
+using bklib::motion_estimator;
+using bklib::time_point;
+
+namespace {
+float seconds(bklib::clock_t::duration const d) BK_NOEXCEPT {
+    return std::chrono::duration_cast<std::chrono::duration<float>>(d).count();
+}
+
+template <typename T>
+T square(T const x) BK_NOEXCEPT {
+    return x * x;
+}
+
+//! In 64 bits: the square of a difference of coordinates can exceed an int.
+std::int64_t squared_distance(mouse::point const a, mouse::point const b) BK_NOEXCEPT {
+    return bklib::detail::distance2_wide(a, b);
+}
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::motion_estimator
+////////////////////////////////////////////////////////////////////////////////
+motion_estimator::motion_estimator(float const alpha) BK_NOEXCEPT
+  : velocity_     {alpha}
+  , acceleration_ {alpha}
+{
+}
+//==============================================================================
+float motion_estimator::push(vector const delta, time_point const when) BK_NOEXCEPT {
+    if (empty_) {
+        empty_ = false;
+        last_  = when;
+        return 0.0f;
+    }
+
+    pending_ += delta;
+
+    auto const dt = seconds(when - last_);
+    if (dt <= 0.0f) {
+        return 0.0f;
+    }
+
+    auto const v0 = velocity_.value();
+    auto const v1 = velocity_(pending_ / dt);
+
+    acceleration_((v1 - v0) / dt);
+
+    pending_ = vector {0.0f, 0.0f};
+    last_    = when;
+
+    return dt;
+}
+//==============================================================================
+void motion_estimator::reset() BK_NOEXCEPT {
+    velocity_.reset();
+    acceleration_.reset();
+
+    pending_ = vector {0.0f, 0.0f};
+    empty_   = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::mouse::history
+////////////////////////////////////////////////////////////////////////////////
+void mouse::history::push(record const r) BK_NOEXCEPT {
+    using std::chrono::microseconds;
+    using std::chrono::duration_cast;
+
+    // offsets are kept below 2^31 us (~35 minutes) by moving the epoch up;
+    // records older than that read as the new epoch.
+    static auto const LIMIT = uint64_t {1} << 31;
+
+    if (cursor_.empty()) {
+        epoch_ = r.time;
+    }
+
+    auto const offset = duration_cast<microseconds>(r.time - epoch_).count();
+    auto ticks = offset > 0 ? static_cast<uint64_t>(offset) : uint64_t {0};
+
+    if (ticks >= LIMIT) {
+        auto const shift = ticks - LIMIT / 2;
+
+        epoch_ += microseconds {shift};
+        for (auto& t : time_) {
+            t = (t > shift) ? static_cast<uint32_t>(t - shift) : 0u;
+        }
+
+        ticks -= shift;
+    }
+
+    auto const s = cursor_.push();
+
+    time_[s] = static_cast<uint32_t>(ticks);
+    x_[s]    = r.x;
+    y_[s]    = r.y;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // bklib::mouse
 ////////////////////////////////////////////////////////////////////////////////
+void mouse::push_absolute(coord_t const x, coord_t const y, time_point const when) {
+    auto const prev = abs_history_[0];
+    abs_history_.push(record {when, x, y});
+
+    auto const p  = point {x, y};
+    auto const dt = abs_motion_.push(
+        {static_cast<float>(x - prev.x), static_cast<float>(y - prev.y)}, when);
+
+    point2d<float> const pf {static_cast<float>(x), static_cast<float>(y)};
+    smoothed_(pf);
+    filtered_(pf, dt);
+
+    for (auto& b : button_state_) {
+        if (b && !b.dragging && squared_distance(p, b.origin) > square(std::int64_t {gestures_.drag_distance})) {
+            b.dragging = true;
+        }
+    }
+
+    if (squared_distance(p, hover_anchor_) > square(std::int64_t {gestures_.hover_distance})) {
+        hover_anchor_ = p;
+        hover_since_  = when;
+        hovering_     = false;
+    }
+}
+//==============================================================================
+void mouse::push_relative(coord_t const x, coord_t const y, time_point const when) {
+    rel_history_.push(record {when, x, y});
+    rel_motion_.push({static_cast<float>(x), static_cast<float>(y)}, when);
+}
+//==============================================================================
+mouse::button_record mouse::set_button(
+    size_t     const button
+  , time_point const when
+  , bool       const down
+) {
+    BK_ASSERT(button < BUTTON_COUNT);
+
+    auto& b = button_state_[button];
+    auto const state = down ? button_state::down : button_state::up;
+
+    if (b.state == state) {
+        return b;
+    }
+
+    b.state = state;
+    b.time  = when;
+
+    if (down) {
+        auto const p = position();
+
+        auto const again = b.clicks > 0
+            && when - last_down_[button] <= gestures_.double_click_time
+            && squared_distance(p, b.origin) <= square(std::int64_t {gestures_.double_click_distance});
+
+        b.clicks   = again ? b.clicks + 1 : 1;
+        b.dragging = false;
+        b.origin   = p;
+
+        last_down_[button] = when;
+    } else if (b.dragging) {
+        b.clicks = 0; // a drag does not start a click sequence.
+    }
+
+    return b;
+}
+//==============================================================================
+void mouse::set_position_filters(
+    float                   const ema_alpha
+  , position_filter::params const params
+) {
+    smoothed_ = ema_filter<point2d<float>> {ema_alpha};
+    filtered_ = position_filter {params};
+}
+//==============================================================================
+bool mouse::update_hover(time_point const now) BK_NOEXCEPT {
+    if (hovering_ || abs_motion_.empty()) {
+        return false;
+    }
+
+    if (now - hover_since_ < gestures_.hover_time) {
+        return false;
+    }
+
+    hovering_ = true;
+    return true;
+}
+//==============================================================================
 //record mouse::history(
 //    history_type const type
 //  , size_t       const n
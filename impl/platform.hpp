@@ -2,8 +2,8 @@
 
 #include "config.hpp"
 
-#if defined(BOOST_OS_WINDOWS)
+#if BOOST_OS_WINDOWS
 #   include "impl/win/win_platform.hpp"
 #else
-#   error "fill me in"
+#   error "only implemented for Windows"
 #endif
@@ -0,0 +1,190 @@
+#include "profiler.hpp"
+#include "json_writer.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace profiler = bklib::profiler;
+namespace json     = bklib::json;
+
+using bklib::string_ref;
+using bklib::uint64_t;
+
+std::atomic<bool> profiler::detail::enabled {false};
+
+namespace {
+//==============================================================================
+//! A zone, as written by its thread and read by the exporter.
+struct event {
+    std::atomic<char const*> name;
+    std::atomic<uint64_t>    begin;
+    std::atomic<uint64_t>    end;
+};
+
+//==============================================================================
+//! The ring of zones recorded by one thread.
+//!
+//! Only the owning thread writes; @c count is published after each event so
+//! that an exporter can read the events behind it. An event overwritten while
+//! being read is detected by re-reading @c count, and dropped: as in a
+//! seqlock, the writer's fence orders its earlier stores to @c count before
+//! the fields of the next event, so a reader that sees any of those fields
+//! also sees that the slot was being reused.
+//==============================================================================
+struct thread_buffer {
+    explicit thread_buffer(size_t const id)
+      : id     {id}
+      , events {new event[profiler::BUFFER_SIZE]}
+    {
+    }
+
+    void push(char const* const name, uint64_t const begin, uint64_t const end) BK_NOEXCEPT {
+        auto const n = count.load(std::memory_order_relaxed);
+        auto& e = events[n & (profiler::BUFFER_SIZE - 1)];
+
+        std::atomic_thread_fence(std::memory_order_release);
+        e.name.store(name, std::memory_order_relaxed);
+        e.begin.store(begin, std::memory_order_relaxed);
+        e.end.store(end, std::memory_order_relaxed);
+
+        count.store(n + 1, std::memory_order_release);
+    }
+
+    size_t                   id;
+    std::string              name;     //!< Guarded by registry::mutex.
+    std::unique_ptr<event[]> events;
+    std::atomic<uint64_t>    count {0}; //!< Events ever pushed.
+};
+
+//==============================================================================
+//! Every thread that has recorded a zone; buffers outlive their threads so
+//! that their zones can still be exported.
+//==============================================================================
+struct registry {
+    static registry& instance() {
+        static registry result;
+        return result;
+    }
+
+    thread_buffer& add() {
+        std::lock_guard<std::mutex> lock {mutex};
+        buffers.emplace_back(new thread_buffer {buffers.size()});
+        return *buffers.back();
+    }
+
+    std::mutex                                  mutex;
+    std::vector<std::unique_ptr<thread_buffer>> buffers;
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+};
+
+thread_buffer& this_thread_buffer() {
+    thread_local thread_buffer& buffer = registry::instance().add();
+    return buffer;
+}
+
+//! Microseconds, as trace_event expects.
+double to_us(uint64_t const ns) BK_NOEXCEPT {
+    return static_cast<double>(ns) / 1000.0;
+}
+} //namespace
+
+//==============================================================================
+uint64_t profiler::detail::now() BK_NOEXCEPT {
+    using namespace std::chrono;
+
+    // the registry is created first, so that start precedes every zone.
+    static auto const start = registry::instance().start;
+
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now() - start).count());
+}
+//==============================================================================
+void profiler::detail::record(
+    char const* const name
+  , uint64_t    const begin
+  , uint64_t    const end
+) BK_NOEXCEPT {
+    this_thread_buffer().push(name, begin, end);
+}
+//==============================================================================
+void profiler::enable(bool const on) BK_NOEXCEPT {
+    detail::now(); // start the clock.
+    detail::enabled.store(on, std::memory_order_relaxed);
+}
+//==============================================================================
+void profiler::set_thread_name(string_ref const name) {
+    auto& buffer = this_thread_buffer();
+
+    std::lock_guard<std::mutex> lock {registry::instance().mutex};
+    buffer.name = name.to_string();
+}
+//==============================================================================
+void profiler::clear() {
+    auto& r = registry::instance();
+
+    std::lock_guard<std::mutex> lock {r.mutex};
+    for (auto& buffer : r.buffers) {
+        buffer->count.store(0, std::memory_order_relaxed);
+    }
+}
+//==============================================================================
+void profiler::write_chrome_trace(json::output_buffer& out) {
+    auto& r = registry::instance();
+
+    std::lock_guard<std::mutex> lock {r.mutex};
+
+    json::writer w {out};
+
+    w.begin_object()
+      .key("displayTimeUnit").value("ms")
+      .key("traceEvents").begin_array();
+
+    for (auto const& buffer : r.buffers) {
+        w.begin_object()
+          .key("name").value("thread_name")
+          .key("ph").value("M")
+          .key("pid").value(1)
+          .key("tid").value(buffer->id)
+          .key("args").begin_object()
+            .key("name").value(buffer->name.empty()
+              ? "thread " + std::to_string(buffer->id)
+              : buffer->name)
+          .end_object()
+        .end_object();
+
+        auto const count = buffer->count.load(std::memory_order_acquire);
+        // the oldest slot is the next one the thread writes.
+        auto const first = count >= BUFFER_SIZE ? count - BUFFER_SIZE + 1 : 0;
+
+        for (auto i = first; i < count; ++i) {
+            auto const& e = buffer->events[i & (BUFFER_SIZE - 1)];
+
+            auto const name  = e.name.load(std::memory_order_relaxed);
+            auto const begin = e.begin.load(std::memory_order_relaxed);
+            auto const end   = e.end.load(std::memory_order_relaxed);
+
+            // overwritten by the thread while we were reading: once count
+            // reaches i + BUFFER_SIZE, that event may be being written over i.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto const now_count = buffer->count.load(std::memory_order_relaxed);
+            if (i + BUFFER_SIZE <= now_count) {
+                continue;
+            }
+
+            w.begin_object()
+              .key("name").value(name)
+              .key("ph").value("X")
+              .key("pid").value(1)
+              .key("tid").value(buffer->id)
+              .key("ts").value(to_us(begin))
+              .key("dur").value(to_us(end - begin))
+            .end_object();
+        }
+    }
+
+    w.end_array().end_object();
+}
+//==============================================================================
@@ -1,9 +1,10 @@
 #include <bklib/renderer2d.hpp>
+#include <bklib/profiler.hpp>
 
-#if defined(BOOST_OS_WINDOWS)
+#if BOOST_OS_WINDOWS
 #   include <bklib/impl/win/direct2d.hpp>
 #else
-#   error "fill me in"
+#   error "renderer2d is only implemented for Windows"
 #endif
 
 using bklib::renderer2d;
@@ -25,10 +26,12 @@ void renderer2d::set_transform(glm::mat3 const& mat) {
 }
 
 void renderer2d::begin() {
+    BK_PROFILE_ZONE("renderer2d::begin");
     impl_->begin();
 }
 
 void renderer2d::end() {
+    BK_PROFILE_ZONE("renderer2d::end");
     impl_->end();
 }
 
@@ -0,0 +1,399 @@
+#include "task_pool.hpp"
+
+#include <random>
+
+using bklib::task_pool;
+using bklib::task_group;
+using bklib::task_graph;
+
+namespace {
+//==============================================================================
+//! A Chase-Lev work stealing deque; see Le et al., "Correct and Efficient
+//! Work-Stealing for Weak Memory Models".
+//!
+//! Only the owner pushes and pops, at the bottom; anyone may steal from the
+//! top. Buffers replaced by growth are kept until the deque is destroyed,
+//! since a thief may still be reading them.
+//==============================================================================
+template <typename T>
+class work_deque {
+public:
+    explicit work_deque(size_t const capacity = 256)
+    {
+        buffers_.emplace_back(new buffer {capacity});
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    BK_DELETE_ALL(work_deque);
+
+    void push(T* const x) {
+        auto const b = bottom_.load(std::memory_order_relaxed);
+        auto const t = top_.load(std::memory_order_acquire);
+        auto       a = buffer_.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(a->size) - 1) {
+            a = grow_(a, t, b);
+        }
+
+        a->put(b, x);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    //! @returns nullptr if empty.
+    T* pop() {
+        auto const b = bottom_.load(std::memory_order_relaxed) - 1;
+        auto const a = buffer_.load(std::memory_order_relaxed);
+
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto result = a->get(b);
+
+        if (t == b) {
+            // the last element; race any thieves for it.
+            if (!top_.compare_exchange_strong(t, t + 1
+                  , std::memory_order_seq_cst, std::memory_order_relaxed)
+            ) {
+                result = nullptr;
+            }
+
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    //! @returns nullptr if empty or another thread won the race.
+    T* steal() {
+        auto t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto const b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        auto const a      = buffer_.load(std::memory_order_acquire);
+        auto const result = a->get(t);
+
+        if (!top_.compare_exchange_strong(t, t + 1
+              , std::memory_order_seq_cst, std::memory_order_relaxed)
+        ) {
+            return nullptr;
+        }
+
+        return result;
+    }
+private:
+    struct buffer {
+        explicit buffer(size_t const n)
+          : size     {n}
+          , elements {new std::atomic<T*>[n]}
+        {
+            BK_ASSERT(n && !(n & (n - 1)));
+        }
+
+        T* get(int64_t const i) const BK_NOEXCEPT {
+            return elements[static_cast<size_t>(i) & (size - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t const i, T* const x) BK_NOEXCEPT {
+            elements[static_cast<size_t>(i) & (size - 1)].store(x, std::memory_order_relaxed);
+        }
+
+        size_t                             size;
+        std::unique_ptr<std::atomic<T*>[]> elements;
+    };
+
+    buffer* grow_(buffer* const old, int64_t const t, int64_t const b) {
+        buffers_.emplace_back(new buffer {old->size * 2});
+        auto const result = buffers_.back().get();
+
+        for (auto i = t; i < b; ++i) {
+            result->put(i, old->get(i));
+        }
+
+        buffer_.store(result, std::memory_order_release);
+        return result;
+    }
+
+    std::atomic<int64_t>  top_    {0};
+    std::atomic<int64_t>  bottom_ {0};
+    std::atomic<buffer*>  buffer_ {nullptr};
+
+    std::vector<std::unique_ptr<buffer>> buffers_; //!< Owner only.
+};
+
+//! Attempts to find work before a worker goes to sleep.
+static BK_CONSTEXPR int const SPIN_COUNT = 64;
+} //namespace
+
+//==============================================================================
+struct task_pool::task {
+    function    f;
+    task_group* group;
+};
+
+struct task_pool::worker {
+    explicit worker(size_t const index) : index {index}, rng {static_cast<unsigned>(index)} {}
+
+    size_t            index;
+    work_deque<task>  tasks;
+    std::minstd_rand  rng; //!< Victim selection.
+};
+
+namespace {
+//! The pool and worker the current thread belongs to, if any.
+thread_local task_pool const* current_pool   = nullptr;
+thread_local void*            current_worker = nullptr;
+} //namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::task_pool
+////////////////////////////////////////////////////////////////////////////////
+task_pool& task_pool::shared() {
+    static task_pool pool;
+    return pool;
+}
+//==============================================================================
+task_pool::task_pool(size_t workers) {
+    if (workers == 0) {
+        auto const cores = static_cast<size_t>(std::thread::hardware_concurrency());
+        workers = std::max(cores, size_t {2}) - 1;
+    }
+
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back(new worker {i});
+    }
+
+    threads_.reserve(workers);
+    for (auto& w : workers_) {
+        threads_.emplace_back([this, &w] { worker_main_(w.get()); });
+    }
+}
+//==============================================================================
+task_pool::~task_pool() {
+    {
+        std::lock_guard<std::mutex> lock {sleep_mutex_};
+        stop_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+
+    BK_ASSERT(queue_.empty());
+}
+//==============================================================================
+void task_pool::run(task_group& group, function f) {
+    BK_ASSERT(f);
+
+    std::unique_ptr<task> t {new task {std::move(f), &group}};
+
+    group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    if (current_pool == this) {
+        static_cast<worker*>(current_worker)->tasks.push(t.get());
+    } else {
+        std::lock_guard<std::mutex> lock {queue_mutex_};
+        queue_.push_back(t.get());
+    }
+
+    t.release();
+
+    // pairs with the check in worker_main_ so that a wake up is never missed.
+    epoch_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+        std::lock_guard<std::mutex> lock {sleep_mutex_};
+        wake_.notify_one();
+    }
+}
+//==============================================================================
+void task_pool::wait(task_group& group) {
+    auto const self = (current_pool == this)
+      ? static_cast<worker*>(current_worker)
+      : nullptr;
+
+    while (!group.done()) {
+        if (auto const t = find_task_(self)) {
+            execute_(t);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+
+    {
+        std::lock_guard<std::mutex> lock {group.error_mutex_};
+        std::swap(error, group.error_);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+//==============================================================================
+void task_pool::execute_(task* const t) BK_NOEXCEPT {
+    std::unique_ptr<task> const owner {t};
+    auto& group = *t->group;
+
+    try {
+        t->f();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock {group.error_mutex_};
+        if (!group.error_) {
+            group.error_ = std::current_exception();
+        }
+    }
+
+    group.pending_.fetch_sub(1, std::memory_order_release);
+}
+//==============================================================================
+task_pool::task* task_pool::find_task_(worker* const self) {
+    if (self) {
+        if (auto const t = self->tasks.pop()) {
+            return t;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock {queue_mutex_};
+        if (!queue_.empty()) {
+            // oldest first.
+            auto const t = queue_.front();
+            queue_.pop_front();
+            return t;
+        }
+    }
+
+    auto const n = workers_.size();
+    if (n == 0) {
+        return nullptr;
+    }
+
+    // start at a random victim so that thieves spread out.
+    thread_local std::minstd_rand external_rng;
+    auto& rng = self ? self->rng : external_rng;
+    auto const first = static_cast<size_t>(rng()) % n;
+
+    for (size_t i = 0; i < n; ++i) {
+        auto const victim = workers_[(first + i) % n].get();
+        if (victim == self) {
+            continue;
+        }
+
+        if (auto const t = victim->tasks.steal()) {
+            return t;
+        }
+    }
+
+    return nullptr;
+}
+//==============================================================================
+void task_pool::worker_main_(worker* const self) {
+    current_pool   = this;
+    current_worker = self;
+
+    while (!stop_.load(std::memory_order_relaxed)) {
+        auto const epoch = epoch_.load();
+
+        task* t = nullptr;
+        for (int i = 0; i < SPIN_COUNT && !t; ++i) {
+            t = find_task_(self);
+        }
+
+        if (t) {
+            execute_(t);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock {sleep_mutex_};
+
+        ++sleepers_;
+        wake_.wait(lock, [&] {
+            return stop_.load() || epoch_.load() != epoch;
+        });
+        --sleepers_;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// bklib::task_graph
+////////////////////////////////////////////////////////////////////////////////
+void task_graph::run(task_pool& pool) const {
+    auto const n = nodes_.size();
+    if (n == 0) {
+        return;
+    }
+
+    struct state_t {
+        task_graph const&                     graph;
+        task_pool&                            pool;
+        task_group                            group;
+        std::unique_ptr<std::atomic<uint32_t>[]> remaining;
+        std::atomic<bool>                     failed;
+
+        state_t(task_graph const& graph, task_pool& pool, size_t const n)
+          : graph     (graph)
+          , pool      (pool)
+          , remaining {new std::atomic<uint32_t>[n]}
+          , failed    {false}
+        {
+        }
+
+        void execute(node const i) {
+            auto const& v = graph.nodes_[i];
+
+            std::exception_ptr error;
+
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    v.f();
+                } catch (...) {
+                    failed = true;
+                    error  = std::current_exception();
+                }
+            }
+
+            // successors always "run", if only to be skipped, so that the
+            // whole graph completes.
+            for (auto const s : v.successors) {
+                if (remaining[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    pool.run(group, [this, s] { execute(s); });
+                }
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    } state {*this, pool, n};
+
+    std::vector<node> roots;
+    for (size_t i = 0; i < n; ++i) {
+        state.remaining[i].store(nodes_[i].predecessors, std::memory_order_relaxed);
+        if (nodes_[i].predecessors == 0) {
+            roots.push_back(static_cast<node>(i));
+        }
+    }
+
+    BK_ASSERT(!roots.empty()); // a cycle otherwise.
+
+    for (auto const r : roots) {
+        pool.run(state.group, [&state, r] { state.execute(r); });
+    }
+
+    pool.wait(state.group);
+}
+//==============================================================================
@@ -1,5 +1,8 @@
 #include "timekeeper.hpp"
 #include "assert.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
 
 using bklib::timekeeper;
 
@@ -22,15 +25,13 @@ timekeeper::handle timekeeper::register_event_(duration period, callback f) {
     auto const now = clock::now();
     auto const deadline = now + period;
 
-    auto const index = records_.size();
-    timekeeper::handle const handle = { index };
-
-    records_.emplace_back(record {
-        handle, std::move(f), period, deadline
-
+    auto const handle = records_.insert(record {
+        timekeeper::handle {}, std::move(f), period, deadline
     });
 
-    heap_.emplace_back(index);
+    records_[handle].handle = handle;
+
+    heap_.emplace_back(handle);
     std::push_heap(
         std::begin(heap_)
       , std::end(heap_)
@@ -46,6 +47,8 @@ timekeeper::handle timekeeper::register_event_(duration period, callback f) {
 void timekeeper::update() {
     using namespace std::placeholders;
 
+    BK_PROFILE_ZONE("timekeeper::update");
+
     auto const now = clock::now();
     duration   dt  = std::chrono::seconds(1);
 
@@ -71,3 +74,23 @@ void timekeeper::update() {
         );
     }
 }
+//==============================================================================
+//!
+
+//==============================================================================
+bool timekeeper::unregister_event(handle const h) {
+    using namespace std::placeholders;
+
+    if (!records_.erase(h)) {
+        return false;
+    }
+
+    heap_.erase(std::find(std::begin(heap_), std::end(heap_), h));
+    std::make_heap(
+        std::begin(heap_)
+      , std::end(heap_)
+      , std::bind(&timekeeper::heap_predidate_, this, _1, _2)
+    );
+
+    return true;
+}
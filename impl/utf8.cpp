@@ -0,0 +1,344 @@
+#include "utf8.hpp"
+
+#include <cstring>
+
+#if defined(BK_SIMD_AVX2)
+#   include <immintrin.h>
+#elif defined(BK_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+
+using bklib::string_ref;
+using bklib::uint8_t;
+using bklib::uint64_t;
+
+namespace detail = bklib::detail;
+
+namespace {
+//==============================================================================
+using byte_ptr = unsigned char const*;
+
+byte_ptr begin_of(string_ref const str) BK_NOEXCEPT {
+    return reinterpret_cast<byte_ptr>(str.data());
+}
+
+byte_ptr end_of(string_ref const str) BK_NOEXCEPT {
+    return begin_of(str) + str.size();
+}
+//==============================================================================
+//! Eight bytes at a time; used for the tails of the vector loops.
+//==============================================================================
+bool is_ascii_words(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    uint64_t acc {0};
+
+    for (; last - first >= 8; first += 8) {
+        uint64_t word;
+        std::memcpy(&word, first, sizeof(word));
+        acc |= word;
+    }
+
+    for (; first != last; ++first) {
+        acc |= *first;
+    }
+
+    return (acc & 0x8080808080808080ull) == 0;
+}
+//==============================================================================
+//! Validate [first, last) one sequence at a time.
+//==============================================================================
+bool validate_sequences(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    while (first != last) {
+        auto const n = detail::utf8_sequence_length(first, last);
+        if (n == 0) {
+            return false;
+        }
+
+        first += n;
+    }
+
+    return true;
+}
+
+#if defined(BK_SIMD_AVX2)
+//==============================================================================
+// AVX2; 32 bytes per step.
+//
+// The validator classifies each pair of adjacent bytes with three 16 entry
+// lookups (high nibble of the previous byte, low nibble of the previous byte,
+// high nibble of the current byte). The tables are laid out so that the AND
+// of the three lookups is non-zero iff the pair is malformed; the only case a
+// pair can't decide -- whether a continuation is the 3rd or 4th byte of a
+// longer sequence -- is resolved separately from the bytes 2 and 3 back.
+//==============================================================================
+using vec = __m256i;
+
+inline vec splat(uint8_t const x) BK_NOEXCEPT {
+    return _mm256_set1_epi8(static_cast<char>(x));
+}
+
+inline vec load(byte_ptr const p) BK_NOEXCEPT {
+    return _mm256_loadu_si256(reinterpret_cast<vec const*>(p));
+}
+
+//! (v >> 4) per byte.
+inline vec high_nibble(vec const v) BK_NOEXCEPT {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), splat(0x0F));
+}
+
+inline vec low_nibble(vec const v) BK_NOEXCEPT {
+    return _mm256_and_si256(v, splat(0x0F));
+}
+
+//! The byte N positions before each byte of @c v, pulling from @c prev.
+template <int N>
+inline vec prev_bytes(vec const v, vec const prev) BK_NOEXCEPT {
+    return _mm256_alignr_epi8(v, _mm256_permute2x128_si256(prev, v, 0x21), 16 - N);
+}
+
+inline vec lookup16(vec const index
+  , uint8_t t0, uint8_t t1, uint8_t t2,  uint8_t t3,  uint8_t t4,  uint8_t t5,  uint8_t t6,  uint8_t t7
+  , uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11, uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15
+) BK_NOEXCEPT {
+    auto const table = _mm256_setr_epi8(
+        t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15
+      , t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14, t15
+    );
+
+    return _mm256_shuffle_epi8(table, index);
+}
+
+inline bool any_set(vec const v) BK_NOEXCEPT {
+    return !_mm256_testz_si256(v, v);
+}
+
+inline bool any_high_bit(vec const v) BK_NOEXCEPT {
+    return _mm256_movemask_epi8(v) != 0;
+}
+
+//------------------------------------------------------------------------------
+vec check_special_cases(vec const input, vec const prev1) BK_NOEXCEPT {
+    uint8_t const TOO_SHORT  = 1 << 0; // 11______ 0_______ | 11______ 11______
+    uint8_t const TOO_LONG   = 1 << 1; // 0_______ 10______
+    uint8_t const OVERLONG_3 = 1 << 2; // 11100000 100_____
+    uint8_t const TOO_LARGE  = 1 << 3; // 11110100 1001____ | 11110100 101_____ | 11110101+ 10______
+    uint8_t const SURROGATE  = 1 << 4; // 11101101 101_____
+    uint8_t const OVERLONG_2 = 1 << 5; // 1100000_ 10______
+    uint8_t const LARGE_1000 = 1 << 6; // 11110101+ 1000____
+    uint8_t const OVERLONG_4 = 1 << 6; // 11110000 1000____
+    uint8_t const TWO_CONTS  = 1 << 7; // 10______ 10______
+
+    uint8_t const CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    auto const byte_1_high = lookup16(high_nibble(prev1)
+      , TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG
+      , TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG
+      , TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS
+      , TOO_SHORT | OVERLONG_2
+      , TOO_SHORT
+      , TOO_SHORT | OVERLONG_3 | SURROGATE
+      , TOO_SHORT | TOO_LARGE | LARGE_1000 | OVERLONG_4
+    );
+
+    auto const byte_1_low = lookup16(low_nibble(prev1)
+      , CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4
+      , CARRY | OVERLONG_2
+      , CARRY
+      , CARRY
+      , CARRY | TOO_LARGE
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000 | SURROGATE
+      , CARRY | TOO_LARGE | LARGE_1000
+      , CARRY | TOO_LARGE | LARGE_1000
+    );
+
+    auto const byte_2_high = lookup16(high_nibble(input)
+      , TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+      , TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+      , TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | LARGE_1000 | OVERLONG_4
+      , TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE
+      , TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE
+      , TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE
+      , TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    );
+
+    return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+}
+//------------------------------------------------------------------------------
+vec check_multibyte_lengths(vec const input, vec const prev_input, vec const special) BK_NOEXCEPT {
+    auto const prev2 = prev_bytes<2>(input, prev_input);
+    auto const prev3 = prev_bytes<3>(input, prev_input);
+
+    // only 111_____ and 1111____ respectively end up >= 0x80.
+    auto const is_third  = _mm256_subs_epu8(prev2, splat(0xE0 - 0x80));
+    auto const is_fourth = _mm256_subs_epu8(prev3, splat(0xF0 - 0x80));
+
+    auto const must_be_cont = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), splat(0x80));
+
+    return _mm256_xor_si256(must_be_cont, special);
+}
+//------------------------------------------------------------------------------
+//! Non-zero where the block ends part way through a sequence.
+vec is_incomplete(vec const input) BK_NOEXCEPT {
+    auto const max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+      , -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+      , static_cast<char>(0xF0 - 1)
+      , static_cast<char>(0xE0 - 1)
+      , static_cast<char>(0xC0 - 1)
+    );
+
+    return _mm256_subs_epu8(input, max);
+}
+//------------------------------------------------------------------------------
+bool is_ascii_simd(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    for (; last - first >= 128; first += 128) {
+        auto const a = _mm256_or_si256(load(first +  0), load(first + 32));
+        auto const b = _mm256_or_si256(load(first + 64), load(first + 96));
+        if (any_high_bit(_mm256_or_si256(a, b))) return false;
+    }
+
+    for (; last - first >= 32; first += 32) {
+        if (any_high_bit(load(first))) return false;
+    }
+
+    return is_ascii_words(first, last);
+}
+//------------------------------------------------------------------------------
+bool validate_utf8_simd(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    auto error      = _mm256_setzero_si256();
+    auto prev_input = _mm256_setzero_si256();
+    auto prev_incomplete = _mm256_setzero_si256();
+
+    auto const step = [&](vec const input) {
+        if (!any_high_bit(input)) {
+            error = _mm256_or_si256(error, prev_incomplete);
+        } else {
+            auto const prev1   = prev_bytes<1>(input, prev_input);
+            auto const special = check_special_cases(input, prev1);
+
+            error = _mm256_or_si256(error, check_multibyte_lengths(input, prev_input, special));
+            prev_incomplete = is_incomplete(input);
+        }
+
+        prev_input = input;
+    };
+
+    for (; last - first >= 32; first += 32) {
+        step(load(first));
+
+        if (any_set(error)) {
+            return false;
+        }
+    }
+
+    // zero padding is ASCII, so a truncated trailing sequence is still caught.
+    // first is null for empty input, which memcpy must not be given.
+    alignas(32) unsigned char tail[32] = {};
+    if (last != first) {
+        std::memcpy(tail, first, static_cast<size_t>(last - first));
+    }
+
+    step(load(tail));
+    error = _mm256_or_si256(error, prev_incomplete);
+
+    return !any_set(error);
+}
+
+#elif defined(BK_SIMD_SSE2)
+//==============================================================================
+// SSE2; 16 bytes per step.
+//
+// SSE2 has no byte shuffle to drive the table lookups, so 16 byte blocks of
+// ASCII are skipped with a single compare and anything else is validated one
+// sequence at a time.
+//==============================================================================
+using vec = __m128i;
+
+inline vec load(byte_ptr const p) BK_NOEXCEPT {
+    return _mm_loadu_si128(reinterpret_cast<vec const*>(p));
+}
+
+inline bool any_high_bit(vec const v) BK_NOEXCEPT {
+    return _mm_movemask_epi8(v) != 0;
+}
+//------------------------------------------------------------------------------
+bool is_ascii_simd(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    for (; last - first >= 64; first += 64) {
+        auto const a = _mm_or_si128(load(first +  0), load(first + 16));
+        auto const b = _mm_or_si128(load(first + 32), load(first + 48));
+        if (any_high_bit(_mm_or_si128(a, b))) return false;
+    }
+
+    for (; last - first >= 16; first += 16) {
+        if (any_high_bit(load(first))) return false;
+    }
+
+    return is_ascii_words(first, last);
+}
+//------------------------------------------------------------------------------
+bool validate_utf8_simd(byte_ptr first, byte_ptr const last) BK_NOEXCEPT {
+    while (last - first >= 16) {
+        auto const mask = _mm_movemask_epi8(load(first));
+        if (mask == 0) {
+            first += 16;
+            continue;
+        }
+
+        // skip the ASCII prefix, then validate up to the end of the block;
+        // a sequence may run over into the next block.
+        auto const block_end = first + 16;
+
+        first += [mask] {
+            int i = 0;
+            while (!(mask & (1 << i))) ++i;
+            return i;
+        }();
+
+        while (first < block_end) {
+            auto const n = detail::utf8_sequence_length(first, last);
+            if (n == 0) {
+                return false;
+            }
+
+            first += n;
+        }
+    }
+
+    return validate_sequences(first, last);
+}
+#endif
+
+} //namespace
+
+//==============================================================================
+bool detail::is_ascii_scalar(string_ref const str) BK_NOEXCEPT {
+    return is_ascii_words(begin_of(str), end_of(str));
+}
+//==============================================================================
+bool detail::validate_utf8_scalar(string_ref const str) BK_NOEXCEPT {
+    return validate_sequences(begin_of(str), end_of(str));
+}
+//==============================================================================
+bool bklib::is_ascii(string_ref const str) BK_NOEXCEPT {
+#if defined(BK_SIMD_AVX2) || defined(BK_SIMD_SSE2)
+    return is_ascii_simd(begin_of(str), end_of(str));
+#else
+    return detail::is_ascii_scalar(str);
+#endif
+}
+//==============================================================================
+bool bklib::validate_utf8(string_ref const str) BK_NOEXCEPT {
+#if defined(BK_SIMD_AVX2) || defined(BK_SIMD_SSE2)
+    return validate_utf8_simd(begin_of(str), end_of(str));
+#else
+    return detail::validate_utf8_scalar(str);
+#endif
+}
+//==============================================================================
@@ -1,4 +1,5 @@
 #include "direct2d.hpp"
+#include "mapped_file.hpp"
 
 using bklib::platform_window_handle;
 using bklib::detail::make_com_error;
@@ -83,22 +84,35 @@ auto create_brush(ID2D1HwndRenderTarget& target) {
     return com_ptr<ID2D1SolidColorBrush>(brush);
 }
 //------------------------------------------------------------------------------
-auto create_decoder_from_file(
+//! Decode from memory, e.g. a mapped_file; @c data must outlive the decoder.
+auto create_decoder_from_memory(
     IWICImagingFactory& factory
-  , std::wstring const& file_name
+  , bklib::string_ref const data
 ) {
+    auto stream = [&] {
+        IWICStream* stream = nullptr;
+        auto const hr = factory.CreateStream(&stream);
+        BK_COM_THROW_IF_FAILED("IWICImagingFactory::CreateStream", hr);
+        return make_com_ptr(stream);
+    }();
+
+    auto hr = stream->InitializeFromMemory(
+        reinterpret_cast<BYTE*>(const_cast<char*>(data.data()))
+      , static_cast<DWORD>(data.size())
+    );
+    BK_COM_THROW_IF_FAILED("IWICStream::InitializeFromMemory", hr);
+
     IWICBitmapDecoder* decoder = nullptr;
 
-    auto const hr = factory.CreateDecoderFromFilename(
-        file_name.data(),
+    hr = factory.CreateDecoderFromStream(
+        stream.get(),
         nullptr,
-        GENERIC_READ,
         WICDecodeMetadataCacheOnLoad,
         &decoder
     );
 
     if (FAILED(hr)) {
-        make_com_error("IWICImagingFactory::CreateDecoderFromFilename", hr);
+        make_com_error("IWICImagingFactory::CreateDecoderFromStream", hr);
     }
 
     return com_ptr<IWICBitmapDecoder>(decoder);
@@ -115,9 +129,11 @@ impl_t::impl_t(platform_window_handle handle)
 }
 
 com_ptr<ID2D1Bitmap> impl_t::load_image() {
-    wchar_t const file_name[] = L"./data/tiles.png";
+    // the pixels are decoded from the mapping; it must outlive the bitmap's creation.
+    bklib::mapped_file const file {"./data/tiles.png"};
+    file.all().advise(bklib::access_hint::sequential);
 
-    auto decoder = create_decoder_from_file(*wic_factory_, file_name);
+    auto decoder = create_decoder_from_memory(*wic_factory_, file.str());
 
     auto source = [&] {
         IWICBitmapFrameDecode* source = nullptr;
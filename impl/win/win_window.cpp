@@ -1,6 +1,7 @@
 #include "win_window.hpp"
 #include "util.hpp"
 #include "scope_exit.hpp"
+#include "profiler.hpp"
 
 #define BK_WM_ASSOCIATE_TSF (WM_APP + 1)
 
@@ -19,6 +20,7 @@ using bklib::detail::make_windows_error;
 //------------------------------------------------------------------------------
 window_impl::work_queue window_impl::windows_queue_  { };
 window_impl::work_queue window_impl::client_queue_   { };
+bklib::hdr_histogram    window_impl::client_queue_depth_;
 DWORD                   window_impl::thread_id_      {0};
 platform_window::state  window_impl::state_          {platform_window::state::starting};
 std::promise<bool>      window_impl::windows_result_ { };
@@ -169,7 +171,7 @@ void window_impl::push_work_item_(work_item item) {
 }
 //------------------------------------------------------------------------------
 void window_impl::push_event_item_(work_item item) {
-    client_queue_.push(std::move(item));
+    client_queue_depth_.record(client_queue_.push(std::move(item)));
 }
 //------------------------------------------------------------------------------
 void window_impl::init_() {
@@ -198,6 +200,7 @@ try {
     });
 
     init_com();
+    bklib::profiler::set_thread_name("window");
 
     MSG msg {0};
 
@@ -326,6 +329,8 @@ void window_impl::handle_raw_mouse_(
     raw_mouse const&        mouse
   , bklib::time_point const when
 ) {
+    record_latency_(bklib::input_event::raw_mouse, when);
+
     if (mouse.has_movement()) {
         mouse_state_.push_relative(mouse.x(), mouse.y(), when);
         if (on_mouse_move_) {
@@ -340,15 +345,19 @@ void window_impl::handle_raw_mouse_(
 
         for (size_t i = 0; i < raw_mouse::BUTTON_COUNT; ++i) {
             switch (mouse[i]) {
-            case raw_mouse::button_state::went_down :
-                mouse_state_.set_button(i, when, true);
+            case raw_mouse::button_state::went_down : {
+                auto const b = mouse_state_.set_button(i, when, true);
                 if (on_mouse_down_) on_mouse_down_(mouse_state_, x, y, i);
+                if (b.clicks == 2 && on_mouse_dbl_click_) on_mouse_dbl_click_(mouse_state_, i);
                 break;
-            case raw_mouse::button_state::went_up :
-                mouse_state_.set_button(i, when, false);
+            }
+            case raw_mouse::button_state::went_up : {
+                auto const b = mouse_state_.set_button(i, when, false);
                 if (on_mouse_up_) on_mouse_up_(mouse_state_, x, y, i);
+                if (!b.dragging && on_mouse_click_) on_mouse_click_(mouse_state_, i);
                 break;
             }
+            }
         }
     }
 
@@ -361,6 +370,8 @@ void window_impl::handle_raw_keyboard_(
     raw_keyboard const&     keyboard
   , bklib::time_point const when
 ) {
+    record_latency_(bklib::input_event::keyboard, when);
+
     auto const went_down = keyboard.went_down();
     auto const key       = keyboard.key();
 
@@ -432,6 +443,7 @@ LRESULT window_impl::local_wnd_proc_(
         auto const time = clock_t::now();
 
         push_event_item_([=] {
+            record_latency_(bklib::input_event::mouse_move, time);
             mouse_state_.push_absolute(x, y, time);
 
             if (on_mouse_move_to_) {
@@ -542,18 +554,65 @@ window_impl::impl_t_()
 
     ::UpdateWindow(handle());
     ::ShowWindow(handle(), SW_SHOWDEFAULT);
+
+    // use the user's settings for clicks, drags and hovering.
+    auto gestures = mouse_state_.get_gesture_settings();
+
+    gestures.double_click_time     = std::chrono::milliseconds {::GetDoubleClickTime()};
+    gestures.double_click_distance = ::GetSystemMetrics(SM_CXDOUBLECLK) / 2;
+    gestures.drag_distance         = ::GetSystemMetrics(SM_CXDRAG) / 2;
+
+    UINT hover_time = 0;
+    if (::SystemParametersInfoW(SPI_GETMOUSEHOVERTIME, 0, &hover_time, 0)) {
+        gestures.hover_time = std::chrono::milliseconds {hover_time};
+    }
+
+    mouse_state_.set_gesture_settings(gestures);
 }
 //------------------------------------------------------------------------------
 void window_impl::do_events() {
+    BK_PROFILE_ZONE("window::do_events");
+
     while (!client_queue_.is_empty()) {
         client_queue_.pop()();
     }
+
+    if (mouse_state_.update_hover(clock_t::now()) && on_mouse_hover_) {
+        on_mouse_hover_(mouse_state_);
+    }
 }
 //------------------------------------------------------------------------------
 bklib::platform_window_handle window_impl::get_handle() const {
     return {handle()};
 }
 //------------------------------------------------------------------------------
+void window_impl::record_latency_(
+    bklib::input_event const type
+  , bklib::time_point  const when
+) BK_NOEXCEPT {
+    auto const latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        bklib::clock_t::now() - when).count();
+
+    latency_[static_cast<size_t>(type)].record(
+        latency > 0 ? static_cast<uint64_t>(latency) : 0);
+}
+//------------------------------------------------------------------------------
+bklib::input_statistics window_impl::get_input_statistics(bool const reset) {
+    bklib::input_statistics result;
+
+    for (size_t i = 0; i < bklib::INPUT_EVENT_TYPES; ++i) {
+        result.latency[i] = reset
+          ? latency_[i].snapshot_and_reset()
+          : latency_[i].snapshot();
+    }
+
+    result.queue_depth = reset
+      ? client_queue_depth_.snapshot_and_reset()
+      : client_queue_depth_.snapshot();
+
+    return result;
+}
+//------------------------------------------------------------------------------
 void window_impl::shutdown() {
     push_work_item_([] {
         ::PostQuitMessage(0);
@@ -572,6 +631,9 @@ BK_DEFINE_EVENT(on_resize);
 //------------------------------------------------------------------------------
 void window_impl::listen(bklib::on_mouse_enter   callback) {}
 void window_impl::listen(bklib::on_mouse_exit    callback) {}
+BK_DEFINE_EVENT(on_mouse_hover);
+BK_DEFINE_EVENT(on_mouse_click);
+BK_DEFINE_EVENT(on_mouse_dbl_click);
 BK_DEFINE_EVENT(on_mouse_move);
 BK_DEFINE_EVENT(on_mouse_move_to);
 BK_DEFINE_EVENT(on_mouse_down);
@@ -153,6 +153,8 @@ public:
 
     platform_window_handle get_handle() const;
 
+    input_statistics get_input_statistics(bool reset);
+
     //--------------------------------------------------------------------------
     void listen(on_create        callback);
     void listen(on_paint         callback);
@@ -161,6 +163,9 @@ public:
     //--------------------------------------------------------------------------
     void listen(on_mouse_enter   callback);
     void listen(on_mouse_exit    callback);
+    void listen(on_mouse_hover   callback);
+    void listen(on_mouse_click   callback);
+    void listen(on_mouse_dbl_click callback);
     void listen(on_mouse_move    callback);
     void listen(on_mouse_move_to callback);
     void listen(on_mouse_down    callback);
@@ -183,6 +188,9 @@ private:
     on_close         on_close_;
     on_resize        on_resize_;
     //--------------------------------------------------------------------------
+    on_mouse_hover     on_mouse_hover_;
+    on_mouse_click     on_mouse_click_;
+    on_mouse_dbl_click on_mouse_dbl_click_;
     on_mouse_move_to on_mouse_move_to_;
     on_mouse_move    on_mouse_move_;
     on_mouse_down    on_mouse_down_;
@@ -201,6 +209,12 @@ private:
 
     void handle_raw_mouse_(detail::raw_mouse const& mouse, time_point when);
     void handle_raw_keyboard_(detail::raw_keyboard const& keyboard, time_point when);
+
+    //! Record the latency of an event captured at @c when; called as its
+    //! callbacks are dispatched.
+    void record_latency_(input_event type, time_point when) BK_NOEXCEPT;
+
+    std::array<hdr_histogram, INPUT_EVENT_TYPES> latency_;
 private:
     static LRESULT CALLBACK wnd_proc_(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) BK_NOEXCEPT;
     static HWND create_window_(impl_t_* win);
@@ -215,6 +229,7 @@ private:
 
     static work_queue         windows_queue_;
     static work_queue         client_queue_;
+    static hdr_histogram      client_queue_depth_;
     static DWORD              thread_id_;
     static state              state_;
     static std::promise<bool> windows_result_;
@@ -1,9 +1,9 @@
 #include "window.hpp"
 
-#if defined (BOOST_OS_WINDOWS)
+#if BOOST_OS_WINDOWS
 #   include "impl/win/win_window.hpp"
 #else
-#   error "fill me in"
+#   error "platform_window is only implemented for Windows"
 #endif
 
 using bklib::platform_window;
@@ -40,6 +40,10 @@ platform_window_handle platform_window::get_handle() const {
     return impl_->get_handle();
 }
 
+bklib::input_statistics platform_window::get_input_statistics(bool const reset) {
+    return impl_->get_input_statistics(reset);
+}
+
 #define BK_DEFINE_EVENT(EVENT)\
 void platform_window::listen(EVENT callback) {\
     impl_->listen(callback);\
@@ -51,6 +55,9 @@ BK_DEFINE_EVENT(bklib::on_close)
 BK_DEFINE_EVENT(bklib::on_resize)
 BK_DEFINE_EVENT(bklib::on_mouse_enter)
 BK_DEFINE_EVENT(bklib::on_mouse_exit)
+BK_DEFINE_EVENT(bklib::on_mouse_hover)
+BK_DEFINE_EVENT(bklib::on_mouse_click)
+BK_DEFINE_EVENT(bklib::on_mouse_dbl_click)
 BK_DEFINE_EVENT(bklib::on_mouse_move)
 BK_DEFINE_EVENT(bklib::on_mouse_move_to)
 BK_DEFINE_EVENT(bklib::on_mouse_down)
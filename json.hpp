@@ -2,12 +2,21 @@
 
 #include <type_traits>
 #include <ostream>
-
-#include <jsoncpp/json.h>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <exception>
+#include <algorithm>
 
 #include "types.hpp"
 #include "exception.hpp"
 #include "json_forward.hpp"
+#include "json_reader.hpp"
+#include "json_arena.hpp"
+#include "json_expected.hpp"
+#include "assert.hpp"
+#include "task_pool.hpp"
 
 namespace bklib {
 namespace json {
@@ -21,12 +30,175 @@ struct type_info {
     json::type type;
 };
 //==============================================================================
+//! Non-owning view of a value in a json::document.
+//!
+//! Values are nodes in the document's arena (@see json_arena.hpp); strings are
+//! views into the source or, if they contained escape sequences, into the
+//! arena. A default constructed value_ref refers to no value and behaves as
+//! null.
+//==============================================================================
+class value_ref {
+public:
+    class iterator;
+
+    value_ref() = default;
+
+    explicit value_ref(detail::node const* const node) BK_NOEXCEPT
+      : node_ {node}
+    {
+    }
+
+    //! False if this refers to no value; e.g. the result of a failed find().
+    explicit operator bool() const BK_NOEXCEPT { return node_ != nullptr; }
+
+    json::type type() const BK_NOEXCEPT { return node_ ? node_->type : type::null; }
+
+    bool is_null()     const BK_NOEXCEPT { return type() == type::null; }
+    bool is_object()   const BK_NOEXCEPT { return type() == type::object; }
+    bool is_array()    const BK_NOEXCEPT { return type() == type::array; }
+    bool is_string()   const BK_NOEXCEPT { return type() == type::string; }
+    bool is_bool()     const BK_NOEXCEPT { return type() == type::boolean; }
+    bool is_number()   const BK_NOEXCEPT {
+        return type() == type::signed_int || type() == type::unsigned_int || type() == type::real;
+    }
+    bool is_integral() const BK_NOEXCEPT {
+        return node_ && (node_->flags & detail::node::flag_integral);
+    }
+
+    //! Number of elements or members; 0 for other types. O(1).
+    size_t size() const BK_NOEXCEPT {
+        return (is_array() || is_object()) ? node_->size : 0;
+    }
+
+    //! @pre is_array(). @returns The element at index or a null value_ref. O(1).
+    value_ref operator[](size_t const index) const BK_NOEXCEPT {
+        BK_ASSERT(is_array());
+        return index < node_->size ? value_ref{node_->first_child() + index} : value_ref{};
+    }
+
+    //! @pre is_object(). @returns The member named @c key or a null value_ref.
+    //! A single probe of the hash index for large objects; a binary search of
+    //! the (sorted) members otherwise.
+    value_ref find(string_ref key) const BK_NOEXCEPT;
+
+    //! The text of a scalar; for strings the decoded contents. Empty for
+    //! arrays and objects.
+    string_ref raw() const BK_NOEXCEPT;
+
+    //! Whether a string value contained escape sequences in the source.
+    bool has_escapes() const BK_NOEXCEPT {
+        return node_ && (node_->flags & detail::node::flag_escaped);
+    }
+
+    //! @pre is_string().
+    utf8string as_string() const {
+        BK_ASSERT(is_string());
+        return raw().to_string();
+    }
+
+    //! @pre is_integral().
+    //! @returns false if the value does not fit in @c out.
+    bool as_int(int64_t& out) const BK_NOEXCEPT;
+    //! @pre is_number().
+    //! Independent of the global locale; does not allocate for any number
+    //! shorter than 128 characters.
+    double as_double() const;
+    //! @pre is_bool().
+    bool as_bool() const BK_NOEXCEPT { return node_->text[0] == 't'; }
+
+    //! Iteration over array elements or object members, the latter sorted by
+    //! name; empty for other types.
+    iterator begin() const BK_NOEXCEPT;
+    iterator end() const BK_NOEXCEPT;
+private:
+    detail::node const* node_ = nullptr;
+};
+//==============================================================================
+//! Forward iterator over the elements of an array or the members of an
+//! object.
+//==============================================================================
+class value_ref::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = value_ref;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = value_ref const*;
+    using reference         = value_ref;
+
+    iterator() = default;
+
+    iterator(detail::node const* const pos, bool const is_object) BK_NOEXCEPT
+      : pos_ {pos}, is_object_ {is_object}
+    {
+    }
+
+    //! The (decoded) name of the current member.
+    //! @pre The iterated value is an object.
+    string_ref key() const BK_NOEXCEPT {
+        BK_ASSERT(is_object_);
+        return pos_->str();
+    }
+
+    //! A member's value follows its name.
+    value_ref operator*() const BK_NOEXCEPT {
+        return value_ref{is_object_ ? pos_ + 1 : pos_};
+    }
+
+    iterator& operator++() BK_NOEXCEPT {
+        pos_ += is_object_ ? 2 : 1;
+        return *this;
+    }
+
+    iterator operator++(int) BK_NOEXCEPT {
+        auto result = *this;
+        ++(*this);
+        return result;
+    }
+
+    bool operator==(iterator const& rhs) const BK_NOEXCEPT { return pos_ == rhs.pos_; }
+    bool operator!=(iterator const& rhs) const BK_NOEXCEPT { return pos_ != rhs.pos_; }
+private:
+    detail::node const* pos_       = nullptr; //!< Element or member name.
+    bool                is_object_ = false;
+};
+//==============================================================================
+//! A validated, immutable json text.
+//!
+//! Construction validates the encoding and grammar of the entire source once
+//! and lays its values out in a single arena; values are then read through
+//! root(). The non-owning constructor can be given any buffer, including a
+//! memory mapped file, that outlives the document. Moving a document does not
+//! invalidate value_refs into it.
+//!
+//! @throws json::error::parse_error if the source is not well formed.
+//==============================================================================
+class document {
+public:
+    document() = default;
+
+    explicit document(string_ref source);
+    explicit document(utf8string&& source);
+
+    value_ref root() const BK_NOEXCEPT {
+        return arena_ ? value_ref{arena_->root()} : value_ref{};
+    }
+
+    string_ref source() const BK_NOEXCEPT {
+        return arena_ ? arena_->text : string_ref{};
+    }
+private:
+    void build_();
+
+    std::unique_ptr<detail::arena> arena_;
+};
+//==============================================================================
 namespace error {
-    struct base      : virtual bklib::exception_base {};
-    struct bad_type  : virtual base {};
-    struct bad_size  : virtual base {};
-    struct bad_index : virtual base {};
-    struct bad_value : virtual base {};
+    struct base        : virtual bklib::exception_base {};
+    struct bad_type    : virtual base {};
+    struct bad_size    : virtual base {};
+    struct bad_index   : virtual base {};
+    struct bad_value   : virtual base {};
+    struct parse_error : virtual base {};
 
     namespace detail {
         using size_pair = std::pair<size_t, size_t>;
@@ -39,6 +211,8 @@ namespace error {
     BK_DEFINE_EXCEPTION_INFO(info_index,         index);
     BK_DEFINE_EXCEPTION_INFO(info_rule_trace,    std::vector<bklib::string_ref>);
     BK_DEFINE_EXCEPTION_INFO(info_value,         bklib::utf8string);
+    BK_DEFINE_EXCEPTION_INFO(info_offset,        size_t);
+    BK_DEFINE_EXCEPTION_INFO(info_reason,        bklib::string_ref);
 
     bad_type make_bad_type(type expected, type actual);
 
@@ -49,6 +223,14 @@ namespace error {
 
 #define BK_JSON_ADD_TRACE(E) ::bklib::json::error::add_rule_exception_info(E, __func__); throw
 
+//==============================================================================
+//! Parse @c source.
+//! @throws json::error::parse_error if the source is not well formed.
+//==============================================================================
+inline document parse(string_ref const source) {
+    return document{source};
+}
+
 cref_wrapped require_size(cref json, size_t min, size_t max);
 
 inline cref_wrapped require_size(cref json, size_t size) {
@@ -56,47 +238,109 @@ inline cref_wrapped require_size(cref json, size_t size) {
 }
 
 //==============================================================================
-//! @throws json::error::bad_type if !json.isArray().
+//! @throws json::error::bad_type if !json.is_array().
 //! @return json
 //==============================================================================
 cref_wrapped require_array(cref json);
 //==============================================================================
-//! @throws json::error::bad_type if !json.isObject().
+//! @throws json::error::bad_type if !json.is_object().
 //! @return json
 //==============================================================================
 cref_wrapped require_object(cref json);
 //==============================================================================
-//! @pre json.isObject().
+//! @pre json.is_object().
 //! @throws json::error::bad_index if @c index is invalid.
 //! @return A @c cref to the value at @c index.
 //==============================================================================
-cref_wrapped require_key(cref json, char const* index);
+cref_wrapped require_key(cref json, string_ref index);
 
-inline cref_wrapped require_key(cref json, utf8string const& index) {
-    return require_key(json, index.c_str());
+inline cref_wrapped require_key(cref json, char const* index) {
+    return require_key(json, string_ref{index});
 }
 
-inline cref_wrapped require_key(cref json, string_ref index) {
-    return require_key(json, index.data());
+inline cref_wrapped require_key(cref json, utf8string const& index) {
+    return require_key(json, string_ref{index});
 }
 
 //==============================================================================
-//! @pre json.isArray().
+//! @pre json.is_array().
 //! @throws json::error::bad_index if @c index is invalid.
 //! @return A @c cref to the value at @c index.
 //==============================================================================
 cref_wrapped require_key(cref json, size_t index);
 //==============================================================================
-//! @throws json::error::bad_type if @c !json.isString().
+//! @throws json::error::bad_type if @c !json.is_string().
 //! @return @c json as a string.
 //==============================================================================
 utf8string require_string(cref json);
 //==============================================================================
-
+//! @throws json::error::bad_type if @c !json.is_string().
+//! @return A view of the (decoded) string; valid as long as the document.
+//==============================================================================
+string_ref require_string_ref(cref json);
+//==============================================================================
+//! @throws json::error::bad_type if @c !json.is_integral().
+//! @throws json::error::bad_value if the value does not fit in an int.
+//==============================================================================
 int require_int(cref json);
 
 cref_wrapped optional_key(cref json, size_t index);
 
+//==============================================================================
+// Exception free versions of the require_* functions; each fails in the same
+// way its counterpart throws. @see json_expected.hpp
+//==============================================================================
+expected<cref> try_size(cref json, size_t min, size_t max) BK_NOEXCEPT;
+
+inline expected<cref> try_size(cref json, size_t const size) BK_NOEXCEPT {
+    return try_size(json, size, size);
+}
+
+expected<cref> try_array(cref json) BK_NOEXCEPT;
+expected<cref> try_object(cref json) BK_NOEXCEPT;
+
+//! Unlike require_key, fails with bad_type if @c json is not an object.
+expected<cref> try_key(cref json, string_ref index) BK_NOEXCEPT;
+//! Unlike require_key, fails with bad_type if @c json is not an array.
+expected<cref> try_key(cref json, size_t index) BK_NOEXCEPT;
+
+expected<utf8string> try_string(cref json);
+expected<string_ref> try_string_ref(cref json) BK_NOEXCEPT;
+expected<int>        try_int(cref json) BK_NOEXCEPT;
+
+//==============================================================================
+//! An error_record and the array element it came from.
+//==============================================================================
+struct element_error {
+    size_t       index;
+    error_record error;
+};
+
+//==============================================================================
+//! Apply @c action to each array element in @c json. @c action returns an
+//! error_record, which is falsy on success; failures are appended to
+//! @c errors and iteration continues.
+//!
+//! @returns A bad_type error_record if !json.is_array(); otherwise a falsy one.
+//==============================================================================
+template <typename F>
+error_record for_each_element_try(cref json, F&& action, std::vector<element_error>& errors) {
+    if (!json.is_array()) {
+        return error_record::make_bad_type(type::array, json.type());
+    }
+
+    size_t i = 0;
+    for (auto const element : json) {
+        auto const result = action(element);
+        if (result) {
+            errors.push_back(element_error {i, result});
+        }
+
+        ++i;
+    }
+
+    return error_record {};
+}
 
 namespace detail {
     void for_each_element_skip_on_fail_on_fail_(
@@ -110,20 +354,145 @@ namespace detail {
 //! @action to each element. If @c action fails due to a json related error, the
 //! error is logged and iteration continues at the next element.
 //!
-//! @throws json::error::bad_type if !json.isArray().
+//! @throws json::error::bad_type if !json.is_array().
 //==============================================================================
 template <typename F>
 void for_each_element_skip_on_fail(cref json, F&& action) {
     json::require_array(json);
 
-    auto const size = json.size();
-    for (size_t i = 0; i < size; ++i) {
+    size_t i = 0;
+    for (auto const element : json) {
         try {
-            action(require_key(json, i));
+            action(element);
         } catch (error::base const& e) {
             detail::for_each_element_skip_on_fail_on_fail_(e, i);
         }
+
+        ++i;
+    }
+}
+
+namespace detail {
+    //! A json error thrown by the action of parallel_for_each_element.
+    struct element_failure {
+        size_t             index;
+        std::exception_ptr error;
+    };
+
+    template <typename Result>
+    struct element_chunk {
+        Result                       result;
+        std::vector<element_failure> failures;
+        std::exception_ptr           fatal; //!< Any other exception.
+    };
+
+    //! Log the json error held by @c failure as for_each_element_skip_on_fail.
+    void log_element_failure(element_failure const& failure);
+
+    //! Elements below which a chunk is not worth a thread.
+    static BK_CONSTEXPR size_t const MIN_ELEMENT_CHUNK = 256;
+} //namespace detail
+
+//==============================================================================
+//! A parallel for_each_element_skip_on_fail that also combines the results of
+//! @c action.
+//!
+//! The array is split into chunks which are processed by up to @c concurrency
+//! threads of task_pool::shared() (the calling thread included; 0 for all of
+//! them). @c action must be safe to call concurrently. Each result of
+//! @c action is combined, in element order, by @c reduce, which must be
+//! associative with @c init as its identity; elements that fail contribute
+//! nothing. json related failures are logged after all elements have been
+//! processed, in element order, so the log does not depend on scheduling.
+//!
+//! @throws json::error::bad_type if !json.is_array().
+//! @throws Any other exception thrown by @c action, or any thrown by
+//!         @c reduce; that of the earliest chunk is rethrown once all threads
+//!         have finished.
+//==============================================================================
+template <typename Result, typename F, typename Reducer>
+Result parallel_for_each_element(
+    cref     json
+  , Result   init
+  , F&&      action
+  , Reducer&& reduce
+  , size_t   concurrency = 0
+) {
+    json::require_array(json);
+
+    auto const size = json.size();
+    if (size == 0) {
+        return init;
+    }
+
+    auto& pool = task_pool::shared();
+
+    if (concurrency == 0) {
+        concurrency = pool.size() + 1;
+    }
+
+    // more chunks than threads to balance uneven elements.
+    auto const max_chunks = (size + detail::MIN_ELEMENT_CHUNK - 1) / detail::MIN_ELEMENT_CHUNK;
+    auto const chunks     = std::min(max_chunks, concurrency * 4);
+    auto const threads    = std::min(chunks, concurrency);
+
+    std::vector<detail::element_chunk<Result>> results(chunks, detail::element_chunk<Result> {init, {}, {}});
+    std::atomic<size_t> next_chunk {0};
+
+    auto const work = [&] {
+        for (auto c = next_chunk++; c < chunks; c = next_chunk++) {
+            auto&      chunk = results[c];
+            auto const first = size * c / chunks;
+            auto const last  = size * (c + 1) / chunks;
+
+            for (auto i = first; i < last; ++i) {
+                try {
+                    auto value = action(json[i]);
+
+                    // a json error of reduce is not that of the element.
+                    try {
+                        chunk.result = reduce(std::move(chunk.result), std::move(value));
+                    } catch (...) {
+                        chunk.fatal = std::current_exception();
+                        break;
+                    }
+                } catch (error::base const&) {
+                    chunk.failures.push_back(detail::element_failure {i, std::current_exception()});
+                } catch (...) {
+                    chunk.fatal = std::current_exception();
+                    break;
+                }
+            }
+        }
+    };
+
+    {
+        // work() catches everything itself.
+        task_group group;
+
+        for (size_t t = 1; t < threads; ++t) {
+            pool.run(group, work);
+        }
+
+        work();
+        pool.wait(group);
     }
+
+    auto result = std::move(init);
+
+    for (auto& chunk : results) {
+        for (auto const& failure : chunk.failures) {
+            detail::log_element_failure(failure);
+        }
+
+        if (chunk.fatal) {
+            std::rethrow_exception(chunk.fatal);
+        }
+
+        result = reduce(std::move(result), std::move(chunk.result));
+    }
+
+    return result;
 }
 //==============================================================================
 
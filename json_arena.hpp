@@ -0,0 +1,110 @@
+//==============================================================================
+//! Arena layout of a parsed json::document.
+//!
+//! Once the structural tape (@see json_index.hpp) has been checked it is
+//! converted into an immutable array of 16 byte nodes held, together with the
+//! hash indices of large objects and any decoded strings, in a single
+//! allocation. The children of each container are contiguous, so indexing an
+//! array is O(1); object members are sorted by name and objects with more than
+//! HASH_THRESHOLD members also get an open addressed hash index.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <memory>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "json_forward.hpp"
+
+namespace bklib {
+namespace json {
+namespace detail {
+
+struct tape;
+
+//==============================================================================
+//! A value in the arena.
+//==============================================================================
+struct node {
+    enum : uint8_t {
+        flag_integral = 1 << 0, //!< A number without a fraction or exponent.
+        flag_escaped  = 1 << 1, //!< A string that contained escape sequences.
+    };
+
+    //! Offsets, relative to the node, of a container's children.
+    struct children_t {
+        uint32_t first; //!< In nodes; members are (name, value) pairs.
+        uint32_t index; //!< In bytes, to the hash index; 0 if there is none.
+    };
+
+    json::type type;
+    uint8_t    flags;
+    uint16_t   reserved;
+    //! The length of a string or of the text of a number or literal, or the
+    //! number of elements or members of a container.
+    uint32_t   size;
+
+    union {
+        char const* text;     //!< Strings (decoded), numbers and literals.
+        children_t  children; //!< Arrays and objects.
+    };
+
+    node const* first_child() const BK_NOEXCEPT {
+        return this + children.first;
+    }
+
+    uint32_t const* hash_index() const BK_NOEXCEPT {
+        return children.index
+          ? reinterpret_cast<uint32_t const*>(
+                reinterpret_cast<char const*>(this) + children.index)
+          : nullptr;
+    }
+
+    string_ref str() const BK_NOEXCEPT {
+        return string_ref{text, size};
+    }
+};
+
+static_assert(sizeof(node) <= 16, "json nodes should stay small");
+
+//! Objects with more members than this get a hash index.
+static BK_CONSTEXPR size_t const HASH_THRESHOLD = 16;
+
+//! The hash used for the member name index.
+uint32_t hash_name(string_ref name) BK_NOEXCEPT;
+
+//! The number of slots in the hash index of an object with @c size members.
+inline uint32_t hash_index_size(uint32_t const size) BK_NOEXCEPT {
+    uint32_t result = 4;
+    while (result < size * 2) {
+        result *= 2;
+    }
+
+    return result;
+}
+
+//! @pre str is a well formed integer. @returns false if it does not fit.
+bool parse_integer(string_ref str, int64_t& out) BK_NOEXCEPT;
+
+//==============================================================================
+//! The storage behind a json::document.
+//==============================================================================
+struct arena {
+    utf8string              storage; //!< The source, if owned by the document.
+    string_ref              text;    //!< The source.
+    std::unique_ptr<char[]> buffer;  //!< Nodes, hash indices, then strings.
+
+    node const* root() const BK_NOEXCEPT {
+        return reinterpret_cast<node const*>(buffer.get());
+    }
+};
+
+//==============================================================================
+//! Lay out the values of the (checked) @c source in @c result.buffer.
+//==============================================================================
+void build_arena(tape const& source, arena& result);
+
+} //namespace detail
+} //namespace json
+} //namespace bklib
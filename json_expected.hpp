@@ -0,0 +1,217 @@
+//==============================================================================
+//! Exception free error reporting for json.
+//!
+//! The try_* functions in json.hpp parallel the require_* functions but return
+//! a json::expected instead of throwing; failures are described by an
+//! error_record, a small trivially copyable value that can be collected in
+//! bulk and turned into the equivalent json::error exception with raise().
+//! @file
+//==============================================================================
+#pragma once
+
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "assert.hpp"
+#include "json_forward.hpp"
+
+namespace bklib {
+namespace json {
+//==============================================================================
+//! The json::error exception an error_record corresponds to.
+//==============================================================================
+enum class error_kind : uint8_t {
+    none
+  , bad_type
+  , bad_size
+  , bad_index
+  , bad_value
+};
+
+//==============================================================================
+//! A json error without the cost of an exception.
+//!
+//! Strings are views: the key of a bad_index into the caller's argument, the
+//! value of a bad_value into the document, and rules are expected to be
+//! string literals (e.g. __func__ or field names).
+//==============================================================================
+struct error_record {
+    static BK_CONSTEXPR size_t const MAX_TRACE = 6;
+
+    error_kind kind;
+    json::type expected_type;  //!< bad_type
+    json::type actual_type;    //!< bad_type
+    uint8_t    trace_size;
+    bool       has_key;        //!< bad_index: key rather than index is valid.
+
+    size_t     expected_min;   //!< bad_size
+    size_t     expected_max;   //!< bad_size
+    size_t     actual_size;    //!< bad_size
+    size_t     index;          //!< bad_index
+
+    string_ref key;            //!< bad_index
+    string_ref value;          //!< bad_value
+    string_ref trace[MAX_TRACE];
+
+    explicit operator bool() const BK_NOEXCEPT { return kind != error_kind::none; }
+
+    //! Append @c rule to the trace; rules beyond MAX_TRACE are dropped.
+    void add_rule(string_ref const rule) BK_NOEXCEPT {
+        if (trace_size < MAX_TRACE) {
+            trace[trace_size++] = rule;
+        }
+    }
+
+    //! Throw the equivalent json::error exception.
+    //! @pre kind != error_kind::none.
+    void raise() const;
+
+    static error_record make_bad_type(json::type const expected, json::type const actual) BK_NOEXCEPT {
+        auto result = make_(error_kind::bad_type);
+        result.expected_type = expected;
+        result.actual_type   = actual;
+        return result;
+    }
+
+    static error_record make_bad_size(size_t const min, size_t const max, size_t const actual) BK_NOEXCEPT {
+        auto result = make_(error_kind::bad_size);
+        result.expected_min = min;
+        result.expected_max = max;
+        result.actual_size  = actual;
+        return result;
+    }
+
+    static error_record make_bad_index(size_t const index) BK_NOEXCEPT {
+        auto result = make_(error_kind::bad_index);
+        result.index = index;
+        return result;
+    }
+
+    static error_record make_bad_index(string_ref const key) BK_NOEXCEPT {
+        auto result = make_(error_kind::bad_index);
+        result.has_key = true;
+        result.key     = key;
+        return result;
+    }
+
+    static error_record make_bad_value(string_ref const value) BK_NOEXCEPT {
+        auto result = make_(error_kind::bad_value);
+        result.value = value;
+        return result;
+    }
+private:
+    static error_record make_(error_kind const kind) BK_NOEXCEPT {
+        error_record result {};
+        result.kind = kind;
+        return result;
+    }
+};
+
+static_assert(std::is_trivially_copyable<error_record>::value, "error_record should be POD");
+
+//==============================================================================
+//! Either a T or the error_record describing why there is none.
+//==============================================================================
+template <typename T>
+class expected {
+public:
+    expected(T const& value) : has_value_ {true} {
+        ::new (&storage_) T(value);
+    }
+
+    expected(T&& value) : has_value_ {true} {
+        ::new (&storage_) T(std::move(value));
+    }
+
+    expected(error_record const& error) BK_NOEXCEPT : has_value_ {false} {
+        ::new (&storage_) error_record(error);
+    }
+
+    expected(expected const& other) : has_value_ {other.has_value_} {
+        if (has_value_) {
+            ::new (&storage_) T(*other);
+        } else {
+            ::new (&storage_) error_record(other.error());
+        }
+    }
+
+    expected(expected&& other) : has_value_ {other.has_value_} {
+        if (has_value_) {
+            ::new (&storage_) T(std::move(*other));
+        } else {
+            ::new (&storage_) error_record(other.error());
+        }
+    }
+
+    expected& operator=(expected const& rhs) {
+        if (this != &rhs) {
+            expected copy {rhs};
+            *this = std::move(copy);
+        }
+
+        return *this;
+    }
+
+    expected& operator=(expected&& rhs) {
+        if (this != &rhs) {
+            destroy_();
+
+            has_value_ = rhs.has_value_;
+            if (has_value_) {
+                ::new (&storage_) T(std::move(*rhs));
+            } else {
+                ::new (&storage_) error_record(rhs.error());
+            }
+        }
+
+        return *this;
+    }
+
+    ~expected() {
+        destroy_();
+    }
+
+    explicit operator bool() const BK_NOEXCEPT { return has_value_; }
+    bool has_value()         const BK_NOEXCEPT { return has_value_; }
+
+    T const& operator*() const BK_NOEXCEPT { BK_ASSERT(has_value_); return *value_ptr_(); }
+    T&       operator*()       BK_NOEXCEPT { BK_ASSERT(has_value_); return *value_ptr_(); }
+
+    T const* operator->() const BK_NOEXCEPT { BK_ASSERT(has_value_); return value_ptr_(); }
+    T*       operator->()       BK_NOEXCEPT { BK_ASSERT(has_value_); return value_ptr_(); }
+
+    //! @throws The equivalent json::error exception if there is no value.
+    T const& value() const {
+        if (!has_value_) error().raise();
+        return *value_ptr_();
+    }
+
+    T& value() {
+        if (!has_value_) error().raise();
+        return *value_ptr_();
+    }
+
+    //! @pre !has_value().
+    error_record const& error() const BK_NOEXCEPT {
+        BK_ASSERT(!has_value_);
+        return *reinterpret_cast<error_record const*>(&storage_);
+    }
+private:
+    T const* value_ptr_() const BK_NOEXCEPT { return reinterpret_cast<T const*>(&storage_); }
+    T*       value_ptr_()       BK_NOEXCEPT { return reinterpret_cast<T*>(&storage_); }
+
+    void destroy_() BK_NOEXCEPT {
+        if (has_value_) {
+            value_ptr_()->~T();
+        }
+    }
+
+    typename std::aligned_union<1, T, error_record>::type storage_;
+    bool has_value_;
+};
+
+} //namespace json
+} //namespace bklib
@@ -3,16 +3,27 @@
 #include <boost/variant.hpp>
 #include "types.hpp"
 
-namespace Json {
-    class Value;
-} //namespace Json
-
 namespace bklib {
     namespace json {
-        using cref_wrapped = std::reference_wrapper<Json::Value const>;
-        using cref         = Json::Value const&;
+        //! The type of a json value.
+        enum class type : uint8_t {
+            null
+          , signed_int
+          , unsigned_int
+          , real
+          , string
+          , boolean
+          , array
+          , object
+        };
+
+        class value_ref;
+        class document;
+        class reader;
+
+        using cref_wrapped = value_ref;
+        using cref         = value_ref;
         using index        = boost::variant<size_t, utf8string>;
-        using type         = Json::ValueType;
 
         struct type_info;
     } //namespace json
@@ -0,0 +1,68 @@
+//==============================================================================
+//! Structural indexing of json text.
+//!
+//! Parsing a json::document is done in two stages. Stage 1 scans the source
+//! 64 bytes at a time, classifying quotes, backslashes, whitespace and the
+//! structural characters {}[]:, into bit masks and producing the offsets of
+//! every structural character and of the first character of every scalar.
+//! Stage 2 checks the grammar over those offsets (and the contents of each
+//! scalar) and links each container to its end, after which values are read
+//! lazily.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <vector>
+
+#include "types.hpp"
+#include "config.hpp"
+
+namespace bklib {
+namespace json {
+namespace detail {
+//==============================================================================
+//! The result of both stages, from which the document's arena is built; it
+//! does not outlive the parse.
+//! Entry i is the structural character or scalar at offsets[i].
+//==============================================================================
+struct tape {
+    string_ref            text;    //!< The source.
+    std::vector<uint32_t> offsets; //!< Ends with a sentinel at text.size().
+    //! For '{' and '[': the index of the matching close.
+    //! For '}' and ']': the number of elements or members.
+    //! Otherwise unspecified.
+    std::vector<uint32_t> links;
+
+    // Totals used to size the document's arena; @see json_arena.hpp.
+    size_t value_count  = 0; //!< Values, including member names.
+    size_t escaped_size = 0; //!< Length of the strings containing escapes.
+    size_t index_size   = 0; //!< Slots in the hash indices of large objects.
+
+    char at(uint32_t const i) const BK_NOEXCEPT {
+        return text[offsets[i]];
+    }
+
+    char const* position(uint32_t const i) const BK_NOEXCEPT {
+        return text.data() + offsets[i];
+    }
+};
+//==============================================================================
+//! Stage 1: append the offset of each structural character and scalar start
+//! in @c source to @c out.
+//! @returns false if the source ends inside a string.
+//==============================================================================
+bool find_structurals(string_ref source, std::vector<uint32_t>& out);
+
+//! Byte at a time version of find_structurals; always available.
+bool find_structurals_scalar(string_ref source, std::vector<uint32_t>& out);
+
+//==============================================================================
+//! Both stages; fills in result.offsets and result.links.
+//! @pre result.text refers to the source.
+//! @throws json::error::parse_error if the source is not well formed.
+//==============================================================================
+void build_tape(tape& result);
+
+} //namespace detail
+} //namespace json
+} //namespace bklib
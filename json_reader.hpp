@@ -0,0 +1,130 @@
+//==============================================================================
+//! Zero-copy pull parser for json text.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "json_forward.hpp"
+
+namespace bklib {
+namespace json {
+//==============================================================================
+//! Tokens produced by json::reader.
+//==============================================================================
+enum class token : uint8_t {
+    none          //!< next() has not been called yet.
+  , begin_object
+  , end_object
+  , begin_array
+  , end_array
+  , key           //!< An object member name.
+  , string
+  , number
+  , true_value
+  , false_value
+  , null_value
+  , end           //!< The end of the document.
+};
+
+//==============================================================================
+//! Pull parser over a (non-owning) buffer of json text.
+//!
+//! Strings, keys and numbers are reported as views into the source; escape
+//! sequences are left as-is and can be decoded with json::unescape. The
+//! source must outlive the reader. The reader does not validate the encoding
+//! of the source; @see validate_utf8.
+//!
+//! @throws json::error::parse_error from next() on malformed input.
+//==============================================================================
+class reader {
+public:
+    static BK_CONSTEXPR size_t const MAX_DEPTH = 512;
+
+    explicit reader(string_ref source) BK_NOEXCEPT;
+
+    //! Advance to and return the next token.
+    token next();
+
+    //! Skip to the end of the current object or array; a no-op for other
+    //! tokens. Afterwards current() is the matching end_object or end_array.
+    void skip();
+
+    token current() const BK_NOEXCEPT { return token_; }
+
+    //! The text of the current token; for keys and strings this excludes the
+    //! surrounding quotes.
+    string_ref value() const BK_NOEXCEPT { return value_; }
+
+    //! Whether the current key or string contains escape sequences.
+    bool has_escapes() const BK_NOEXCEPT { return has_escapes_; }
+
+    //! Byte offset of the current token in the source.
+    size_t offset() const BK_NOEXCEPT { return token_offset_; }
+
+    //! Number of currently open objects and arrays.
+    size_t depth() const BK_NOEXCEPT { return depth_; }
+private:
+    enum class state : uint8_t {
+        value           //!< Expecting a value.
+      , first_element   //!< Just after '['.
+      , first_member    //!< Just after '{'.
+      , after_value     //!< Expecting ',' or a closing bracket.
+      , done
+    };
+
+    token parse_value_();
+    token parse_key_();
+    token parse_string_(token type);
+    token parse_number_();
+    token parse_literal_(string_ref literal, token type);
+    token open_(token type, bool is_object);
+    token close_(token type);
+
+    token set_(token type, char const* first, char const* last) BK_NOEXCEPT;
+
+    void skip_whitespace_() BK_NOEXCEPT;
+
+    bool in_object_() const BK_NOEXCEPT {
+        return depth_ > 0 && is_object_[depth_ - 1];
+    }
+
+    //! Always throws; the return type is for convenience at the call site.
+    token fail_(char const* reason) const;
+
+    char const* first_;
+    char const* last_;
+    char const* pos_;
+
+    string_ref value_;
+    size_t     token_offset_ = 0;
+    size_t     depth_        = 0;
+    token      token_        = token::none;
+    state      state_        = state::value;
+    bool       has_escapes_  = false;
+
+    std::array<bool, MAX_DEPTH> is_object_;
+};
+
+//==============================================================================
+//! Decode the escape sequences in the raw string contents @c raw (as given by
+//! reader::value()) and append the result to @c out.
+//! @pre raw is the contents of a well formed json string.
+//==============================================================================
+void unescape(string_ref raw, utf8string& out);
+
+//! As above, writing to a buffer of at least raw.size() bytes.
+//! @returns The number of bytes written.
+size_t unescape(string_ref raw, char* out) BK_NOEXCEPT;
+
+inline utf8string unescape(string_ref const raw) {
+    utf8string result;
+    unescape(raw, result);
+    return result;
+}
+
+} //namespace json
+} //namespace bklib
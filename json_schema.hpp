@@ -0,0 +1,382 @@
+//==============================================================================
+//! Declarative binding of json objects to C++ structs.
+//!
+//! A struct is bound by specializing json::schema with a list of fields:
+//!
+//! @code
+//! struct item_def {
+//!     bklib::string_ref id;
+//!     int               weight;
+//!     float             scale = 1.0f;
+//! };
+//!
+//! namespace bklib { namespace json {
+//! template <> struct schema<item_def> {
+//!     static auto fields() {
+//!         return json::make_fields(
+//!             BK_JSON_REQUIRED(item_def, id)
+//!           , BK_JSON_REQUIRED(item_def, weight)
+//!           , BK_JSON_OPTIONAL(item_def, scale)
+//!         );
+//!     }
+//! };
+//! }}
+//!
+//! auto const item = json::decode<item_def>(value);
+//! @endcode
+//!
+//! Each bound struct gets one decoder which walks the (name sorted) members of
+//! the object once, merging them against the (name sorted) fields; unknown
+//! members are ignored. Decoders report failures with a json::error_record
+//! holding the path of field names in its trace; json::decode throws the
+//! equivalent exception, json::try_decode does not. Other than the fields of
+//! the target itself (e.g. a utf8string or std::vector) decoding does not
+//! allocate.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "json.hpp"
+
+namespace bklib {
+namespace json {
+//==============================================================================
+//! Specialize for each bound struct; see above.
+//==============================================================================
+template <typename T>
+struct schema;
+
+//==============================================================================
+//! A bound data member.
+//==============================================================================
+template <typename T, typename Member>
+struct field {
+    using struct_type = T;
+    using member_type = Member;
+
+    string_ref     name;
+    Member T::*    member;
+    bool           required;
+};
+
+template <typename T, typename Member>
+inline BK_CONSTEXPR field<T, Member> required(string_ref const name, Member T::* const member) {
+    return field<T, Member> {name, member, true};
+}
+
+//! Left as-is if absent from the object.
+template <typename T, typename Member>
+inline BK_CONSTEXPR field<T, Member> optional(string_ref const name, Member T::* const member) {
+    return field<T, Member> {name, member, false};
+}
+
+template <typename... Fields>
+inline std::tuple<Fields...> make_fields(Fields... fields) {
+    return std::tuple<Fields...> {fields...};
+}
+
+//! A required field with the same name as its data member.
+#define BK_JSON_REQUIRED(T, member) ::bklib::json::required(#member, &T::member)
+//! An optional field with the same name as its data member.
+#define BK_JSON_OPTIONAL(T, member) ::bklib::json::optional(#member, &T::member)
+
+//==============================================================================
+//! Decoders for individual types; specialize to add support for more.
+//! The primary template handles structs bound with json::schema.
+//!
+//! Each has a static member
+//! @code bool decode(cref json, T& out, error_record& error); @endcode
+//! which fills in @c error and returns false if @c json does not match.
+//==============================================================================
+template <typename T, typename Enable = void>
+struct decoder;
+
+//==============================================================================
+//! @returns false, with the reason in @c error, if @c json does not match.
+//==============================================================================
+template <typename T>
+inline bool try_decode(cref json, T& out, error_record& error) {
+    return decoder<T>::decode(json, out, error);
+}
+
+template <typename T>
+inline expected<T> try_decode(cref json) {
+    T result {};
+    error_record error {};
+
+    if (!decoder<T>::decode(json, result, error)) {
+        return error;
+    }
+
+    return result;
+}
+
+//==============================================================================
+//! @throws json::error::base if @c json does not match.
+//==============================================================================
+template <typename T>
+inline void decode(cref json, T& out) {
+    error_record error {};
+    if (!decoder<T>::decode(json, out, error)) {
+        error.raise();
+    }
+}
+
+template <typename T>
+inline T decode(cref json) {
+    T result {};
+    json::decode(json, result);
+    return result;
+}
+
+namespace detail {
+//==============================================================================
+//! A type erased entry of a struct's field table.
+//==============================================================================
+template <typename T>
+struct field_entry {
+    string_ref name;
+    bool       required;
+    bool     (*decode)(cref json, T& out, error_record& error);
+};
+
+template <typename T, size_t I>
+bool decode_field(cref json, T& out, error_record& error) {
+    auto const member = std::get<I>(schema<T>::fields()).member;
+    return json::try_decode(json, out.*member, error);
+}
+
+template <typename T, size_t... I>
+std::array<field_entry<T>, sizeof...(I)> make_field_table(std::index_sequence<I...>) {
+    auto const fields = schema<T>::fields();
+
+    std::array<field_entry<T>, sizeof...(I)> result {{
+        field_entry<T> {std::get<I>(fields).name, std::get<I>(fields).required, &decode_field<T, I>}...
+    }};
+
+    // the same order as the members of a value_ref.
+    std::sort(begin(result), end(result), [](field_entry<T> const& a, field_entry<T> const& b) {
+        return a.name < b.name;
+    });
+
+    return result;
+}
+
+//! The fields of T sorted by name; built once.
+template <typename T>
+auto const& field_table() {
+    using fields_t = decltype(schema<T>::fields());
+    static auto const table = make_field_table<T>(
+        std::make_index_sequence<std::tuple_size<fields_t>::value>{}
+    );
+
+    return table;
+}
+
+//==============================================================================
+template <typename T>
+bool decode_object(cref json, T& out, error_record& error) {
+    if (!json.is_object()) {
+        error = error_record::make_bad_type(type::object, json.type());
+        return false;
+    }
+
+    auto       it   = json.begin();
+    auto const last = json.end();
+
+    // both are sorted by name: a single merge pass. Of duplicate names only
+    // the first is used.
+    for (auto const& f : field_table<T>()) {
+        while (it != last && it.key() < f.name) {
+            ++it;
+        }
+
+        if (it == last || it.key() != f.name) {
+            if (f.required) {
+                error = error_record::make_bad_index(f.name);
+                return false;
+            }
+
+            continue;
+        }
+
+        if (!f.decode(*it, out, error)) {
+            error.add_rule(f.name);
+            return false;
+        }
+
+        ++it;
+    }
+
+    return true;
+}
+} //namespace detail
+
+//==============================================================================
+template <typename T, typename Enable>
+struct decoder {
+    static bool decode(cref json, T& out, error_record& error) {
+        return detail::decode_object(json, out, error);
+    }
+};
+//------------------------------------------------------------------------------
+template <>
+struct decoder<bool> {
+    static bool decode(cref json, bool& out, error_record& error) BK_NOEXCEPT {
+        if (!json.is_bool()) {
+            error = error_record::make_bad_type(type::boolean, json.type());
+            return false;
+        }
+
+        out = json.as_bool();
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <typename T>
+struct decoder<T, std::enable_if_t<std::is_integral<T>::value>> {
+    static bool decode(cref json, T& out, error_record& error) BK_NOEXCEPT {
+        if (!json.is_integral()) {
+            error = error_record::make_bad_type(
+                std::is_signed<T>::value ? type::signed_int : type::unsigned_int, json.type()
+            );
+            return false;
+        }
+
+        int64_t value;
+        if (!json.as_int(value)) {
+            // only an unsigned 64 bit member could hold this.
+            return decode_large_(json, out, error);
+        }
+
+        using limits = std::numeric_limits<T>;
+
+        auto const in_range = (value < 0)
+          ? (std::is_signed<T>::value && value >= static_cast<int64_t>(limits::min()))
+          : (static_cast<uint64_t>(value) <= static_cast<uint64_t>(limits::max()));
+
+        if (!in_range) {
+            error = error_record::make_bad_value(json.raw());
+            return false;
+        }
+
+        out = static_cast<T>(value);
+        return true;
+    }
+private:
+    static bool decode_large_(cref json, T& out, error_record& error) BK_NOEXCEPT {
+        if (!std::is_same<T, uint64_t>::value || json.type() != type::unsigned_int) {
+            error = error_record::make_bad_value(json.raw());
+            return false;
+        }
+
+        uint64_t value {0};
+        for (auto const c : json.raw()) {
+            auto const digit = static_cast<uint64_t>(c - '0');
+            if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                error = error_record::make_bad_value(json.raw());
+                return false;
+            }
+
+            value = value * 10 + digit;
+        }
+
+        out = static_cast<T>(value);
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <typename T>
+struct decoder<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+    static bool decode(cref json, T& out, error_record& error) {
+        if (!json.is_number()) {
+            error = error_record::make_bad_type(type::real, json.type());
+            return false;
+        }
+
+        out = static_cast<T>(json.as_double());
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <>
+struct decoder<string_ref> {
+    static bool decode(cref json, string_ref& out, error_record& error) BK_NOEXCEPT {
+        auto const result = json::try_string_ref(json);
+        if (!result) {
+            error = result.error();
+            return false;
+        }
+
+        out = *result;
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <>
+struct decoder<utf8string> {
+    static bool decode(cref json, utf8string& out, error_record& error) {
+        auto const result = json::try_string_ref(json);
+        if (!result) {
+            error = result.error();
+            return false;
+        }
+
+        out.assign(result->data(), result->size());
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <typename T, size_t N>
+struct decoder<std::array<T, N>> {
+    static bool decode(cref json, std::array<T, N>& out, error_record& error) {
+        if (!json.is_array()) {
+            error = error_record::make_bad_type(type::array, json.type());
+            return false;
+        } else if (json.size() != N) {
+            error = error_record::make_bad_size(N, N, json.size());
+            return false;
+        }
+
+        for (size_t i = 0; i < N; ++i) {
+            if (!json::try_decode(json[i], out[i], error)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+//------------------------------------------------------------------------------
+template <typename T, typename Allocator>
+struct decoder<std::vector<T, Allocator>> {
+    static bool decode(cref json, std::vector<T, Allocator>& out, error_record& error) {
+        if (!json.is_array()) {
+            error = error_record::make_bad_type(type::array, json.type());
+            return false;
+        }
+
+        out.clear();
+        out.resize(json.size());
+
+        size_t i = 0;
+        for (auto const element : json) {
+            if (!json::try_decode(element, out[i++], error)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+} //namespace json
+} //namespace bklib
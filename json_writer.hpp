@@ -0,0 +1,214 @@
+//==============================================================================
+//! Streaming json writer.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <type_traits>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+#include "json_forward.hpp"
+#include "json_reader.hpp"
+
+namespace bklib {
+namespace json {
+//==============================================================================
+//! A chunked output buffer.
+//!
+//! Memory is allocated in CHUNK_SIZE chunks which are kept for reuse by
+//! clear(), so a buffer that is reused for each save allocates only while it
+//! grows. Given a file descriptor the buffer instead writes each chunk out as
+//! it fills, and so never holds more than one; call flush() to write the rest.
+//!
+//! @throws bklib::platform_error (with boost::errinfo_errno) if writing to the
+//!         file descriptor fails.
+//==============================================================================
+class output_buffer {
+public:
+    static BK_CONSTEXPR size_t const CHUNK_SIZE = 64 * 1024;
+
+    output_buffer() = default;
+    explicit output_buffer(int fd) BK_NOEXCEPT : fd_ {fd} {}
+
+    output_buffer(output_buffer&&) = default;
+    output_buffer& operator=(output_buffer&&) = default;
+    BK_NO_COPY_ASSIGN(output_buffer);
+
+    //! @returns Space for at least @c n contiguous bytes; follow with commit().
+    //! @pre n <= CHUNK_SIZE.
+    char* reserve(size_t const n) {
+        if (static_cast<size_t>(last_ - pos_) < n) {
+            next_chunk_();
+        }
+
+        return pos_;
+    }
+
+    //! @c end is one past the last byte written to the space from reserve().
+    void commit(char* const end) BK_NOEXCEPT {
+        pos_ = end;
+    }
+
+    void put(char const c) {
+        *reserve(1) = c;
+        ++pos_;
+    }
+
+    void write(char const* data, size_t size);
+
+    void write(string_ref const str) {
+        write(str.data(), str.size());
+    }
+
+    //! Bytes currently held; excludes anything written to the file descriptor.
+    size_t size() const BK_NOEXCEPT;
+
+    //! Discard the contents, keeping the memory.
+    void clear() BK_NOEXCEPT;
+
+    //! Write the contents to the file descriptor, if any, and clear().
+    void flush();
+
+    //! Call @c f with a string_ref to each non-empty chunk, in order.
+    template <typename F>
+    void for_each_chunk(F&& f) const {
+        for (size_t i = 0; i < used_.size(); ++i) {
+            f(string_ref{chunks_[i].get(), used_[i]});
+        }
+
+        if (pos_ != first_()) {
+            f(string_ref{first_(), static_cast<size_t>(pos_ - first_())});
+        }
+    }
+
+    utf8string to_string() const;
+private:
+    char* first_() const BK_NOEXCEPT {
+        return chunks_.empty() ? nullptr : chunks_[used_.size()].get();
+    }
+
+    void next_chunk_();
+    void write_fd_(char const* data, size_t size);
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    std::vector<size_t>                  used_;   //!< Sizes of the full chunks.
+    char*                                pos_  = nullptr;
+    char*                                last_ = nullptr;
+    int                                  fd_   = -1;
+};
+
+//==============================================================================
+// Number formatting.
+//==============================================================================
+
+//! Large enough for any of the format_* functions.
+static BK_CONSTEXPR size_t const MAX_NUMBER_SIZE = 32;
+
+//==============================================================================
+//! Write the shortest decimal that reads back as @c value (Grisu2; in rare
+//! cases a digit longer than the shortest). Values that are whole numbers get
+//! a ".0" so that they read back as reals.
+//! @pre std::isfinite(value).
+//! @returns One past the last character written.
+//==============================================================================
+char* format_double(double value, char* out) BK_NOEXCEPT;
+
+//! As format_double, with the precision of a float.
+char* format_float(float value, char* out) BK_NOEXCEPT;
+
+char* format_int(int64_t value, char* out) BK_NOEXCEPT;
+char* format_uint(uint64_t value, char* out) BK_NOEXCEPT;
+
+//==============================================================================
+//! Streaming json writer; the output counterpart of json::reader.
+//!
+//! Values are written straight to an output_buffer as they are given. Misuse,
+//! such as a value in an object without a key or mismatched ends, is a
+//! programming error and asserts. Strings must be UTF-8, and are escaped as
+//! required; numbers are written such that reading them back gives the same
+//! value, so documents round-trip through writer and reader.
+//!
+//! @throws json::error::bad_value for non-finite numbers.
+//==============================================================================
+class writer {
+public:
+    enum class style : uint8_t {
+        compact //!< No whitespace.
+      , pretty  //!< One value per line, indented by INDENT per level.
+    };
+
+    static BK_CONSTEXPR size_t const MAX_DEPTH = reader::MAX_DEPTH;
+    static BK_CONSTEXPR size_t const INDENT    = 4;
+
+    explicit writer(output_buffer& out, style format = style::compact) BK_NOEXCEPT;
+
+    writer& begin_object();
+    writer& end_object();
+    writer& begin_array();
+    writer& end_array();
+
+    //! The name of the next object member.
+    writer& key(string_ref name);
+
+    writer& value(string_ref str);
+    writer& value(char const* str) { return value(string_ref{str}); }
+    writer& value(bool b);
+    writer& value(std::nullptr_t);
+    writer& value(double d);
+    writer& value(float f);
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, writer&>
+    value(T const i) {
+        return int_(static_cast<int64_t>(i));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && !std::is_signed<T>::value, writer&>
+    value(T const i) {
+        return uint_(static_cast<uint64_t>(i));
+    }
+
+    //! Write a parsed value; numbers are written as their source text.
+    writer& value(cref json);
+
+    //! Whether a single complete value has been written.
+    bool is_complete() const BK_NOEXCEPT { return depth_ == 0 && has_root_; }
+
+    //! Number of currently open objects and arrays.
+    size_t depth() const BK_NOEXCEPT { return depth_; }
+private:
+    writer& int_(int64_t i);
+    writer& uint_(uint64_t i);
+
+    //! Separator and indentation before a value or key.
+    void prefix_();
+    void newline_(size_t depth);
+
+    writer& open_(char c, bool is_object);
+    writer& close_(char c, bool is_object);
+
+    void string_(string_ref str);
+
+    bool in_object_() const BK_NOEXCEPT {
+        return depth_ > 0 && is_object_[depth_ - 1];
+    }
+
+    output_buffer& out_;
+    size_t         depth_     = 0;
+    style          style_;
+    bool           first_     = true;  //!< No value yet in the current container.
+    bool           after_key_ = false;
+    bool           has_root_  = false;
+
+    std::array<bool, MAX_DEPTH> is_object_;
+};
+
+} //namespace json
+} //namespace bklib
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <array>
+#include <iosfwd>
+#include <iterator>
+#include <algorithm>
+#include <initializer_list>
+
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 
@@ -52,17 +58,26 @@ public:
     {
     }
 
-    void add(keycode const key) {
-        keys_.insert(key);
+    //! @returns true if @c key was not already included.
+    bool add(keycode const key) {
+        return keys_.insert(key).second;
     }
 
+    //! @returns true if any key was not already included.
     template <typename It>
-    void add(It first, It last) {
+    bool add(It first, It last) {
+        auto const before = keys_.size();
         keys_.insert(first, last);
+        return keys_.size() != before;
+    }
+
+    bool add(std::initializer_list<keycode> const list) {
+        return add(list.begin(), list.end());
     }
 
-    void remove(keycode const key) {
-        keys_.erase(key);
+    //! @returns true if @c key was included.
+    bool remove(keycode const key) {
+        return keys_.erase(key) != 0;
     }
 
     void clear() {
@@ -96,7 +111,8 @@ private:
 };
 
 inline bool operator==(key_combo const& lhs, key_combo const& rhs) {
-    return std::equal(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs));
+    return lhs.size() == rhs.size()
+        && std::equal(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs));
 }
 
 inline bool operator<(key_combo const& lhs, key_combo const& rhs) {
@@ -110,6 +126,18 @@ inline bool operator!=(key_combo const& lhs, key_combo const& rhs) {
     return !(lhs == rhs);
 }
 
+inline bool operator>(key_combo const& lhs, key_combo const& rhs) {
+    return rhs < lhs;
+}
+
+inline bool operator<=(key_combo const& lhs, key_combo const& rhs) {
+    return !(rhs < lhs);
+}
+
+inline bool operator>=(key_combo const& lhs, key_combo const& rhs) {
+    return !(lhs < rhs);
+}
+
 std::ostream& operator<<(std::ostream& out, key_combo const& combo);
 //==============================================================================
 
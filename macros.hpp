@@ -1,8 +1,12 @@
 
+#pragma once
+
+#include "config.hpp"
+
 #define BK_CAT2_IMPL(A1, A2) A1 ## A2
 #define BK_CAT2(A1, A2) BK_CAT2_IMPL(A1, A2)
 
-#if defined(BOOST_COMP_MSVC)
+#if BOOST_COMP_MSVC || BOOST_COMP_GNUC || BOOST_COMP_CLANG
 #   define BK_UNIQUE_ID(NAME) BK_CAT2(NAME, __COUNTER__)
 #else
 #   define BK_UNIQUE_ID(NAME) BK_CAT2(NAME, __LINE__)
@@ -10,10 +14,12 @@
 
 #define BK_UNUSED(x) (void)(x)
 
-#if defined(BOOST_COMP_MSVC)
+#if BOOST_COMP_MSVC
 #   define BK_DEBUG_BREAK __debugbreak
+#elif BOOST_COMP_GNUC || BOOST_COMP_CLANG
+#   define BK_DEBUG_BREAK __builtin_trap
 #else
-#   error "define me" //TODO
+#   define BK_DEBUG_BREAK std::abort
 #endif
 
 #define BK_NO_COPY_ASSIGN(name)\
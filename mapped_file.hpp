@@ -0,0 +1,105 @@
+//==============================================================================
+//! Read-only memory mapped files.
+//! @file
+//==============================================================================
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+#include "exception.hpp"
+
+namespace bklib {
+//==============================================================================
+//! Expected access patterns; @see mapped_file::view::advise.
+//==============================================================================
+enum class access_hint : uint8_t {
+    normal
+  , sequential //!< Read ahead aggressively; pages behind may be dropped.
+  , random     //!< Do not read ahead.
+  , will_need  //!< Start reading the range in now.
+  , dont_need  //!< The range will not be needed again soon.
+};
+
+//==============================================================================
+//! A file mapped read-only into memory.
+//!
+//! The contents are accessed through views, which are plain (pointer, size)
+//! pairs into the mapping; they, and any string_ref taken from them, are valid
+//! until the mapping is destroyed. A move hands the mapping, and so its views,
+//! to the moved-to mapped_file: they stay valid until that one is destroyed or
+//! assigned to. A view's string_ref can be given directly to json::document or
+//! anything else taking a buffer, without copying.
+//!
+//! @throws bklib::platform_error (with boost::errinfo_errno,
+//!         boost::errinfo_api_function and boost::errinfo_file_name) if the file
+//!         cannot be opened or mapped.
+//==============================================================================
+class mapped_file {
+public:
+    //--------------------------------------------------------------------------
+    //! A range of the mapping.
+    //--------------------------------------------------------------------------
+    class view {
+    public:
+        view() = default;
+        view(char const* const data, size_t const size) BK_NOEXCEPT
+          : data_ {data}, size_ {size}
+        {
+        }
+
+        char const* data()  const BK_NOEXCEPT { return data_; }
+        size_t      size()  const BK_NOEXCEPT { return size_; }
+        bool        empty() const BK_NOEXCEPT { return size_ == 0; }
+
+        string_ref str() const BK_NOEXCEPT { return string_ref{data_, size_}; }
+        operator string_ref() const BK_NOEXCEPT { return str(); }
+
+        //! The @c size bytes at @c offset, clamped to this view.
+        view sub(size_t offset, size_t size = static_cast<size_t>(-1)) const BK_NOEXCEPT;
+
+        //! The smallest range of whole pages containing this view, clamped to
+        //! the mapping @c file.
+        view page_aligned(mapped_file const& file) const BK_NOEXCEPT;
+
+        //! Hint how the pages holding this view will be accessed. Hints are
+        //! advisory; failures are ignored.
+        void advise(access_hint hint) const BK_NOEXCEPT;
+    private:
+        char const* data_ = nullptr;
+        size_t      size_ = 0;
+    };
+    //--------------------------------------------------------------------------
+    //! The granularity of mappings; a power of two.
+    static size_t page_size() BK_NOEXCEPT;
+
+    mapped_file() = default;
+
+    //! Map the whole of the file at the UTF-8 @c path.
+    explicit mapped_file(string_ref path);
+
+    mapped_file(mapped_file&& other) BK_NOEXCEPT;
+    mapped_file& operator=(mapped_file&& rhs) BK_NOEXCEPT;
+    BK_NO_COPY_ASSIGN(mapped_file);
+
+    ~mapped_file();
+
+    char const* data()  const BK_NOEXCEPT { return data_; }
+    size_t      size()  const BK_NOEXCEPT { return size_; }
+    bool        empty() const BK_NOEXCEPT { return size_ == 0; }
+
+    view all() const BK_NOEXCEPT { return view{data_, size_}; }
+    string_ref str() const BK_NOEXCEPT { return string_ref{data_, size_}; }
+
+    //! @see view::sub.
+    view sub(size_t const offset, size_t const size = static_cast<size_t>(-1)) const BK_NOEXCEPT {
+        return all().sub(offset, size);
+    }
+private:
+    void close_() BK_NOEXCEPT;
+
+    char const* data_ = nullptr; //!< nullptr for an empty file.
+    size_t      size_ = 0;
+};
+
+} //namespace bklib
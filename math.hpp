@@ -5,9 +5,24 @@
 //==============================================================================
 #pragma once
 
+#include <cmath>
+#include <tuple>
+#include <limits>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
 #include "config.hpp"
 #include "assert.hpp"
 
+#if defined(BK_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+
 namespace bklib {
 
 //==============================================================================
@@ -52,6 +67,31 @@ using enable_for_integral_t = typename std::enable_if<
     std::is_integral<Test>::value, Type
 >::type;
 
+//==============================================================================
+//! Whether @c T is an integer coordinate type with its own fast paths: exact
+//! integer arithmetic, without conversions to floating point.
+//==============================================================================
+template <typename T>
+struct is_integral_coordinate : public std::integral_constant<bool,
+    std::is_same<T, std::int16_t>::value || std::is_same<T, std::int32_t>::value
+> { };
+
+//==============================================================================
+//! Enable if @c Test is an integral coordinate type.
+//==============================================================================
+template <typename Test, typename Type = void>
+using enable_for_integral_coordinate_t = typename std::enable_if<
+    is_integral_coordinate<Test>::value, Type
+>::type;
+
+//==============================================================================
+//! Enable if @c Test is not an integral coordinate type.
+//==============================================================================
+template <typename Test, typename Type = void>
+using disable_for_integral_coordinate_t = typename std::enable_if<
+    !is_integral_coordinate<Test>::value, Type
+>::type;
+
 //==============================================================================
 //! @see if_not_void_t.
 //==============================================================================
@@ -86,12 +126,12 @@ using if_not_void_common_t = typename if_not_void_common<Test, T1, T2>::type;
 //==============================================================================
 //! @returns One of (-1, 0, 1) corresponding to the sign of @c x.
 //==============================================================================
-template <typename T, enable_for_integral_t<T>* = 0>
+template <typename T, enable_for_integral_t<T>* = nullptr>
 T sign_of(T const x) {
     return (x > T{0}) - (x < T{0});
 }
 //------------------------------------------------------------------------------
-template <typename T, enable_for_floating_point_t<T>* = 0>
+template <typename T, enable_for_floating_point_t<T>* = nullptr>
 T sign_of(T const x) {
     //TODO
     return (x > T{0}) - (x < T{0});
@@ -126,21 +166,28 @@ using sized_unsigned_t = typename sized_integral<N, false>::type;
 //==============================================================================
 //! Equality comparison for floating point, otherwise use built in comparison.
 //==============================================================================
-template <typename T, enable_for_floating_point_t<T>* = 0>
+template <typename T, enable_for_floating_point_t<T>* = nullptr>
 bool is_equal(T const a, T const b, int const ulps = 4) {
     BK_ASSERT(ulps > 0);
 
-    using int_t = sized_signed_t<sizeof(T)>;
+    using int_t  = sized_signed_t<sizeof(T)>;
+    using uint_t = sized_unsigned_t<sizeof(T)>;
 
-    static auto const max = std::numeric_limits<int_t>::max() + 1;
+    int_t ai;
+    int_t bi;
+    std::memcpy(&ai, &a, sizeof(T));
+    std::memcpy(&bi, &b, sizeof(T));
 
-    auto const ai = *reinterpret_cast<int_t const*>(&a);
-    auto const bi = *reinterpret_cast<int_t const*>(&b);
+    //sign-magnitude -> two's complement, so that adjacent floats are adjacent.
+    auto const min = std::numeric_limits<int_t>::min();
+    if (ai < 0) { ai = min - ai; }
+    if (bi < 0) { bi = min - bi; }
 
-    auto const an = ai < 0 ? max - ai : ai;
-    auto const bn = bi < 0 ? max - bi : bi;
+    auto const diff = (ai < bi)
+      ? static_cast<uint_t>(bi) - static_cast<uint_t>(ai)
+      : static_cast<uint_t>(ai) - static_cast<uint_t>(bi);
 
-    return std::abs(an - bn) <= ulps;
+    return diff <= static_cast<uint_t>(ulps);
 }
 //------------------------------------------------------------------------------
 template <typename T, typename U>
@@ -182,8 +229,8 @@ namespace detail {
         //!Tag type to differentiate points by their vertex.
         template <typename T, typename Tag>
         struct tagged_point {
-            tagged_point(T x, T y) : value{{x, y}} {}
-            tagged_point(point2d<T> p) : value{{p.x, p.y}} {}
+            tagged_point(T x, T y) : value{x, y} {}
+            tagged_point(point2d<T> p) : value{p.x, p.y} {}
 
             operator point2d<T>&() { return value; }
             operator point2d<T> const&() const { return value; }
@@ -346,6 +393,14 @@ struct intersection_result {
 
     explicit operator bool() const BK_NOEXCEPT { return valid; }
 };
+namespace detail {
+    //! Unqualified, so that the intersects overloads declared later are found
+    //! (by ADL) when this is instantiated.
+    template <typename Shape, typename Point>
+    bool shape_intersects(Shape const& shape, Point const p) BK_NOEXCEPT {
+        return intersects(shape, p);
+    }
+} //namespace detail
 //==============================================================================
 //! The geometric union of n objects.
 //==============================================================================
@@ -353,39 +408,22 @@ template <typename T, typename... Types>
 struct geometric_union {
     using point = point2d<T>;
 
-
     //Recursive case
-    template <int I = -1>
-    bool intersects(point const p) const {
-        return bklib::intersects(std::get<I-1>(types), p) && intersects<I-2>(p);
-    }
-
-    //Default case
-    template <>
-    bool intersects<-1>(point const p) const {
-        return intersects<sizeof...(Types)>(p);
+    template <size_t I = 0>
+    std::enable_if_t<(I < sizeof...(Types)), bool>
+    intersects(point const p) const {
+        return detail::shape_intersects(std::get<I>(types), p) && intersects<I + 1>(p);
     }
 
     //Base case
-    template <>
-    bool intersects<0>(point const p) const {
-        return bklib::intersects(std::get<0>(types), p);
+    template <size_t I = 0>
+    std::enable_if_t<(I == sizeof...(Types)), bool>
+    intersects(point) const {
+        return true;
     }
 
     std::tuple<Types...> types;
 };
-//------------------------------------------------------------------------------
-// Base case
-//------------------------------------------------------------------------------
-template <typename T>
-struct geometric_union<T> {
-    using point = point2d<T>;
-
-    template <int I = -1>
-    bool intersects(point const p) const {
-        return true;
-    }
-};
 
 template <typename T, typename... Types>
 intersection_result<point2d<T>> intersects(
@@ -499,7 +537,7 @@ auto operator+(point2d<T> const p, vector2d<U> const v) BK_NOEXCEPT {
 template <typename T, typename U>
 auto operator+(axis_aligned_rect<T> const r, vector2d<U> const v) BK_NOEXCEPT {
     using type = axis_aligned_rect<common_type_t<T, U>>;
-    type::tl_point const p = r.top_left() + v;
+    typename type::tl_point const p = r.top_left() + v;
     return type{p, r.width(), r.height()};
 }
 //------------------------------------------------------------------------------
@@ -524,7 +562,7 @@ vector2d<common_type_t<T, U>> operator-(point2d<T> const p, point2d<U> const q)
 template <typename T, typename U>
 auto operator-(axis_aligned_rect<T> const r, vector2d<U> const v) BK_NOEXCEPT {
     using type = axis_aligned_rect<common_type_t<T, U>>;
-    type::tl_point const p = r.top_left() - v;
+    typename type::tl_point const p = r.top_left() - v;
 
     type result{p, r.width(), r.height()};
 
@@ -557,6 +595,19 @@ auto dot(vector2d<T> const v) BK_NOEXCEPT {
 }
 //------------------------------------------------------------------------------
 
+//==============================================================================
+// Conversions.
+//==============================================================================
+template <typename R, typename T>
+vector2d<R> to_type(vector2d<T> const v) BK_NOEXCEPT {
+    return {static_cast<R>(v.x), static_cast<R>(v.y)};
+}
+
+template <typename R, typename T>
+point2d<R> to_type(point2d<T> const p) BK_NOEXCEPT {
+    return {static_cast<R>(p.x), static_cast<R>(p.y)};
+}
+
 //==============================================================================
 //! If T is a floating point type, then T, otherwise Default.
 //==============================================================================
@@ -595,18 +646,41 @@ T area(axis_aligned_rect<T> const r) BK_NOEXCEPT {
     return r.width() * r.height();
 }
 //==============================================================================
-// Conversions.
+// Integer coordinates.
+//
+// Squared distances of int16_t / int32_t coordinates are computed in 64 bits,
+// where they cannot overflow, and compared against squared radii rather than
+// taking square roots.
 //==============================================================================
-template <typename R, typename T>
-vector2d<R> to_type(vector2d<T> const v) BK_NOEXCEPT {
-    return {static_cast<R>(v.x), static_cast<R>(v.y)};
-}
-
-template <typename R, typename T>
-point2d<R> to_type(point2d<T> const p) BK_NOEXCEPT {
-    return {static_cast<R>(p.x), static_cast<R>(p.y)};
-}
+namespace detail {
+    template <typename T, typename U>
+    std::int64_t distance2_wide(point2d<T> const a, point2d<U> const b) BK_NOEXCEPT {
+        auto const dx = std::int64_t {a.x} - b.x;
+        auto const dy = std::int64_t {a.y} - b.y;
+        return dx*dx + dy*dy;
+    }
 
+    //! @returns The smallest r such that r*r >= n.
+    inline std::uint64_t ceil_sqrt(std::uint64_t n) BK_NOEXCEPT {
+        std::uint64_t r   = 0;
+        std::uint64_t bit = std::uint64_t {1} << 62;
+
+        auto const exact = n;
+        while (bit > n) { bit >>= 2; }
+
+        while (bit) {
+            if (n >= r + bit) {
+                n -= r + bit;
+                r  = (r >> 1) + bit;
+            } else {
+                r >>= 1;
+            }
+            bit >>= 2;
+        }
+
+        return r + ((r * r != exact) ? 1 : 0);
+    }
+} //namespace detail
 //==============================================================================
 // Distances
 //==============================================================================
@@ -638,24 +712,92 @@ auto distance(circle<T> const a, circle<U> const b) BK_NOEXCEPT {
     );
 }
 //------------------------------------------------------------------------------
-// rectangle <-> rectangle
+// rectangle <-> rectangle (centers)
 //------------------------------------------------------------------------------
-template <
-    typename CornerA = axis_aligned_rect<T>::center_t
-  , typename CornerB = axis_aligned_rect<T>::center_t
-  , typename T = void
->
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 T distance2(
     axis_aligned_rect<T> const ra
   , axis_aligned_rect<T> const rb
-  , CornerA = CornerA{}
-  , CornerB = CornerB{}
 ) BK_NOEXCEPT {
-    auto const a = ra.get_point(CornerA{});
-    auto const b = ra.get_point(CornerB{});
+    return distance2(ra.center(), rb.center());
+}
+//------------------------------------------------------------------------------
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+std::int64_t distance2(
+    axis_aligned_rect<T> const ra
+  , axis_aligned_rect<T> const rb
+) BK_NOEXCEPT {
+    return detail::distance2_wide(ra.center(), rb.center());
+}
+//==============================================================================
+//! Special rounding.
+//!
+//! Source   | Result   | Action
+//! ---------|----------|-------------------------------------------------------
+//! Floating | Integral | Round to next most negative / positive integer
+//! Floating | Floating | Type cast
+//! Integral | Integral | Type cast
+//! Integral | Floating | Type cast
+//==============================================================================
+template <typename Result, typename Source,
 
-    return dot(a - b);
+    typename std::enable_if<
+        std::is_integral<Result>::value
+     && std::is_floating_point<Source>::value
+    >::type* = nullptr
+>
+Result round_up_if_integral(Source const x) BK_NOEXCEPT {
+    return (x >= Source{0})
+      ? static_cast<Result>(std::ceil(x))
+      : static_cast<Result>(std::floor(x));
 }
+//------------------------------------------------------------------------------
+template <typename Result, typename Source,
+    typename std::enable_if<!(
+        std::is_integral<Result>::value
+     && std::is_floating_point<Source>::value
+    )>::type* = nullptr
+>
+Result round_up_if_integral(Source const x) BK_NOEXCEPT {
+    return static_cast<Result>(x);
+}
+
+//==============================================================================
+//! Return the circle that rect can be inscribed in.
+//==============================================================================
+template <typename R = float, typename T = void,
+    typename std::enable_if<!(
+        std::is_integral<R>::value && is_integral_coordinate<T>::value
+    )>::type* = nullptr
+>
+circle<R> bounding_circle(axis_aligned_rect<T> const rect) BK_NOEXCEPT {
+    auto const p = rect.template center<float>();
+    auto const q = to_type<float>(rect.top_left());
+    auto const r = round_up_if_integral<R>(distance(p, q));
+
+    return {to_type<R>(p), r};
+}
+//------------------------------------------------------------------------------
+//! Integer coordinates: the center is rounded toward the top left, and the
+//! radius is the smallest integer reaching the (farther) bottom right corner.
+//------------------------------------------------------------------------------
+template <typename R = float, typename T = void,
+    typename std::enable_if<
+        std::is_integral<R>::value && is_integral_coordinate<T>::value
+    >::type* = nullptr
+>
+circle<R> bounding_circle(axis_aligned_rect<T> const rect) BK_NOEXCEPT {
+    auto const x = rect.left() + (std::int64_t {rect.right()}  - rect.left()) / 2;
+    auto const y = rect.top()  + (std::int64_t {rect.bottom()} - rect.top())  / 2;
+
+    point2d<std::int64_t> const p {x, y};
+    auto const r = detail::ceil_sqrt(static_cast<std::uint64_t>(
+        detail::distance2_wide(p, rect.bottom_right())
+    ));
+
+    return {to_type<R>(p), static_cast<R>(r)};
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Boolean intersections.
 ////////////////////////////////////////////////////////////////////////////////
@@ -663,10 +805,15 @@ T distance2(
 //==============================================================================
 //! circle <-> point intersection.
 //==============================================================================
-template <typename T>
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 bool intersects(circle<T> const c, point2d<T> const p) BK_NOEXCEPT {
     return distance2(p, c.p) < square_of(c.r);
 }
+//------------------------------------------------------------------------------
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+bool intersects(circle<T> const c, point2d<T> const p) BK_NOEXCEPT {
+    return detail::distance2_wide(p, c.p) < square_of(std::int64_t {c.r});
+}
 //==============================================================================
 //! point <-> circle intersection.
 //==============================================================================
@@ -677,7 +824,7 @@ bool intersects(point2d<T> const p, circle<T> const  c) BK_NOEXCEPT {
 //==============================================================================
 //! axis_aligned_rect <-> circle intersection.
 //==============================================================================
-template <typename T>
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 bool intersects(axis_aligned_rect<T> const r, circle<T> const c) BK_NOEXCEPT {
     return intersects(bounding_circle<T>(r), c) && (
         intersects(c, r.top_left())
@@ -686,6 +833,17 @@ bool intersects(axis_aligned_rect<T> const r, circle<T> const c) BK_NOEXCEPT {
      || intersects(c, r.bottom_right())
     );
 }
+//------------------------------------------------------------------------------
+//! Integer coordinates: a corner inside c implies that the bounding circles
+//! intersect, so only the corners are tested; all four, without branches.
+//------------------------------------------------------------------------------
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+bool intersects(axis_aligned_rect<T> const r, circle<T> const c) BK_NOEXCEPT {
+    return intersects(c, r.top_left())
+         | intersects(c, r.top_right())
+         | intersects(c, r.bottom_left())
+         | intersects(c, r.bottom_right());
+}
 //==============================================================================
 //! circle <-> axis_aligned_rect intersection.
 //==============================================================================
@@ -696,15 +854,56 @@ bool intersects(circle<T> const c, axis_aligned_rect<T> const r) BK_NOEXCEPT {
 //==============================================================================
 //! axis_aligned_rect <-> axis_aligned_rect intersection.
 //==============================================================================
-template <typename T>
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 bool intersects(axis_aligned_rect<T> const ra, axis_aligned_rect<T> const rb) BK_NOEXCEPT {
     return !(
-        ra.right()  < rb.left()
-     || ra.bottom() < rb.top()
-     || ra.left()   > rb.right()
-     || ra.top()    > rb.bottom()
+        ra.right()  <= rb.left()
+     || ra.bottom() <= rb.top()
+     || ra.left()   >= rb.right()
+     || ra.top()    >= rb.bottom()
     );
 }
+//------------------------------------------------------------------------------
+//! Integer coordinates: the four comparisons as a single compare of
+//! {ra.right, ra.bottom, rb.right, rb.bottom} > {rb.left, rb.top, ra.left, ra.top}.
+//------------------------------------------------------------------------------
+#if defined(BK_SIMD_SSE2)
+namespace detail {
+    //! {left, top, right, bottom} in the low 4 * sizeof(T) bytes.
+    template <typename T>
+    __m128i load_rect(axis_aligned_rect<T> const& r) BK_NOEXCEPT {
+        static_assert(sizeof(r) == 4 * sizeof(T), "unexpected layout.");
+
+        __m128i result = _mm_setzero_si128();
+        std::memcpy(&result, &r, sizeof(r));
+        return result;
+    }
+
+    inline bool intersects_simd(__m128i const a, __m128i const b, std::int32_t) BK_NOEXCEPT {
+        auto const lhs = _mm_unpackhi_epi64(a, b); // {ra.r, ra.b, rb.r, rb.b}
+        auto const rhs = _mm_unpacklo_epi64(b, a); // {rb.l, rb.t, ra.l, ra.t}
+        return _mm_movemask_epi8(_mm_cmpgt_epi32(lhs, rhs)) == 0xFFFF;
+    }
+
+    inline bool intersects_simd(__m128i const a, __m128i const b, std::int16_t) BK_NOEXCEPT {
+        auto const lhs = _mm_srli_si128(_mm_unpacklo_epi32(a, b), 8); // {ra.r, ra.b, rb.r, rb.b}
+        auto const rhs = _mm_unpacklo_epi32(b, a);                    // {rb.l, rb.t, ra.l, ra.t}
+        return (_mm_movemask_epi8(_mm_cmpgt_epi16(lhs, rhs)) & 0xFF) == 0xFF;
+    }
+} //namespace detail
+#endif
+
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+bool intersects(axis_aligned_rect<T> const ra, axis_aligned_rect<T> const rb) BK_NOEXCEPT {
+#if defined(BK_SIMD_SSE2)
+    return detail::intersects_simd(detail::load_rect(ra), detail::load_rect(rb), T {});
+#else
+    return (ra.right()  > rb.left())
+         & (ra.bottom() > rb.top())
+         & (rb.right()  > ra.left())
+         & (rb.bottom() > ra.top());
+#endif
+}
 //==============================================================================
 //! axis_aligned_rect <-> point intersection.
 //==============================================================================
@@ -725,13 +924,21 @@ bool intersects(point2d<T> const p, axis_aligned_rect<T> const r) BK_NOEXCEPT {
 //==============================================================================
 //! circle <-> circle intersection.
 //==============================================================================
-template <typename T>
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 bool intersects(circle<T> const a, circle<T> const b) BK_NOEXCEPT {
     auto const dist = distance2(a.p, b.p);
     auto const r    = square_of(a.r + b.r);
 
     return dist < r;
 }
+//------------------------------------------------------------------------------
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+bool intersects(circle<T> const a, circle<T> const b) BK_NOEXCEPT {
+    auto const dist = detail::distance2_wide(a.p, b.p);
+    auto const r    = square_of(std::int64_t {a.r} + b.r);
+
+    return dist < r;
+}
 ////////////////////////////////////////////////////////////////////////////////
 // Geometric intersections.
 ////////////////////////////////////////////////////////////////////////////////
@@ -739,7 +946,7 @@ bool intersects(circle<T> const a, circle<T> const b) BK_NOEXCEPT {
 //==============================================================================
 //! axis_aligned_rect <-> axis_aligned_rect intersection result.
 //==============================================================================
-template <typename T>
+template <typename T, disable_for_integral_coordinate_t<T>* = nullptr>
 auto intersection_of(axis_aligned_rect<T> const ra, axis_aligned_rect<T> const rb) BK_NOEXCEPT {
     auto const l = std::max(ra.left(),   rb.left());
     auto const r = std::min(ra.right(),  rb.right());
@@ -748,16 +955,40 @@ auto intersection_of(axis_aligned_rect<T> const ra, axis_aligned_rect<T> const r
 
     using rect = axis_aligned_rect<T>;
 
-    return intersection_result<rect>{{
+    return intersection_result<rect>{
         (l < r) && (t < b)
-      , {rect::allow_malformed{}, l, t, r, b}
-    }};
+      , rect {typename rect::allow_malformed{}, l, t, r, b}
+    };
 
 }
+//------------------------------------------------------------------------------
+//! Integer coordinates: min / max as selects and the validity test without a
+//! short circuit, so that there are no branches.
+//------------------------------------------------------------------------------
+template <typename T, enable_for_integral_coordinate_t<T>* = nullptr>
+auto intersection_of(axis_aligned_rect<T> const ra, axis_aligned_rect<T> const rb) BK_NOEXCEPT {
+    auto const select = [](bool const c, T const x, T const y) {
+        return static_cast<T>(y ^ ((x ^ y) & -static_cast<T>(c)));
+    };
+
+    auto const l = select(ra.left()   > rb.left(),   ra.left(),   rb.left());
+    auto const r = select(ra.right()  < rb.right(),  ra.right(),  rb.right());
+    auto const t = select(ra.top()    > rb.top(),    ra.top(),    rb.top());
+    auto const b = select(ra.bottom() < rb.bottom(), ra.bottom(), rb.bottom());
+
+    bool const valid = (l < r) & (t < b);
+
+    using rect = axis_aligned_rect<T>;
+
+    return intersection_result<rect>{
+        valid
+      , rect {typename rect::allow_malformed{}, l, t, r, b}
+    };
+}
 template <typename T>
 auto intersection_of(axis_aligned_rect<T> const r, point2d<T> const p) BK_NOEXCEPT {
     using type = intersection_result<point2d<T>>;
-    return type{intersects{r, p}, p};
+    return type{intersects(r, p), p};
 }
 //------------------------------------------------------------------------------
 template <typename T>
@@ -782,63 +1013,18 @@ vector2d<T> random_direction(F& random) BK_NOEXCEPT {
     return {x, y};
 }
 
-//==============================================================================
-//! Special rounding.
-//!
-//! Source   | Result   | Action
-//! ---------|----------|-------------------------------------------------------
-//! Floating | Integral | Round to next most negative / positive integer
-//! Floating | Floating | Type cast
-//! Integral | Integral | Type cast
-//! Integral | Floating | Type cast
-//==============================================================================
-template <typename Result, typename Source,
-
-    typename std::enable_if<
-        std::is_integral<Result>::value
-     && std::is_floating_point<Source>::value
-    >::type* = 0
->
-Result round_up_if_integral(Source const x) BK_NOEXCEPT {
-    return (x >= Source{0})
-      ? static_cast<Result>(std::ceil(x))
-      : static_cast<Result>(std::floor(x));
-}
-//------------------------------------------------------------------------------
-template <typename Result, typename Source,
-    typename std::enable_if<!(
-        std::is_integral<Result>::value
-     && std::is_floating_point<Source>::value
-    )>::type* = 0
->
-Result round_up_if_integral(Source const x) BK_NOEXCEPT {
-    return static_cast<Result>(x);
-}
-
-//==============================================================================
-//! Return the circle that rect can be inscribed in.
-//==============================================================================
-template <typename R = float, typename T = void>
-circle<R> bounding_circle(axis_aligned_rect<T> const rect) BK_NOEXCEPT {
-    auto const p = rect.center<float>();
-    auto const q = to_type<float>(rect.top_left());
-    auto const r = round_up_if_integral<R>(distance(p, q));
-
-    return {to_type<R>(p), r};
-}
-
 //==============================================================================
 //! Rounds @c n to the next most negative / positive integer value.
 //==============================================================================
 template <typename T
-  , enable_for_floating_point_t<T>* = 0 //floating point types.
+  , enable_for_floating_point_t<T>* = nullptr //floating point types.
 >
 T round_toward(T const n) BK_NOEXCEPT {
     return n >= T{0} ? std::ceil(n) : std::floor(n);
 }
 //------------------------------------------------------------------------------
 template <typename T
-  , enable_for_integral_t<T>* = 0 //integral types.
+  , enable_for_integral_t<T>* = nullptr //integral types.
 >
 T round_toward(T const n) BK_NOEXCEPT {
     return n;
@@ -867,12 +1053,19 @@ point2d<R> round_toward(point2d<T> const p, vector2d<U> const v) BK_NOEXCEPT {
 //==============================================================================
 //! Return a vector between the centers of @c a and @c b whose magnitude is the
 //! distance between their perimeters.
+//!
+//! The same as -distance<float>(a, b) * direction<float>(a.p - b.p), but with a
+//! single square root.
 //==============================================================================
 template <typename T, typename U>
 vector2d<float> separation_vector(bklib::circle<T> const a, bklib::circle<U> const b) BK_NOEXCEPT {
-    auto const dir = bklib::direction<float>(a.p - b.p);
-    auto const mag = -bklib::distance<float>(a, b);
-    return mag * dir;
-};
+    auto const v   = a.p - b.p;
+    auto const len = std::sqrt(dot(v));
+
+    auto const mag = static_cast<float>(len);
+    vector2d<float> const dir = is_equal(mag, 0.0f) ? to_type<float>(v) : (v / mag);
+
+    return -static_cast<float>(len - a.r - b.r) * dir;
+}
 
 } //namespace bklib
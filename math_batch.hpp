@@ -0,0 +1,122 @@
+//==============================================================================
+//! Batch transforms, magnitudes and directions of float points and vectors,
+//! and separation vectors of circles.
+//!
+//! Each function has an array of structures form (point2d / vector2d arrays)
+//! and a structure of arrays form (separate x and y arrays), and runs the
+//! widest kernel the processor supports (chosen at run time: SSE4.1, AVX2 or
+//! AVX-512). Results match the scalar functions of math.hpp lane for lane:
+//! the kernels use the same operations in the same order, without fused
+//! multiply-adds.
+//!
+//! Outputs may be the same arrays as the inputs, but must not otherwise
+//! overlap them.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <cstddef>
+
+#include "config.hpp"
+#include "math.hpp"
+
+namespace bklib {
+//==============================================================================
+//! An affine 2D transform: (x, y) -> (a*x + c*y + tx, b*x + d*y + ty).
+//==============================================================================
+struct transform2d {
+    float a  = 1.0f;
+    float b  = 0.0f;
+    float c  = 0.0f;
+    float d  = 1.0f;
+    float tx = 0.0f;
+    float ty = 0.0f;
+};
+//==============================================================================
+//! The transform of a column major 3x3 matrix indexed as m[column][row] (as is
+//! glm::mat3).
+//! @pre The last row is {0, 0, 1}; it is not used.
+//==============================================================================
+template <typename Matrix>
+transform2d make_transform2d(Matrix const& m) BK_NOEXCEPT {
+    transform2d result;
+
+    result.a  = m[0][0];
+    result.b  = m[0][1];
+    result.c  = m[1][0];
+    result.d  = m[1][1];
+    result.tx = m[2][0];
+    result.ty = m[2][1];
+
+    return result;
+}
+//==============================================================================
+//! Transform a single point; the reference for transform_points.
+//==============================================================================
+inline point2d<float> transform(transform2d const& m, point2d<float> const p) BK_NOEXCEPT {
+    return {
+        m.a * p.x + m.c * p.y + m.tx
+      , m.b * p.x + m.d * p.y + m.ty
+    };
+}
+//==============================================================================
+//! The instruction sets with batch kernels, in increasing order of width.
+//==============================================================================
+enum class simd_level : int {
+    scalar, sse41, avx2, avx512
+};
+
+//! The widest level supported by both this build and the processor.
+simd_level detected_simd_level() BK_NOEXCEPT;
+
+//! The level the batch functions use; detected_simd_level() unless changed.
+simd_level current_simd_level() BK_NOEXCEPT;
+
+//! Use at most @c level from now on (to compare levels, say); levels wider
+//! than detected_simd_level() are clamped to it.
+//! @returns The level now in use.
+simd_level set_simd_level(simd_level level) BK_NOEXCEPT;
+
+//==============================================================================
+//! out[i] = transform(m, in[i]) for i in [0, n).
+//==============================================================================
+void transform_points(
+    point2d<float> const* in, size_t n, transform2d const& m, point2d<float>* out
+) BK_NOEXCEPT;
+
+//! Structure of arrays form.
+void transform_points(
+    float const* x, float const* y, size_t n, transform2d const& m
+  , float* out_x, float* out_y
+) BK_NOEXCEPT;
+//==============================================================================
+//! out[i] = magnitude<float>(in[i]) for i in [0, n).
+//==============================================================================
+void magnitudes(vector2d<float> const* in, size_t n, float* out) BK_NOEXCEPT;
+
+//! Structure of arrays form.
+void magnitudes(float const* x, float const* y, size_t n, float* out) BK_NOEXCEPT;
+//==============================================================================
+//! out[i] = direction<float>(in[i]) for i in [0, n); vectors of (nearly) zero
+//! length are copied as is.
+//==============================================================================
+void directions(vector2d<float> const* in, size_t n, vector2d<float>* out) BK_NOEXCEPT;
+
+//! Structure of arrays form.
+void directions(
+    float const* x, float const* y, size_t n, float* out_x, float* out_y
+) BK_NOEXCEPT;
+//==============================================================================
+//! out[i] = separation_vector(a[i], b[i]) for i in [0, n), where a[i] is the
+//! circle {{ax[i], ay[i]}, ar[i]} and b[i] likewise.
+//!
+//! Structure of arrays form only: see circle_collision.hpp for gathering the
+//! circles of pairs into it.
+//==============================================================================
+void separation_vectors(
+    float const* ax, float const* ay, float const* ar
+  , float const* bx, float const* by, float const* br
+  , size_t n, float* out_x, float* out_y
+) BK_NOEXCEPT;
+
+} //namespace bklib
@@ -0,0 +1,217 @@
+//==============================================================================
+//! Binary encoding of the math.hpp types.
+//!
+//! Each type is encoded as its scalar components, in the order given by
+//! components<T>, as fixed width little-endian values; rectangles are
+//! {left, top, right, bottom} and circles {x, y, r}. Where the host layout of
+//! a type matches its encoding, bulk encoding and decoding is a single memcpy,
+//! so a snapshot can be loaded straight from a memory mapped file.
+//!
+//! Integer coordinates can also be delta encoded: each component as a zigzag
+//! varint of its difference from the same component of the previous value,
+//! which for spatially coherent data is typically one or two bytes.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <type_traits>
+
+#include "binary.hpp"
+#include "math.hpp"
+
+namespace bklib {
+namespace binary {
+//==============================================================================
+//! The scalar components of an encodable type.
+//==============================================================================
+template <typename T>
+struct components;
+
+template <typename T>
+struct components<point2d<T>> {
+    using scalar = T;
+    static BK_CONSTEXPR size_t const size = 2;
+
+    static void get(point2d<T> const& p, T* const out) BK_NOEXCEPT {
+        out[0] = p.x;
+        out[1] = p.y;
+    }
+
+    static point2d<T> make(T const* const in) BK_NOEXCEPT {
+        return point2d<T> {in[0], in[1]};
+    }
+};
+
+template <typename T>
+struct components<vector2d<T>> {
+    using scalar = T;
+    static BK_CONSTEXPR size_t const size = 2;
+
+    static void get(vector2d<T> const& v, T* const out) BK_NOEXCEPT {
+        out[0] = v.x;
+        out[1] = v.y;
+    }
+
+    static vector2d<T> make(T const* const in) BK_NOEXCEPT {
+        return vector2d<T> {in[0], in[1]};
+    }
+};
+
+template <typename T>
+struct components<circle<T>> {
+    using scalar = T;
+    static BK_CONSTEXPR size_t const size = 3;
+
+    static void get(circle<T> const& c, T* const out) BK_NOEXCEPT {
+        out[0] = c.p.x;
+        out[1] = c.p.y;
+        out[2] = c.r;
+    }
+
+    static circle<T> make(T const* const in) BK_NOEXCEPT {
+        return circle<T> {{in[0], in[1]}, in[2]};
+    }
+};
+
+template <typename T>
+struct components<axis_aligned_rect<T>> {
+    using scalar = T;
+    static BK_CONSTEXPR size_t const size = 4;
+
+    static void get(axis_aligned_rect<T> const& r, T* const out) BK_NOEXCEPT {
+        out[0] = r.left();
+        out[1] = r.top();
+        out[2] = r.right();
+        out[3] = r.bottom();
+    }
+
+    //! Rectangles are decoded as-is, well formed or not.
+    static axis_aligned_rect<T> make(T const* const in) BK_NOEXCEPT {
+        using rect = axis_aligned_rect<T>;
+        return rect {typename rect::allow_malformed {}, in[0], in[1], in[2], in[3]};
+    }
+};
+
+//==============================================================================
+//! Whether the host representation of @c T is its encoding.
+//==============================================================================
+template <typename T>
+struct is_raw_layout : std::integral_constant<bool,
+    HOST_IS_LITTLE_ENDIAN
+ && std::is_trivially_copyable<T>::value
+ && sizeof(T) == components<T>::size * sizeof(typename components<T>::scalar)
+> {};
+
+//==============================================================================
+template <typename T>
+void encode(writer& out, T const& value) {
+    using traits = components<T>;
+
+    typename traits::scalar scalars[traits::size];
+    traits::get(value, scalars);
+
+    for (auto const s : scalars) {
+        out.write(s);
+    }
+}
+
+template <typename T>
+void decode(reader& in, T& out) {
+    using traits = components<T>;
+
+    typename traits::scalar scalars[traits::size];
+    for (auto& s : scalars) {
+        s = in.template read<typename traits::scalar>();
+    }
+
+    out = traits::make(scalars);
+}
+
+template <typename T>
+T decode(reader& in) {
+    using traits = components<T>;
+
+    typename traits::scalar scalars[traits::size];
+    for (auto& s : scalars) {
+        s = in.template read<typename traits::scalar>();
+    }
+
+    return traits::make(scalars);
+}
+
+//==============================================================================
+//! Encode @c count values; the same bytes as encoding each in turn.
+//==============================================================================
+template <typename T>
+void encode_span(writer& out, T const* const first, size_t const count) {
+    if (is_raw_layout<T>::value) {
+        out.write_bytes(first, count * sizeof(T));
+        return;
+    }
+
+    out.reserve(count * components<T>::size * sizeof(typename components<T>::scalar));
+
+    for (size_t i = 0; i < count; ++i) {
+        encode(out, first[i]);
+    }
+}
+
+template <typename T>
+void decode_span(reader& in, T* const first, size_t const count) {
+    if (is_raw_layout<T>::value) {
+        in.read_bytes(first, count * sizeof(T));
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        decode(in, first[i]);
+    }
+}
+
+//==============================================================================
+//! Delta encode @c count values with integer components.
+//==============================================================================
+template <typename T>
+void encode_delta(writer& out, T const* const first, size_t const count) {
+    using traits = components<T>;
+    using scalar = typename traits::scalar;
+
+    static_assert(std::is_integral<scalar>::value, "integer components only");
+
+    // differences are taken modulo 2^64, so any value round-trips.
+    uint64_t previous[traits::size] = {};
+    scalar   current[traits::size];
+
+    for (size_t i = 0; i < count; ++i) {
+        traits::get(first[i], current);
+
+        for (size_t j = 0; j < traits::size; ++j) {
+            auto const value = static_cast<uint64_t>(static_cast<int64_t>(current[j]));
+            out.write_svarint(static_cast<int64_t>(value - previous[j]));
+            previous[j] = value;
+        }
+    }
+}
+
+template <typename T>
+void decode_delta(reader& in, T* const first, size_t const count) {
+    using traits = components<T>;
+    using scalar = typename traits::scalar;
+
+    static_assert(std::is_integral<scalar>::value, "integer components only");
+
+    uint64_t previous[traits::size] = {};
+    scalar   current[traits::size];
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < traits::size; ++j) {
+            previous[j] += static_cast<uint64_t>(in.read_svarint());
+            current[j]   = static_cast<scalar>(previous[j]);
+        }
+
+        first[i] = traits::make(current);
+    }
+}
+
+} //namespace binary
+} //namespace bklib
@@ -0,0 +1,330 @@
+//==============================================================================
+//! Scratch and fixed size allocators.
+//!
+//! frame_arena is a bump allocator for memory that lives until the end of a
+//! frame; pool<T> recycles fixed size objects through a free list. Both keep
+//! the memory they have taken from the global heap, so once a program reaches
+//! its steady state they satisfy every allocation without calling malloc.
+//! arena_allocator and pool_allocator adapt them for the standard containers.
+//!
+//! None of these are thread safe; use one per thread.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+#include "assert.hpp"
+
+//! Whether pools count their live objects; on by default in debug builds.
+#if !defined(BK_MEMORY_STATS)
+#   if defined(NDEBUG)
+#       define BK_MEMORY_STATS 0
+#   else
+#       define BK_MEMORY_STATS 1
+#   endif
+#endif
+
+namespace bklib {
+//==============================================================================
+//! Usage of an allocator.
+//==============================================================================
+struct allocator_stats {
+    size_t in_use;            //!< Bytes (arenas) or objects (pools) in use now.
+    size_t high_water;        //!< The most that have been in use at once.
+    size_t heap_allocations;  //!< Blocks taken from the global heap.
+};
+
+//==============================================================================
+//! A bump allocator for per-frame scratch memory.
+//!
+//! Allocation is a pointer increment within the current block; individual
+//! allocations are not freed (but see deallocate()), everything is released at
+//! once by reset(). If a frame overflows the first block, reset() replaces the
+//! blocks with a single one large enough for the whole frame, so that the
+//! arena stops allocating once it has seen its largest frame.
+//!
+//! Destructors of objects created with make() are never run.
+//==============================================================================
+class frame_arena {
+public:
+    static BK_CONSTEXPR size_t const DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    explicit frame_arena(size_t block_size = DEFAULT_BLOCK_SIZE);
+    ~frame_arena();
+
+    BK_NO_COPY_ASSIGN(frame_arena);
+
+    //! @pre align is a power of two.
+    void* allocate(size_t const size, size_t const align = alignof(std::max_align_t)) {
+        BK_ASSERT(align && !(align & (align - 1)));
+
+        auto const first = (reinterpret_cast<std::uintptr_t>(pos_) + (align - 1))
+                         & ~static_cast<std::uintptr_t>(align - 1);
+
+        if (first + size > reinterpret_cast<std::uintptr_t>(end_)) {
+            return allocate_slow_(size, align);
+        }
+
+        pos_ = reinterpret_cast<char*>(first + size);
+        return reinterpret_cast<void*>(first);
+    }
+
+    //! Uninitialized space for @c n objects of type @c T.
+    template <typename T>
+    T* allocate_array(size_t const n) {
+        return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    //! Give back the most recent allocation; anything else is left until reset().
+    void deallocate(void* const p, size_t const size) BK_NOEXCEPT {
+        if (static_cast<char*>(p) + size == pos_) {
+            pos_ = static_cast<char*>(p);
+        }
+    }
+
+    //! Release everything allocated since the last reset.
+    void reset();
+
+    //! Bytes allocated since the last reset, including alignment padding.
+    size_t used() const BK_NOEXCEPT;
+    size_t capacity() const BK_NOEXCEPT;
+
+    allocator_stats stats() const BK_NOEXCEPT;
+private:
+    struct block {
+        char*  data;
+        size_t size;
+    };
+
+    void* allocate_slow_(size_t size, size_t align);
+    void  add_block_(size_t size);
+    void  free_blocks_() BK_NOEXCEPT;
+
+    std::vector<block> blocks_;
+    size_t block_size_;
+    size_t retired_ = 0; //!< Bytes used in all but the last block.
+
+    char* pos_ = nullptr;
+    char* end_ = nullptr;
+
+    size_t high_water_       = 0;
+    size_t heap_allocations_ = 0;
+};
+
+//==============================================================================
+//! A free list of fixed size, uninitialized, objects.
+//!
+//! Memory is taken from the heap in chunks of @c objects_per_chunk objects and
+//! is only returned when the pool is destroyed.
+//==============================================================================
+class fixed_pool {
+public:
+    static BK_CONSTEXPR size_t const DEFAULT_CHUNK_OBJECTS = 64;
+
+    //! @pre align is a power of two no greater than alignof(std::max_align_t).
+    fixed_pool(size_t size, size_t align, size_t objects_per_chunk = DEFAULT_CHUNK_OBJECTS);
+
+    BK_NO_COPY_ASSIGN(fixed_pool);
+
+    void* allocate() {
+        if (!free_) {
+            add_chunk_();
+        }
+
+        auto const result = free_;
+        free_ = free_->next;
+
+#if BK_MEMORY_STATS
+        if (++in_use_ > high_water_) {
+            high_water_ = in_use_;
+        }
+#endif
+
+        return result;
+    }
+
+    //! @pre p was allocated from this pool.
+    void deallocate(void* const p) BK_NOEXCEPT {
+        BK_ASSERT(p != nullptr);
+
+        auto const node = static_cast<free_node*>(p);
+        node->next = free_;
+        free_ = node;
+
+#if BK_MEMORY_STATS
+        --in_use_;
+#endif
+    }
+
+    //! The size and alignment of each object; at least those requested.
+    size_t object_size()  const BK_NOEXCEPT { return size_; }
+    size_t object_align() const BK_NOEXCEPT { return align_; }
+
+    //! Objects in use and their high-water mark are counted only when
+    //! BK_MEMORY_STATS is set.
+    allocator_stats stats() const BK_NOEXCEPT;
+private:
+    struct free_node {
+        free_node* next;
+    };
+
+    void add_chunk_();
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+
+    size_t size_;
+    size_t align_;
+    size_t objects_per_chunk_;
+
+    free_node* free_ = nullptr;
+
+    size_t in_use_     = 0;
+    size_t high_water_ = 0;
+};
+
+//==============================================================================
+//! A fixed_pool of T.
+//==============================================================================
+template <typename T>
+class pool {
+public:
+    explicit pool(size_t const objects_per_chunk = fixed_pool::DEFAULT_CHUNK_OBJECTS)
+      : pool_ {sizeof(T), alignof(T), objects_per_chunk}
+    {
+    }
+
+    //! Uninitialized storage for one T.
+    T* allocate() { return static_cast<T*>(pool_.allocate()); }
+    void deallocate(T* const p) BK_NOEXCEPT { pool_.deallocate(p); }
+
+    template <typename... Args>
+    T* make(Args&&... args) {
+        auto const p = allocate();
+
+        try {
+            return new (p) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(p);
+            throw;
+        }
+    }
+
+    //! Destroy and deallocate an object from make().
+    void destroy(T* const p) BK_NOEXCEPT {
+        p->~T();
+        deallocate(p);
+    }
+
+    allocator_stats stats() const BK_NOEXCEPT { return pool_.stats(); }
+
+    fixed_pool&       storage()       BK_NOEXCEPT { return pool_; }
+    fixed_pool const& storage() const BK_NOEXCEPT { return pool_; }
+private:
+    fixed_pool pool_;
+};
+
+//==============================================================================
+//! A standard allocator drawing from a frame_arena.
+//!
+//! Containers using it must not outlive the arena's next reset().
+//==============================================================================
+template <typename T>
+class arena_allocator {
+public:
+    template <typename U> friend class arena_allocator;
+
+    using value_type = T;
+
+    arena_allocator(frame_arena& arena) BK_NOEXCEPT : arena_ {&arena} {}
+
+    template <typename U>
+    arena_allocator(arena_allocator<U> const& other) BK_NOEXCEPT : arena_ {other.arena_} {}
+
+    T* allocate(size_t const n) {
+        return arena_->allocate_array<T>(n);
+    }
+
+    void deallocate(T* const p, size_t const n) BK_NOEXCEPT {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(arena_allocator<U> const& rhs) const BK_NOEXCEPT { return arena_ == rhs.arena_; }
+    template <typename U>
+    bool operator!=(arena_allocator<U> const& rhs) const BK_NOEXCEPT { return arena_ != rhs.arena_; }
+private:
+    frame_arena* arena_;
+};
+
+//==============================================================================
+//! A standard allocator drawing single objects from a fixed_pool.
+//!
+//! Intended for node based containers (list, map, set), whose node types are
+//! not nameable: single objects that fit the pool's object size and alignment
+//! come from the pool, anything else from the global heap.
+//==============================================================================
+template <typename T>
+class pool_allocator {
+public:
+    template <typename U> friend class pool_allocator;
+
+    using value_type = T;
+
+    pool_allocator(fixed_pool& pool) BK_NOEXCEPT : pool_ {&pool} {}
+
+    template <typename U>
+    pool_allocator(pool_allocator<U> const& other) BK_NOEXCEPT : pool_ {other.pool_} {}
+
+    T* allocate(size_t const n) {
+        return static_cast<T*>(from_pool_(n)
+          ? pool_->allocate()
+          : ::operator new(n * sizeof(T))
+        );
+    }
+
+    void deallocate(T* const p, size_t const n) BK_NOEXCEPT {
+        if (from_pool_(n)) {
+            pool_->deallocate(p);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(pool_allocator<U> const& rhs) const BK_NOEXCEPT { return pool_ == rhs.pool_; }
+    template <typename U>
+    bool operator!=(pool_allocator<U> const& rhs) const BK_NOEXCEPT { return pool_ != rhs.pool_; }
+private:
+    bool from_pool_(size_t const n) const BK_NOEXCEPT {
+        return n == 1
+            && sizeof(T)  <= pool_->object_size()
+            && alignof(T) <= pool_->object_align();
+    }
+
+    fixed_pool* pool_;
+};
+
+//==============================================================================
+// Per-frame containers.
+//==============================================================================
+template <typename T>
+using frame_vector = std::vector<T, arena_allocator<T>>;
+
+using frame_string = std::basic_string<char, std::char_traits<char>, arena_allocator<char>>;
+
+} //namespace bklib
@@ -3,12 +3,12 @@
 #include <chrono>
 #include <array>
 
-#include <boost/circular_buffer.hpp>
-
 #include "types.hpp"
 #include "callback.hpp"
 #include "util.hpp"
 #include "math.hpp"
+#include "filter.hpp"
+#include "ring.hpp"
 #include "macros.hpp"
 #include "assert.hpp"
 
@@ -28,14 +28,53 @@ BK_DECLARE_EVENT(on_mouse_up,        void (mouse& m, int x, int y, unsigned butt
 BK_DECLARE_EVENT(on_mouse_wheel_v,   void (mouse& m, int delta));
 BK_DECLARE_EVENT(on_mouse_wheel_h,   void (mouse& m, int delta));
 //==============================================================================
+//! Incremental estimates of velocity and acceleration from displacements.
+//!
+//! Each sample costs O(1): the estimates are exponentially smoothed finite
+//! differences, in units per second (squared), as of the latest sample.
+//! The displacement of a sample with no time elapsed is carried into the next.
+//==============================================================================
+class motion_estimator {
+public:
+    using vector = vector2d<float>;
+
+    //! @param alpha The smoothing factor; @see ema_filter.
+    explicit motion_estimator(float alpha = 0.5f) BK_NOEXCEPT;
+
+    //! Add a displacement of @c delta at @c when; the first sample only
+    //! starts the clock.
+    //! @returns The seconds since the previous sample; 0 for the first.
+    float push(vector delta, time_point when) BK_NOEXCEPT;
+
+    vector velocity()     const BK_NOEXCEPT { return velocity_.value(); }
+    vector acceleration() const BK_NOEXCEPT { return acceleration_.value(); }
+    float  speed()        const BK_NOEXCEPT { return magnitude<float>(velocity()); }
+
+    bool       empty()       const BK_NOEXCEPT { return empty_; }
+    time_point last_sample() const BK_NOEXCEPT { return last_; }
+
+    void reset() BK_NOEXCEPT;
+private:
+    ema_filter<vector> velocity_;
+    ema_filter<vector> acceleration_;
+    vector             pending_ {};  //!< Displacement not yet timed.
+    time_point         last_;
+    bool               empty_ = true;
+};
+//==============================================================================
 //! The history and current state of the mouse.
+//!
+//! Besides the raw histories, tracks the motion of both histories, a smoothed
+//! (EMA) and a filtered ("1 euro") absolute position, and per button click
+//! counts and drags; all are updated in O(1) by the push_* and set_button.
 //==============================================================================
 class mouse {
 public:
     using coord_t = int16_t;
+    using point   = point2d<coord_t>;
 
     static BK_CONSTEXPR size_t const BUTTON_COUNT = 5;   //!< Number of mouse buttons.
-    static BK_CONSTEXPR size_t const HISTORY_SIZE = 100; //!< Size of the history.
+    static BK_CONSTEXPR size_t const HISTORY_SIZE = 128; //!< Size of the history.
 
     struct record {
         time_point time;
@@ -43,6 +82,30 @@ public:
         coord_t    y;
     };
 
+    //! The HISTORY_SIZE most recent records, newest first, as parallel arrays.
+    //!
+    //! Times are kept as 32 bit microsecond offsets from an epoch (the first
+    //! record's time), which is moved forward when they would overflow. Slots
+    //! not yet pushed read as {epoch, 0, 0}.
+    class history {
+    public:
+        void push(record r) BK_NOEXCEPT;
+
+        //! @pre i < HISTORY_SIZE.
+        record operator[](size_t const i) const BK_NOEXCEPT {
+            auto const s = cursor_.slot(i);
+            return {epoch_ + std::chrono::microseconds {time_[s]}, x_[s], y_[s]};
+        }
+
+        size_t size() const BK_NOEXCEPT { return cursor_.size(); }
+    private:
+        ring_cursor<HISTORY_SIZE>          cursor_;
+        std::array<uint32_t, HISTORY_SIZE> time_ {};
+        std::array<coord_t,  HISTORY_SIZE> x_    {};
+        std::array<coord_t,  HISTORY_SIZE> y_    {};
+        time_point                         epoch_;
+    };
+
     enum class button_state : uint8_t {
         up, down
     };
@@ -50,66 +113,87 @@ public:
     struct button_record {
         time_point   time;
         button_state state;
+        unsigned     clicks;   //!< Successive clicks, including the last; 2 for a double click.
+        bool         dragging; //!< Moved beyond the drag distance since going down.
+        point        origin;   //!< Where the button last went down.
 
         explicit operator bool() const BK_NOEXCEPT {
             return state == button_state::down;
         }
     };
 
-    mouse() {
-        rel_history_.set_capacity(HISTORY_SIZE);
-        abs_history_.set_capacity(HISTORY_SIZE);
-
-        auto const now = clock_t::now();
-
-        record        const rec  { now, 0, 0 };
-        button_record const brec { now, button_state::up };
-
-        for (size_t i = 0 ; i < HISTORY_SIZE; ++i) {
-            rel_history_.push_front(rec);
-            abs_history_.push_front(rec);
-        }
-
-        for (size_t i = 0; i < BUTTON_COUNT; ++i) {
-            button_state_[i] = brec;
-        }
-    }
+    //! Thresholds for clicks, drags and hovering; distances are in the units
+    //! of the absolute positions.
+    struct gesture_settings {
+        std::chrono::milliseconds double_click_time     {500};
+        int                       double_click_distance {4};
+        int                       drag_distance         {4};
+        std::chrono::milliseconds hover_time            {400};
+        int                       hover_distance        {4};
+    };
 
+    using position_filter = one_euro_filter<point2d<float>>;
 
     record absolute(size_t i = 0) const {
-        return *(abs_history_.begin() + i);
+        return abs_history_[i];
     }
 
     record relative(size_t i = 0) const {
-        return *(rel_history_.begin() + i);
+        return rel_history_[i];
     }
 
-    void push_absolute(coord_t x, coord_t y, time_point when) {
-        abs_history_.push_front(record {when, x, y});
+    point position() const {
+        auto const r = absolute();
+        return {r.x, r.y};
     }
 
-    void push_relative(coord_t x, coord_t y, time_point when) {
-        rel_history_.push_front(record {when, x, y});
-    }
+    void push_absolute(coord_t x, coord_t y, time_point when);
+    void push_relative(coord_t x, coord_t y, time_point when);
 
-    void set_button(size_t button, time_point when, bool down = true) {
-        BK_ASSERT(button < BUTTON_COUNT);
-
-        button_state_[button].state = down
-          ? button_state::down
-          : button_state::up;
-        button_state_[button].time  = when;
-    }
+    //! @returns The updated record for @c button: on going down, clicks is 2
+    //! for a double click; on going up, dragging tells a drag from a click.
+    button_record set_button(size_t button, time_point when, bool down = true);
 
     button_record button(size_t button) const {
         BK_ASSERT(button < BUTTON_COUNT);
         return button_state_[button];
     }
+    //--------------------------------------------------------------------------
+    //! Motion of the absolute (pointer) and relative (raw device) positions.
+    motion_estimator const& absolute_motion() const BK_NOEXCEPT { return abs_motion_; }
+    motion_estimator const& relative_motion() const BK_NOEXCEPT { return rel_motion_; }
+
+    //! The absolute position smoothed by an exponential moving average.
+    point2d<float> smoothed_position() const BK_NOEXCEPT { return smoothed_.value(); }
+    //! The absolute position filtered to remove jitter with little lag.
+    point2d<float> filtered_position() const BK_NOEXCEPT { return filtered_.value(); }
+
+    void set_position_filters(float ema_alpha, position_filter::params params);
+    //--------------------------------------------------------------------------
+    gesture_settings const& get_gesture_settings() const BK_NOEXCEPT { return gestures_; }
+    void set_gesture_settings(gesture_settings const& settings) { gestures_ = settings; }
+
+    //! Poll whether the pointer has come to rest for the hover time.
+    //! @returns true once per rest, when it begins.
+    bool update_hover(time_point now) BK_NOEXCEPT;
+
+    bool is_hovering() const BK_NOEXCEPT { return hovering_; }
 private:
-    std::array<button_record, BUTTON_COUNT> button_state_;
+    std::array<button_record, BUTTON_COUNT> button_state_ {};
+    std::array<time_point,    BUTTON_COUNT> last_down_    {};
+
+    history rel_history_;
+    history abs_history_;
+
+    motion_estimator             abs_motion_;
+    motion_estimator             rel_motion_;
+    ema_filter<point2d<float>>   smoothed_;
+    position_filter              filtered_;
 
-    boost::circular_buffer<record> rel_history_;
-    boost::circular_buffer<record> abs_history_;
+    gesture_settings gestures_;
+    point            hover_anchor_ {0, 0};
+    time_point       hover_since_;
+    bool             hovering_ = false;
 };
 
 //class mouse {
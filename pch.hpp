@@ -38,7 +38,6 @@
 #include <condition_variable>
 #include <iostream>
 #include <ostream>
-#include <strstream>
 #include <vector>
 #include <deque>
 #include <istream>
@@ -63,7 +62,9 @@
 #include <cstddef>
 #include <cstdint>
 
-#pragma warning(push, 3)
+#if defined(_MSC_VER)
+#   pragma warning(push, 3)
+#endif
 
     #include <boost/predef.h>
     #include <boost/exception/all.hpp>
@@ -73,9 +74,6 @@
     #include <boost/variant.hpp>
     #include <boost/utility/string_ref.hpp>
 
-    #include <jsoncpp/json.h>
-    #if defined(BOOST_COMP_MSVC)
-    #   pragma comment(lib, "jsoncpp_mtd.lib")
-    #endif
-
-#pragma warning(pop)
+#if defined(_MSC_VER)
+#   pragma warning(pop)
+#endif
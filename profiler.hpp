@@ -0,0 +1,89 @@
+//==============================================================================
+//! Scoped timing zones, exported in the Chrome trace event format.
+//!
+//! BK_PROFILE_ZONE("name") times the rest of the enclosing scope. Each thread
+//! records its zones into its own ring buffer, so recording takes no locks;
+//! when a buffer is full the oldest zones are overwritten. The resulting trace
+//! can be loaded into chrome://tracing or any other trace_event viewer.
+//!
+//! Recording is off until profiler::enable(); while off, a zone costs a single
+//! relaxed load. Defining BK_NO_PROFILE removes the zones entirely.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <atomic>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+
+namespace bklib {
+namespace json { class output_buffer; }
+
+namespace profiler {
+//==============================================================================
+namespace detail {
+    extern std::atomic<bool> enabled;
+
+    //! Nanoseconds since the profiler started.
+    uint64_t now() BK_NOEXCEPT;
+
+    //! Record a zone for the calling thread.
+    void record(char const* name, uint64_t begin, uint64_t end) BK_NOEXCEPT;
+} //namespace detail
+
+//! Zones kept per thread; the newest BUFFER_SIZE - 1 of them are exported, the
+//! oldest slot being the next one the thread writes.
+static BK_CONSTEXPR size_t const BUFFER_SIZE = 1 << 14;
+
+inline bool is_enabled() BK_NOEXCEPT {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void enable(bool on = true) BK_NOEXCEPT;
+
+//! The name shown for the calling thread; by default its registration order.
+void set_thread_name(string_ref name);
+
+//! Discard everything recorded so far.
+//! @pre no other thread is recording.
+void clear();
+
+//! Write the zones recorded by all threads as a trace_event JSON object.
+void write_chrome_trace(json::output_buffer& out);
+
+//==============================================================================
+//! Times the scope it is declared in; @see BK_PROFILE_ZONE.
+//!
+//! @c name must be a string with static storage duration, such as a literal.
+//==============================================================================
+class zone {
+public:
+    explicit zone(char const* const name) BK_NOEXCEPT
+      : name_  {is_enabled() ? name : nullptr}
+      , begin_ {name_ ? detail::now() : 0}
+    {
+    }
+
+    ~zone() {
+        if (name_) {
+            detail::record(name_, begin_, detail::now());
+        }
+    }
+
+    BK_DELETE_ALL(zone);
+private:
+    char const* name_; //!< nullptr if not recording.
+    uint64_t    begin_;
+};
+
+} //namespace profiler
+} //namespace bklib
+
+#if defined(BK_NO_PROFILE)
+#   define BK_PROFILE_ZONE(NAME) (void)0
+#else
+#   define BK_PROFILE_ZONE(NAME) \
+::bklib::profiler::zone const BK_UNIQUE_ID(bk_profile_zone_) {NAME}
+#endif
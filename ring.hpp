@@ -0,0 +1,101 @@
+//==============================================================================
+//! Fixed capacity ring buffers with inline storage.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "config.hpp"
+#include "assert.hpp"
+#include "types.hpp"
+
+namespace bklib {
+//==============================================================================
+//! The position of the newest element of a ring of capacity N, and the number
+//! of elements pushed (up to N); shared by parallel (structure of arrays)
+//! storage so that the columns advance together.
+//!
+//! @tparam N A power of two, so that wrapping is a mask.
+//==============================================================================
+template <size_t N>
+class ring_cursor {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two.");
+public:
+    static BK_CONSTEXPR size_t const CAPACITY = N;
+    static BK_CONSTEXPR size_t const MASK     = N - 1;
+
+    //! Advance to a new newest slot, overwriting the oldest once full.
+    //! @returns The slot to write.
+    size_t push() BK_NOEXCEPT {
+        head_ = (head_ + 1) & MASK;
+        size_ += (size_ < N) ? 1 : 0;
+        return head_;
+    }
+
+    //! The slot of the @c i th newest element; 0 is the newest.
+    //! @pre i < N; slots never pushed to hold whatever they were initialized to.
+    size_t slot(size_t const i) const BK_NOEXCEPT {
+        BK_ASSERT(i < N);
+        return (head_ - i) & MASK;
+    }
+
+    size_t size()  const BK_NOEXCEPT { return size_; }
+    bool   empty() const BK_NOEXCEPT { return size_ == 0; }
+    bool   full()  const BK_NOEXCEPT { return size_ == N; }
+
+    void clear() BK_NOEXCEPT {
+        head_ = 0;
+        size_ = 0;
+    }
+private:
+    uint32_t head_ = 0;
+    uint32_t size_ = 0;
+};
+
+template <size_t N> BK_CONSTEXPR size_t const ring_cursor<N>::CAPACITY;
+template <size_t N> BK_CONSTEXPR size_t const ring_cursor<N>::MASK;
+//==============================================================================
+//! A ring buffer of the N most recent values, newest first; no allocation,
+//! and pushing is a store and a mask.
+//!
+//! Every slot is value initialized, so indexing up to N is always valid (as
+//! with a history prefilled with defaults).
+//==============================================================================
+template <typename T, size_t N>
+class ring {
+public:
+    using value_type = T;
+
+    static BK_CONSTEXPR size_t const CAPACITY = N;
+
+    void push(T const& value) {
+        values_[cursor_.push()] = value;
+    }
+
+    //! The @c i th newest value; T{} if fewer than i + 1 were pushed.
+    //! @pre i < N.
+    T const& operator[](size_t const i) const BK_NOEXCEPT {
+        return values_[cursor_.slot(i)];
+    }
+
+    T const& front() const BK_NOEXCEPT { return (*this)[0]; }
+
+    size_t size()     const BK_NOEXCEPT { return cursor_.size(); }
+    bool   empty()    const BK_NOEXCEPT { return cursor_.empty(); }
+    bool   full()     const BK_NOEXCEPT { return cursor_.full(); }
+    size_t capacity() const BK_NOEXCEPT { return N; }
+
+    void clear() {
+        cursor_.clear();
+        values_.fill(T {});
+    }
+private:
+    ring_cursor<N>   cursor_;
+    std::array<T, N> values_ {};
+};
+
+template <typename T, size_t N> BK_CONSTEXPR size_t const ring<T, N>::CAPACITY;
+
+} //namespace bklib
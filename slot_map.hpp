@@ -0,0 +1,197 @@
+//==============================================================================
+//! Generational handles to densely stored values.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "assert.hpp"
+
+namespace bklib {
+//==============================================================================
+//! A handle to a value in a slot_map.
+//!
+//! A handle outlives its value safely: once the value is erased, the slot's
+//! generation changes and the handle no longer refers to anything, even after
+//! the slot is reused (until its 32 bit generation wraps around). A default
+//! constructed handle never refers to a value.
+//==============================================================================
+struct slot_handle {
+    uint32_t index;
+    uint32_t generation;
+
+    bool operator==(slot_handle const rhs) const BK_NOEXCEPT {
+        return index == rhs.index && generation == rhs.generation;
+    }
+
+    bool operator!=(slot_handle const rhs) const BK_NOEXCEPT {
+        return !(*this == rhs);
+    }
+
+    //! By index, then generation: for sorting and ordered containers.
+    bool operator<(slot_handle const rhs) const BK_NOEXCEPT {
+        return index < rhs.index || (index == rhs.index && generation < rhs.generation);
+    }
+};
+
+//==============================================================================
+//! An unordered container with O(1) insertion, erasure and lookup by handle.
+//!
+//! Values are kept contiguous (erasure moves the last value into the hole), so
+//! iteration is over a plain array; a table of slots maps handles to positions
+//! in that array, and erased slots are reused through a free list.
+//! Insertion and erasure invalidate pointers and iterators, never handles.
+//==============================================================================
+template <typename T>
+class slot_map {
+public:
+    using value_type     = T;
+    using handle         = slot_handle;
+    using iterator       = T*;
+    using const_iterator = T const*;
+
+    //--------------------------------------------------------------------------
+    template <typename... Args>
+    handle emplace(Args&&... args) {
+        auto const slot = acquire_slot_();
+
+        try {
+            owners_.push_back(slot);
+            values_.emplace_back(std::forward<Args>(args)...);
+        } catch (...) {
+            owners_.resize(values_.size());
+            release_slot_(slot);
+            throw;
+        }
+
+        slots_[slot].position = static_cast<uint32_t>(values_.size() - 1);
+
+        return handle {slot, slots_[slot].generation};
+    }
+
+    handle insert(T const& value) { return emplace(value); }
+    handle insert(T&& value)      { return emplace(std::move(value)); }
+
+    //--------------------------------------------------------------------------
+    //! @returns false if @c h did not refer to a value.
+    bool erase(handle const h) {
+        if (!contains(h)) {
+            return false;
+        }
+
+        auto const position = slots_[h.index].position;
+        auto const last     = static_cast<uint32_t>(values_.size() - 1);
+
+        if (position != last) {
+            values_[position] = std::move(values_[last]);
+            owners_[position] = owners_[last];
+            slots_[owners_[position]].position = position;
+        }
+
+        values_.pop_back();
+        owners_.pop_back();
+
+        release_slot_(h.index);
+
+        return true;
+    }
+
+    void clear() {
+        for (auto const slot : owners_) {
+            release_slot_(slot);
+        }
+
+        values_.clear();
+        owners_.clear();
+    }
+
+    void reserve(size_t const n) {
+        values_.reserve(n);
+        owners_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    //--------------------------------------------------------------------------
+    bool contains(handle const h) const BK_NOEXCEPT {
+        return h.index < slots_.size() && slots_[h.index].generation == h.generation;
+    }
+
+    //! @returns nullptr if @c h does not refer to a value.
+    T* get(handle const h) BK_NOEXCEPT {
+        return contains(h) ? &values_[slots_[h.index].position] : nullptr;
+    }
+
+    T const* get(handle const h) const BK_NOEXCEPT {
+        return contains(h) ? &values_[slots_[h.index].position] : nullptr;
+    }
+
+    //! @pre contains(h).
+    T& operator[](handle const h) BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[slots_[h.index].position];
+    }
+
+    T const& operator[](handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[slots_[h.index].position];
+    }
+
+    //! The handle of the value at position @c i of the dense array.
+    handle handle_at(size_t const i) const BK_NOEXCEPT {
+        BK_ASSERT(i < owners_.size());
+        auto const slot = owners_[i];
+        return handle {slot, slots_[slot].generation};
+    }
+
+    //--------------------------------------------------------------------------
+    size_t size()  const BK_NOEXCEPT { return values_.size(); }
+    bool   empty() const BK_NOEXCEPT { return values_.empty(); }
+
+    T*       data()       BK_NOEXCEPT { return values_.data(); }
+    T const* data() const BK_NOEXCEPT { return values_.data(); }
+
+    iterator       begin()       BK_NOEXCEPT { return values_.data(); }
+    iterator       end()         BK_NOEXCEPT { return values_.data() + values_.size(); }
+    const_iterator begin() const BK_NOEXCEPT { return values_.data(); }
+    const_iterator end()   const BK_NOEXCEPT { return values_.data() + values_.size(); }
+private:
+    static BK_CONSTEXPR uint32_t const NO_SLOT = ~uint32_t {0};
+
+    struct slot {
+        uint32_t position;   //!< In values_ if live, else the next free slot.
+        uint32_t generation; //!< Odd while live, so handles to free slots are stale.
+    };
+
+    uint32_t acquire_slot_() {
+        if (free_ != NO_SLOT) {
+            auto const result = free_;
+            free_ = slots_[result].position;
+            ++slots_[result].generation;
+            return result;
+        }
+
+        BK_ASSERT(slots_.size() < NO_SLOT);
+
+        slots_.push_back(slot {NO_SLOT, 1});
+        return static_cast<uint32_t>(slots_.size() - 1);
+    }
+
+    void release_slot_(uint32_t const i) BK_NOEXCEPT {
+        auto& s = slots_[i];
+
+        ++s.generation;
+        s.position = free_;
+        free_ = i;
+    }
+
+    std::vector<T>        values_;
+    std::vector<uint32_t> owners_; //!< The slot of each value.
+    std::vector<slot>     slots_;
+    uint32_t              free_ = NO_SLOT;
+};
+
+} //namespace bklib
@@ -0,0 +1,379 @@
+//==============================================================================
+//! Uniform grid spatial index.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "assert.hpp"
+#include "math.hpp"
+#include "spatial_index.hpp"
+
+namespace bklib {
+//==============================================================================
+//! A uniform grid of square cells over a world rectangle, each cell listing
+//! the values whose bounds overlap it; @see spatial_index.hpp for the
+//! interface.
+//!
+//! The cell lists are one array in cell order (a counting sort, rebuilt in
+//! O(n) whenever a value was inserted, removed or moved to other cells); each
+//! entry holds a copy of its value's bounds, so that the pair and query loops
+//! read memory in order. Moves within the same cells update those copies in
+//! place and keep the lists.
+//!
+//! Cells are a power of two in size, so that finding a cell is a shift. Bounds
+//! outside the world are clamped into its border cells. A value overlapping
+//! several cells is listed in each, and each pair (or query result) is
+//! reported only from the first cell the two have in common.
+//!
+//! Values are stored by slot, each with a generation (odd while live, as in
+//! slot_map); a handle is a slot and its generation.
+//!
+//! Queries rebuild the lists first if they are out of date (call rebuild()
+//! before querying from several threads at once).
+//==============================================================================
+template <typename T>
+class spatial_grid {
+public:
+    using rect       = axis_aligned_rect<int>;
+    using point      = point2d<int>;
+    using handle     = spatial_handle;
+    using value_type = T;
+
+    //--------------------------------------------------------------------------
+    //! @pre world.is_well_formed() and cell_size is a power of two; at most
+    //!      65536 cells along each axis.
+    //--------------------------------------------------------------------------
+    spatial_grid(rect const world, int const cell_size)
+      : world_ (world)
+      , shift_ {shift_of_(cell_size)}
+      , cols_  {static_cast<uint32_t>((int64_t {world.width()}  + cell_size - 1) >> shift_)}
+      , rows_  {static_cast<uint32_t>((int64_t {world.height()} + cell_size - 1) >> shift_)}
+    {
+        BK_ASSERT(world.is_well_formed());
+        BK_ASSERT(cols_ <= 0x10000 && rows_ <= 0x10000);
+    }
+
+    //--------------------------------------------------------------------------
+    handle insert(rect const bounds, T value) {
+        index i;
+
+        if (free_.empty()) {
+            i = static_cast<index>(bounds_.size());
+            bounds_.push_back(bounds);
+            cells_.push_back(cells_of_(bounds));
+            values_.push_back(std::move(value));
+            generations_.push_back(1);
+        } else {
+            i = free_.back();
+            free_.pop_back();
+
+            bounds_[i] = bounds;
+            cells_[i]  = cells_of_(bounds);
+            values_[i] = std::move(value);
+            ++generations_[i];
+        }
+
+        ++size_;
+        dirty_ = true;
+
+        return handle {i, generations_[i]};
+    }
+
+    //! @pre contains(h).
+    void remove(handle const h) {
+        BK_ASSERT(contains(h));
+
+        release_(h.index);
+
+        --size_;
+        dirty_ = true;
+    }
+
+    //! @pre contains(h).
+    //! @returns true if the value moved to other cells (so that the lists will
+    //!          be rebuilt).
+    bool update(handle const h, rect const bounds) {
+        BK_ASSERT(contains(h));
+
+        auto const i     = h.index;
+        auto const cells = cells_of_(bounds);
+        bounds_[i] = bounds;
+
+        if (cells != cells_[i]) {
+            cells_[i] = cells;
+            dirty_ = true;
+            return true;
+        }
+
+        if (!dirty_) {
+            for_each_cell_(cells, [&](uint32_t const c, uint32_t, uint32_t) {
+                auto const first = entries_.data() + starts_[c];
+                auto const last  = entries_.data() + starts_[c + 1];
+                std::find_if(first, last, [i](entry const& e) { return e.owner == i; })->bounds = bounds;
+            });
+        }
+
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    bool contains(handle const h) const BK_NOEXCEPT {
+        return h.index < generations_.size() && generations_[h.index] == h.generation;
+    }
+
+    //! @pre contains(h).
+    rect const& bounds(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return bounds_[h.index];
+    }
+
+    //! @pre contains(h).
+    T const& value(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    //! @pre contains(h).
+    T& value(handle const h) BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    size_t size()  const BK_NOEXCEPT { return size_; }
+    bool   empty() const BK_NOEXCEPT { return size_ == 0; }
+
+    rect   world()     const BK_NOEXCEPT { return world_; }
+    int    cell_size() const BK_NOEXCEPT { return 1 << shift_; }
+
+    //! Remove every value; the slots are kept, so that the handles to them
+    //! stay stale.
+    void clear() {
+        for (index i = 0; i < generations_.size(); ++i) {
+            if (is_live_(i)) {
+                release_(i);
+            }
+        }
+
+        entries_.clear();
+        size_  = 0;
+        dirty_ = true;
+    }
+
+    //--------------------------------------------------------------------------
+    //! Rebuild the cell lists if they are out of date: O(n + cells).
+    //--------------------------------------------------------------------------
+    void rebuild() const {
+        if (!dirty_) {
+            return;
+        }
+
+        auto const cell_count = cols_ * rows_;
+
+        // count the entries of each cell, offset by one...
+        starts_.assign(cell_count + 1, 0);
+
+        for (index i = 0; i < bounds_.size(); ++i) {
+            if (!is_live_(i)) {
+                continue;
+            }
+
+            for_each_cell_(cells_[i], [&](uint32_t const c, uint32_t, uint32_t) {
+                ++starts_[c + 1];
+            });
+        }
+
+        // ...so that the running sum gives where each cell starts.
+        for (uint32_t c = 0; c < cell_count; ++c) {
+            starts_[c + 1] += starts_[c];
+        }
+
+        entries_.resize(starts_[cell_count]);
+        ends_.assign(starts_.begin(), starts_.end() - 1);
+
+        for (index i = 0; i < bounds_.size(); ++i) {
+            if (!is_live_(i)) {
+                continue;
+            }
+
+            auto const& b = bounds_[i];
+            for_each_cell_(cells_[i], [&](uint32_t const c, uint32_t, uint32_t) {
+                entries_[ends_[c]++] = entry {b, i};
+            });
+        }
+
+        dirty_ = false;
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds intersect @c r.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(rect const r, F&& f) const {
+        rebuild();
+
+        auto const q = cells_of_(r);
+
+        for_each_cell_(q, [&](uint32_t const c, uint32_t const x, uint32_t const y) {
+            for (auto i = starts_[c]; i != starts_[c + 1]; ++i) {
+                auto const& e = entries_[i];
+                if (intersects(e.bounds, r) && first_shared_(e.bounds, r, x, y)) {
+                    f(values_[e.owner]);
+                }
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds contain @c p.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(point const p, F&& f) const {
+        rebuild();
+
+        auto const c = cell_x_(p.x) + cell_y_(p.y) * cols_;
+
+        for (auto i = starts_[c]; i != starts_[c + 1]; ++i) {
+            auto const& e = entries_[i];
+            if (intersects(e.bounds, p)) {
+                f(values_[e.owner]);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const& a, T const& b) once for each pair of values whose bounds
+    //! intersect.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void for_each_pair(F&& f) const {
+        rebuild();
+
+        for (uint32_t y = 0; y < rows_; ++y) {
+            for (uint32_t x = 0; x < cols_; ++x) {
+                auto const c     = x + y * cols_;
+                auto const first = starts_[c];
+                auto const last  = starts_[c + 1];
+
+                for (auto i = first; i != last; ++i) {
+                    auto const& a = entries_[i];
+                    for (auto j = i + 1; j != last; ++j) {
+                        auto const& b = entries_[j];
+                        if (intersects(a.bounds, b.bounds) && first_shared_(a.bounds, b.bounds, x, y)) {
+                            f(values_[a.owner], values_[b.owner]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+private:
+    using index = uint32_t;
+
+    //! The inclusive range of cells some bounds overlap.
+    struct cell_range {
+        uint16_t x0, y0, x1, y1;
+
+        bool operator!=(cell_range const& rhs) const BK_NOEXCEPT {
+            return x0 != rhs.x0 || y0 != rhs.y0 || x1 != rhs.x1 || y1 != rhs.y1;
+        }
+    };
+
+    struct entry {
+        rect  bounds;
+        index owner;
+    };
+
+    bool is_live_(index const i) const BK_NOEXCEPT {
+        return (generations_[i] & 1) != 0;
+    }
+
+    void release_(index const i) {
+        ++generations_[i];
+        values_[i] = T {};
+        free_.push_back(i);
+    }
+
+    static uint32_t shift_of_(int const cell_size) BK_NOEXCEPT {
+        BK_ASSERT(cell_size > 0 && (cell_size & (cell_size - 1)) == 0);
+
+        uint32_t result = 0;
+        while ((1 << result) != cell_size) {
+            ++result;
+        }
+
+        return result;
+    }
+
+    //! Whether {x, y} is the first (top left) cell that (intersecting) a and b
+    //! share.
+    bool first_shared_(rect const& a, rect const& b, uint32_t const x, uint32_t const y) const BK_NOEXCEPT {
+        return cell_x_(std::max(a.left(), b.left())) == x
+            && cell_y_(std::max(a.top(),  b.top()))  == y;
+    }
+
+    //! The cell column of x, clamped to the grid.
+    uint32_t cell_x_(int const x) const BK_NOEXCEPT {
+        return cell_of_(int64_t {x} - world_.left(), cols_);
+    }
+
+    uint32_t cell_y_(int const y) const BK_NOEXCEPT {
+        return cell_of_(int64_t {y} - world_.top(), rows_);
+    }
+
+    //! floor(d / cell size) clamped to [0, n).
+    uint32_t cell_of_(int64_t const d, uint32_t const n) const BK_NOEXCEPT {
+        auto const c = std::max(d, int64_t {0}) >> shift_;
+        return static_cast<uint32_t>(std::min(c, int64_t {n - 1}));
+    }
+
+    cell_range cells_of_(rect const r) const BK_NOEXCEPT {
+        auto const x0 = cell_x_(r.left());
+        auto const y0 = cell_y_(r.top());
+
+        // right and bottom are exclusive; empty bounds take their first cell.
+        auto const x1 = std::max(x0, cell_x_(r.right()  - 1));
+        auto const y1 = std::max(y0, cell_y_(r.bottom() - 1));
+
+        return cell_range {
+            static_cast<uint16_t>(x0), static_cast<uint16_t>(y0)
+          , static_cast<uint16_t>(x1), static_cast<uint16_t>(y1)
+        };
+    }
+
+    //! f(index, x, y) for each cell in @c cells.
+    template <typename F>
+    void for_each_cell_(cell_range const cells, F&& f) const {
+        for (uint32_t y = cells.y0; y <= cells.y1; ++y) {
+            for (uint32_t x = cells.x0; x <= cells.x1; ++x) {
+                f(x + y * cols_, x, y);
+            }
+        }
+    }
+
+    rect     world_;
+    uint32_t shift_;
+    uint32_t cols_;
+    uint32_t rows_;
+
+    // by slot.
+    std::vector<rect>       bounds_;
+    std::vector<cell_range> cells_;
+    std::vector<T>          values_;
+    std::vector<uint32_t>   generations_; //!< Odd while live.
+    std::vector<index>      free_;
+    size_t                  size_ = 0;
+
+    // the cell lists; entries_[starts_[c], starts_[c + 1]) are in cell c.
+    mutable std::vector<uint32_t> starts_;
+    mutable std::vector<uint32_t> ends_;
+    mutable std::vector<entry>    entries_;
+    mutable bool                  dirty_ = true;
+};
+
+} //namespace bklib
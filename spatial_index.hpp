@@ -0,0 +1,47 @@
+//==============================================================================
+//! Common definitions for the spatial indices (broadphases).
+//!
+//! Each index maps handles to {bounds, value} and shares this interface, so
+//! that one can be swapped for another to suit the workload:
+//!
+//!   handle insert(rect bounds, T value);
+//!   void   remove(handle h);
+//!   bool   update(handle h, rect bounds);  //!< true if the index had to change.
+//!
+//!   bool        contains(handle h) const;
+//!   rect const& bounds(handle h) const;
+//!   T const&    value(handle h) const;
+//!   T&          value(handle h);
+//!
+//!   size_t size() const;
+//!   bool   empty() const;
+//!   void   clear();
+//!
+//!   void query(rect r, F f) const;   //!< f(T const&) for each value intersecting r.
+//!   void query(point p, F f) const;  //!< f(T const&) for each value containing p.
+//!   void for_each_pair(F f) const;   //!< f(T const&, T const&) once per intersecting pair.
+//!
+//! Intersection is that of math.hpp: rects are half open.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <utility>
+
+#include "types.hpp"
+#include "slot_map.hpp"
+
+namespace bklib {
+//==============================================================================
+//! Identifies a value in a spatial index.
+//!
+//! As with a slot_map, each slot of an index carries a generation, which
+//! changes when its value is removed: contains() is false for a handle to a
+//! removed value, even once its slot holds another.
+//==============================================================================
+using spatial_handle = slot_handle;
+
+//! A pair of handles whose bounds intersect, as found by a broadphase.
+using spatial_pair = std::pair<spatial_handle, spatial_handle>;
+
+} //namespace bklib
@@ -0,0 +1,527 @@
+//==============================================================================
+//! Incremental sweep and prune broadphase.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_set>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "assert.hpp"
+#include "math.hpp"
+#include "callback.hpp"
+#include "spatial_index.hpp"
+
+namespace bklib {
+//==============================================================================
+//! The bounds of a and b started or stopped intersecting; @see sweep_and_prune.
+//==============================================================================
+BK_DECLARE_EVENT(on_overlap_begin, void (spatial_handle a, spatial_handle b));
+BK_DECLARE_EVENT(on_overlap_end,   void (spatial_handle a, spatial_handle b));
+
+//==============================================================================
+//! The endpoints of every rect kept sorted along each axis, and the set of
+//! intersecting pairs kept up to date as they move; @see spatial_index.hpp for
+//! the interface.
+//!
+//! Each sweep() re-sorts the axes by insertion sort: objects that move a little
+//! each frame change order only with their neighbours, so a frame costs
+//! close to O(n). Every swap of a min endpoint below a max endpoint (or the
+//! reverse) is where two rects may start (or stop) overlapping, and the pair
+//! set is updated there, rather than searched for. Large batches of insertions
+//! are sorted outright instead, and the pairs found by a single sweep.
+//!
+//! Each sweep reports the pairs that began and ended since the last through
+//! on_overlap_begin / on_overlap_end (a < b), and added() / removed(); removing
+//! a value ends its pairs, reported with the handle it had. Values are stored
+//! by slot, each with a generation (odd while live, as in slot_map); a slot is
+//! not reused until the sweep after its removal.
+//!
+//! Queries and pairs sweep first if anything changed (call sweep() before
+//! querying from several threads at once). This suits scenes whose objects
+//! spread out along some axis; in dense scenes the overlaps of the
+//! projections alone make it slow.
+//==============================================================================
+template <typename T, typename Coord = float>
+class sweep_and_prune {
+public:
+    using rect       = axis_aligned_rect<Coord>;
+    using point      = point2d<Coord>;
+    using handle     = spatial_handle;
+    using value_type = T;
+
+    //--------------------------------------------------------------------------
+    handle insert(rect const bounds, T value) {
+        index i;
+
+        if (free_.empty()) {
+            BK_ASSERT(bounds_.size() < 0x80000000u);
+
+            i = static_cast<index>(bounds_.size());
+            bounds_.push_back(bounds);
+            values_.push_back(std::move(value));
+            generations_.push_back(1);
+        } else {
+            i = free_.back();
+            free_.pop_back();
+
+            bounds_[i] = bounds;
+            values_[i] = std::move(value);
+            ++generations_[i];
+        }
+
+        for (auto& axis : axes_) {
+            axis.push_back(endpoint {Coord {}, (i << 1) | MIN});
+            axis.push_back(endpoint {Coord {}, (i << 1) | MAX});
+        }
+
+        widen_(bounds);
+
+        ++size_;
+        ++inserted_;
+        dirty_ = true;
+
+        return handle {i, generations_[i]};
+    }
+
+    //! @pre contains(h).
+    void remove(handle const h) {
+        BK_ASSERT(contains(h));
+
+        release_(h.index);
+
+        --size_;
+        dirty_ = true;
+    }
+
+    //! @pre contains(h).
+    //! @returns true if the bounds changed (so that the axes will be sorted).
+    bool update(handle const h, rect const bounds) {
+        BK_ASSERT(contains(h));
+
+        if (bounds == bounds_[h.index]) {
+            return false;
+        }
+
+        bounds_[h.index] = bounds;
+        widen_(bounds);
+        dirty_ = true;
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    bool contains(handle const h) const BK_NOEXCEPT {
+        return h.index < generations_.size() && generations_[h.index] == h.generation;
+    }
+
+    //! @pre contains(h).
+    rect const& bounds(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return bounds_[h.index];
+    }
+
+    //! @pre contains(h).
+    T const& value(handle const h) const BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    //! @pre contains(h).
+    T& value(handle const h) BK_NOEXCEPT {
+        BK_ASSERT(contains(h));
+        return values_[h.index];
+    }
+
+    size_t size()  const BK_NOEXCEPT { return size_; }
+    bool   empty() const BK_NOEXCEPT { return size_ == 0; }
+
+    //! Forget everything, without ending any pairs; the slots are kept, so
+    //! that the handles to them stay stale.
+    void clear() {
+        for (index i = 0; i < generations_.size(); ++i) {
+            if (is_live_(i)) {
+                release_(i);
+            }
+        }
+
+        free_.insert(free_.end(), released_.begin(), released_.end());
+        released_.clear();
+        for (auto& axis : axes_) {
+            axis.clear();
+        }
+        pairs_.clear();
+        added_.clear();
+        removed_.clear();
+
+        width_    = Coord {};
+        size_     = 0;
+        inserted_ = 0;
+        dirty_    = true;
+    }
+
+    //--------------------------------------------------------------------------
+    void listen(on_overlap_begin callback) { on_begin_ = std::move(callback); }
+    void listen(on_overlap_end   callback) { on_end_   = std::move(callback); }
+
+    //! The pairs that began / ended in the last sweep with anything to do,
+    //! {lower, higher}.
+    std::vector<spatial_pair> const& added()   const BK_NOEXCEPT { return added_; }
+    std::vector<spatial_pair> const& removed() const BK_NOEXCEPT { return removed_; }
+
+    //! The number of intersecting pairs as of the last sweep.
+    size_t pair_count() const BK_NOEXCEPT { return pairs_.size(); }
+
+    //--------------------------------------------------------------------------
+    //! Sort the axes and update the pairs, if anything changed.
+    //--------------------------------------------------------------------------
+    void sweep() const {
+        if (!dirty_) {
+            return;
+        }
+
+        added_.clear();
+        removed_.clear();
+
+        if (!released_.empty()) {
+            remove_released_();
+        }
+
+        refresh_();
+
+        // a few insertions are sorted in like moves; more, and it is cheaper
+        // to start over.
+        if (inserted_ * 4 > size_) {
+            rebuild_();
+        } else {
+            insertion_sort_(axes_[0]);
+            insertion_sort_(axes_[1]);
+        }
+
+        inserted_ = 0;
+        dirty_    = false;
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds intersect @c r.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(rect const r, F&& f) const {
+        // only rects starting within the widest rect of r's left can reach it.
+        for_each_starting_(r.left() - width_, r.right(), [&](index const i) {
+            if (intersects(bounds_[i], r)) {
+                f(values_[i]);
+            }
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const&) for each value whose bounds contain @c p.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void query(point const p, F&& f) const {
+        for_each_starting_(p.x - width_, p.x, [&](index const i) {
+            if (intersects(bounds_[i], p)) {
+                f(values_[i]);
+            }
+        }, true);
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(T const& a, T const& b) once for each pair of values whose bounds
+    //! intersect.
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void for_each_pair(F&& f) const {
+        sweep();
+
+        for (auto const key : pairs_) {
+            f(values_[first_of_(key)], values_[second_of_(key)]);
+        }
+    }
+private:
+    using index = uint32_t;
+
+    static uint32_t const MIN = 0;
+    static uint32_t const MAX = 1;
+
+    //! A side of a rect on one axis: the owner's slot and whether it is the
+    //! max, packed; the value is refreshed from the bounds before each sort.
+    struct endpoint {
+        Coord    value;
+        uint32_t id;
+
+        index  owner()  const BK_NOEXCEPT { return id >> 1; }
+        bool   is_min() const BK_NOEXCEPT { return (id & 1) == MIN; }
+    };
+
+    //! Sorted by value; at equal values, max endpoints come first: the rects
+    //! are half open, so touching ones do not overlap.
+    static bool less_(endpoint const& a, endpoint const& b) BK_NOEXCEPT {
+        return a.value < b.value || (a.value == b.value && !a.is_min() && b.is_min());
+    }
+
+    //--------------------------------------------------------------------------
+    //! The pairs are kept by slot.
+    static uint64_t key_of_(index const a, index const b) BK_NOEXCEPT {
+        auto const lo = std::min(a, b);
+        auto const hi = std::max(a, b);
+        return uint64_t {lo} << 32 | hi;
+    }
+
+    static index first_of_(uint64_t const key)  BK_NOEXCEPT { return static_cast<index>(key >> 32); }
+    static index second_of_(uint64_t const key) BK_NOEXCEPT { return static_cast<index>(key); }
+
+    //! The handle of the value in slot @c i; for a value removed since the
+    //! last sweep, the handle it had.
+    handle handle_of_(index const i) const BK_NOEXCEPT {
+        auto const g = generations_[i];
+        return handle {i, (g & 1) ? g : g - 1};
+    }
+
+    void add_pair_(index const a, index const b) const {
+        auto const key = key_of_(a, b);
+        if (pairs_.insert(key).second) {
+            auto const first  = handle_of_(first_of_(key));
+            auto const second = handle_of_(second_of_(key));
+
+            added_.emplace_back(first, second);
+            if (on_begin_) {
+                on_begin_(first, second);
+            }
+        }
+    }
+
+    void remove_pair_(uint64_t const key) const {
+        if (pairs_.erase(key)) {
+            auto const first  = handle_of_(first_of_(key));
+            auto const second = handle_of_(second_of_(key));
+
+            removed_.emplace_back(first, second);
+            if (on_end_) {
+                on_end_(first, second);
+            }
+        }
+    }
+
+    bool is_live_(index const i) const BK_NOEXCEPT {
+        return (generations_[i] & 1) != 0;
+    }
+
+    void release_(index const i) {
+        ++generations_[i];
+        values_[i] = T {};
+        released_.push_back(i);
+    }
+
+    //--------------------------------------------------------------------------
+    void widen_(rect const& r) BK_NOEXCEPT {
+        width_ = std::max(width_, r.right() - r.left());
+    }
+
+    //! End the pairs of, and drop the endpoints of, the removed values; their
+    //! slots are free from now on.
+    void remove_released_() const {
+        std::vector<uint64_t> ended;
+        for (auto const key : pairs_) {
+            if (!is_live_(first_of_(key)) || !is_live_(second_of_(key))) {
+                ended.push_back(key);
+            }
+        }
+
+        std::sort(ended.begin(), ended.end());
+        for (auto const key : ended) {
+            remove_pair_(key);
+        }
+
+        for (auto& axis : axes_) {
+            axis.erase(std::remove_if(axis.begin(), axis.end(), [&](endpoint const& e) {
+                return !is_live_(e.owner());
+            }), axis.end());
+        }
+
+        free_.insert(free_.end(), released_.begin(), released_.end());
+        released_.clear();
+    }
+
+    //! Copy the current bounds into the endpoints.
+    void refresh_() const BK_NOEXCEPT {
+        for (auto& e : axes_[0]) {
+            auto const& b = bounds_[e.owner()];
+            e.value = e.is_min() ? b.left() : b.right();
+        }
+
+        for (auto& e : axes_[1]) {
+            auto const& b = bounds_[e.owner()];
+            e.value = e.is_min() ? b.top() : b.bottom();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! Sort @c axis, nearly sorted already; a min passing below a max may start
+    //! a pair and a max passing below a min ends one. The pairs are tested
+    //! against the final bounds, so each is added or removed at most once.
+    //--------------------------------------------------------------------------
+    void insertion_sort_(std::vector<endpoint>& axis) const {
+        auto const n = axis.size();
+
+        for (size_t i = 1; i < n; ++i) {
+            auto const e = axis[i];
+            if (!less_(e, axis[i - 1])) {
+                continue;
+            }
+
+            auto const h = e.owner();
+            auto       j = i;
+
+            do {
+                auto const& p = axis[j - 1];
+                auto const  o = p.owner();
+
+                if (o != h) {
+                    if (e.is_min() && !p.is_min()) {
+                        if (intersects(bounds_[h], bounds_[o])) {
+                            add_pair_(h, o);
+                        }
+                    } else if (!e.is_min() && p.is_min()) {
+                        remove_pair_(key_of_(h, o));
+                    }
+                }
+
+                axis[j] = p;
+                --j;
+            } while (j > 0 && less_(e, axis[j - 1]));
+
+            axis[j] = e;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! Sort both axes outright and find every pair with one sweep along x;
+    //! the pair events are the difference from the previous pairs.
+    //--------------------------------------------------------------------------
+    void rebuild_() const {
+        for (auto& axis : axes_) {
+            std::sort(axis.begin(), axis.end(), less_);
+        }
+
+        std::unordered_set<uint64_t> found;
+        found.reserve(pairs_.size());
+
+        // the rects open at each point of the sweep, and where each is in it.
+        // an empty rect (whose max comes first) still meets those it is
+        // strictly within, but never opens: it cannot contain another.
+        uint32_t const CLOSED = 0xFFFFFFFFu;
+
+        std::vector<index>    open;
+        std::vector<uint32_t> slot (bounds_.size(), CLOSED);
+
+        for (auto const& e : axes_[0]) {
+            auto const h = e.owner();
+
+            if (e.is_min()) {
+                for (auto const o : open) {
+                    if (intersects(bounds_[h], bounds_[o])) {
+                        found.insert(key_of_(h, o));
+                    }
+                }
+
+                if (!(bounds_[h].left() < bounds_[h].right())) {
+                    continue;
+                }
+
+                slot[h] = static_cast<uint32_t>(open.size());
+                open.push_back(h);
+            } else if (slot[h] != CLOSED) {
+                auto const last = open.back();
+                open[slot[h]] = last;
+                slot[last]    = slot[h];
+                open.pop_back();
+            }
+        }
+
+        // in key order, so that the events do not depend on the hashing.
+        std::vector<uint64_t> ended;
+        for (auto const key : pairs_) {
+            if (!found.count(key)) {
+                ended.push_back(key);
+            }
+        }
+
+        std::vector<uint64_t> began;
+        for (auto const key : found) {
+            if (!pairs_.count(key)) {
+                began.push_back(key);
+            }
+        }
+
+        std::sort(ended.begin(), ended.end());
+        std::sort(began.begin(), began.end());
+
+        for (auto const key : ended) {
+            remove_pair_(key);
+        }
+
+        for (auto const key : began) {
+            add_pair_(first_of_(key), second_of_(key));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! f(slot) for each rect whose left is in [first, last) (or, if
+    //! @c inclusive, [first, last]).
+    //--------------------------------------------------------------------------
+    template <typename F>
+    void for_each_starting_(Coord const first, Coord const last, F&& f, bool const inclusive = false) const {
+        sweep();
+
+        auto const& axis = axes_[0];
+
+        auto it = std::lower_bound(axis.begin(), axis.end(), first, [](endpoint const& e, Coord const v) {
+            return e.value < v;
+        });
+
+        for (; it != axis.end(); ++it) {
+            if (it->value > last || (!inclusive && it->value == last)) {
+                break;
+            }
+
+            if (it->is_min()) {
+                f(it->owner());
+            }
+        }
+    }
+
+    // by slot.
+    std::vector<rect>     bounds_;
+    std::vector<T>        values_;
+    std::vector<uint32_t> generations_; //!< Odd while live.
+    size_t                size_ = 0;
+
+    Coord width_ {}; //!< The widest rect ever given.
+
+    mutable std::vector<index> free_;
+    mutable std::vector<index> released_; //!< Removed since the last sweep.
+
+    mutable std::vector<endpoint>        axes_[2];
+    mutable std::unordered_set<uint64_t> pairs_;
+    mutable std::vector<spatial_pair>    added_;
+    mutable std::vector<spatial_pair>    removed_;
+    mutable size_t                       inserted_ = 0; //!< Since the last sweep.
+    mutable bool                         dirty_    = true;
+
+    on_overlap_begin on_begin_;
+    on_overlap_end   on_end_;
+};
+
+template <typename T, typename Coord>
+uint32_t const sweep_and_prune<T, Coord>::MIN;
+
+template <typename T, typename Coord>
+uint32_t const sweep_and_prune<T, Coord>::MAX;
+
+} //namespace bklib
@@ -0,0 +1,200 @@
+//==============================================================================
+//! A work stealing thread pool.
+//! @file
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <exception>
+#include <functional>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "types.hpp"
+#include "config.hpp"
+#include "macros.hpp"
+#include "assert.hpp"
+
+namespace bklib {
+
+class task_pool;
+
+//==============================================================================
+//! Tracks completion of a set of tasks; @see task_pool::run.
+//==============================================================================
+class task_group {
+public:
+    friend class task_pool;
+
+    task_group() = default;
+    BK_DELETE_ALL(task_group);
+
+    //! @pre the group has been waited on.
+    ~task_group() {
+        BK_ASSERT(pending_.load() == 0);
+    }
+
+    bool done() const BK_NOEXCEPT {
+        return pending_.load(std::memory_order_acquire) == 0;
+    }
+private:
+    std::atomic<size_t> pending_ {0};
+    std::mutex          error_mutex_;
+    std::exception_ptr  error_; //!< The first exception thrown by a task.
+};
+
+//==============================================================================
+//! A fixed set of worker threads, each with its own deque of tasks.
+//!
+//! Tasks spawned from a worker go onto that worker's deque, from which it
+//! takes the most recent first (for locality) and idle workers steal the
+//! oldest (typically the largest pieces of work); tasks from other threads go
+//! through a shared queue. Threads waiting on a task_group run tasks while
+//! they wait, so tasks may themselves spawn and wait on tasks.
+//==============================================================================
+class task_pool {
+public:
+    using function = std::function<void ()>;
+
+    //! The shared pool, with a worker for each core but one.
+    static task_pool& shared();
+
+    //! @param workers The number of worker threads; 0 for one per core but one
+    //!        (a waiting thread makes up the last).
+    explicit task_pool(size_t workers = 0);
+
+    //! @pre every task_group used with the pool has been waited on.
+    ~task_pool();
+
+    BK_DELETE_ALL(task_pool);
+
+    size_t size() const BK_NOEXCEPT { return workers_.size(); }
+
+    //! Run @c f asynchronously as part of @c group.
+    void run(task_group& group, function f);
+
+    //! Run tasks until every task in @c group has finished.
+    //! @throws The first exception thrown by a task in the group.
+    void wait(task_group& group);
+
+    //! Call f(i) for each i in [first, last), in parallel, in chunks of at
+    //! least @c grain indices.
+    //! @throws The first exception thrown by @c f.
+    template <typename F>
+    void parallel_for(size_t first, size_t last, F&& f, size_t grain = 1);
+private:
+    struct task;
+    struct worker;
+
+    void   execute_(task* t) BK_NOEXCEPT;
+    task*  find_task_(worker* self);
+    void   worker_main_(worker* self);
+
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::vector<std::thread>             threads_;
+
+    std::mutex         queue_mutex_;
+    std::deque<task*>  queue_; //!< From threads which are not workers.
+
+    std::mutex              sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t>     sleepers_ {0};
+    std::atomic<size_t>     epoch_    {0}; //!< Incremented for each new task.
+    std::atomic<bool>       stop_     {false};
+};
+
+//------------------------------------------------------------------------------
+template <typename F>
+void task_pool::parallel_for(size_t const first, size_t const last, F&& f, size_t const grain) {
+    if (first >= last) {
+        return;
+    }
+
+    // a few chunks per thread to balance uneven work.
+    auto const n          = last - first;
+    auto const max_chunks = (n + std::max(grain, size_t {1}) - 1) / std::max(grain, size_t {1});
+    auto const chunks     = std::min(max_chunks, (size() + 1) * 4);
+
+    auto const chunk = [&](size_t const c) {
+        auto const lo = first + n * c / chunks;
+        auto const hi = first + n * (c + 1) / chunks;
+
+        for (auto i = lo; i < hi; ++i) {
+            f(i);
+        }
+    };
+
+    if (chunks == 1) {
+        chunk(0);
+        return;
+    }
+
+    task_group group;
+
+    for (size_t c = 1; c < chunks; ++c) {
+        run(group, [&chunk, c] { chunk(c); });
+    }
+
+    try {
+        chunk(0);
+    } catch (...) {
+        wait(group);
+        throw;
+    }
+
+    wait(group);
+}
+
+//==============================================================================
+//! A set of tasks and the order in which they must run.
+//!
+//! Each run() runs every task once, starting a task as soon as all of its
+//! predecessors have finished. If a task throws, tasks not yet started are
+//! skipped and the exception is rethrown by run().
+//==============================================================================
+class task_graph {
+public:
+    using node     = uint32_t;
+    using function = task_pool::function;
+
+    node add(function f) {
+        nodes_.push_back(vertex {std::move(f), {}, 0});
+        return static_cast<node>(nodes_.size() - 1);
+    }
+
+    //! @c after will not start until @c before has finished.
+    //! @pre the graph stays acyclic.
+    void precede(node const before, node const after) {
+        BK_ASSERT(before < nodes_.size() && after < nodes_.size() && before != after);
+
+        nodes_[before].successors.push_back(after);
+        ++nodes_[after].predecessors;
+    }
+
+    //! Add @c f as a continuation of @c before.
+    node then(node const before, function f) {
+        auto const result = add(std::move(f));
+        precede(before, result);
+        return result;
+    }
+
+    size_t size() const BK_NOEXCEPT { return nodes_.size(); }
+
+    void run(task_pool& pool) const;
+private:
+    struct vertex {
+        function          f;
+        std::vector<node> successors;
+        uint32_t          predecessors;
+    };
+
+    std::vector<vertex> nodes_;
+};
+
+} //namespace bklib
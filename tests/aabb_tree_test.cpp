@@ -0,0 +1,190 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "aabb_tree.hpp"
+#include "spatial_index_test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using bklib::aabb_tree;
+using spatial_test::pairs;
+using spatial_test::sorted_pairs;
+using spatial_test::sorted_query;
+
+namespace {
+using tree   = aabb_tree<int>;
+using rect   = tree::rect;
+using point  = tree::point;
+using circle = tree::circle;
+
+//! Whether the tree is at most twice as tall as a perfectly balanced one.
+bool is_balanced(tree const& t) {
+    auto const n = static_cast<double>(t.size());
+    return t.height() <= 2 * static_cast<int>(std::ceil(std::log2(n + 1)));
+}
+
+//! The values whose bounds @c c intersects, by brute force.
+std::vector<int> in_circle(spatial_test::random_scene<tree> const& scene, circle const c) {
+    return scene.expected([&](rect const& b) {
+        point const nearest {
+            std::min(std::max(c.p.x, b.left()), b.right())
+          , std::min(std::max(c.p.y, b.top()),  b.bottom())
+        };
+
+        return intersects(c, nearest);
+    });
+}
+} //namespace
+
+TEST(AabbTree, FatBounds) {
+    tree t {1.0f};
+    ASSERT_EQ(-1, t.height());
+
+    auto const a = t.insert(rect {0, 0, 10, 10}, 1);
+    t.insert(rect {5, 5, 25, 25}, 2);
+    auto const c = t.insert(rect {20, 20, 30, 30}, 3);
+    auto const d = t.insert(rect {10, 0, 20, 10}, 4);
+
+    ASSERT_EQ((rect {20, 20, 30, 30}), t.bounds(c));
+    ASSERT_EQ((rect {19, 19, 31, 31}), t.fat_bounds(c));
+
+    // within the fat bounds, and then out of them.
+    ASSERT_FALSE(t.update(a, rect {-0.5f, 0, 9, 9}));
+    ASSERT_EQ((rect {-0.5f, 0, 9, 9}), t.bounds(a));
+    ASSERT_EQ((std::vector<int> {2}), sorted_query(t, point {9.5f, 9.5f}));
+    ASSERT_TRUE(t.update(d, rect {50, 50, 60, 60}));
+    ASSERT_EQ((rect {49, 49, 65, 65}), t.fat_bounds(d));  // reaching ahead along the move.
+    ASSERT_TRUE(t.update(d, rect {47, 50, 57, 60}));
+    ASSERT_EQ((rect {42, 49, 58, 61}), t.fat_bounds(d));
+    ASSERT_EQ((pairs {{1, 2}, {2, 3}}), sorted_pairs(t));
+
+    t.clear();
+    ASSERT_EQ(-1, t.height());
+}
+
+TEST(AabbTree, CircleQuery) {
+    tree t {1.0f};
+
+    t.insert(rect {0, 0, 10, 10}, 1);
+    t.insert(rect {5, 5, 25, 25}, 2);
+    t.insert(rect {20, 20, 30, 30}, 3);
+
+    ASSERT_EQ((std::vector<int> {2, 3}), sorted_query(t, circle {{27, 27}, 3}));
+
+    // a circle inside a rect, touching none of its corners.
+    ASSERT_EQ((std::vector<int> {2}), sorted_query(t, circle {{15, 15}, 2}));
+
+    // near a corner, but outside.
+    ASSERT_TRUE(sorted_query(t, circle {{33, 33}, 4}).empty());
+}
+
+TEST(AabbTree, RayCast) {
+    tree t {0.5f};
+
+    t.insert(rect {10, -1, 11, 1}, 1);
+    t.insert(rect {20, -1, 21, 1}, 2);
+    t.insert(rect {30,  5, 31, 6}, 3);   // off the ray.
+    t.insert(rect {-5, -1, -4, 1}, 4);   // behind the origin.
+
+    point  const origin {0, 0};
+    tree::vector const dir {1, 0};
+
+    // every hit.
+    std::vector<std::pair<int, float>> hits;
+    t.ray_cast(origin, dir, 100.0f, [&](int const v, float const at) {
+        hits.emplace_back(v, at);
+        return 100.0f;
+    });
+
+    std::sort(hits.begin(), hits.end());
+    ASSERT_EQ(2u, hits.size());
+    ASSERT_EQ(1, hits[0].first);
+    ASSERT_FLOAT_EQ(10.0f, hits[0].second);
+    ASSERT_EQ(2, hits[1].first);
+    ASSERT_FLOAT_EQ(20.0f, hits[1].second);
+
+    // the nearest, by clipping the ray to each hit.
+    int   nearest = 0;
+    float at      = 0.0f;
+    t.ray_cast(origin, dir, 100.0f, [&](int const v, float const tv) {
+        nearest = v;
+        at      = tv;
+        return tv;
+    });
+
+    ASSERT_EQ(1, nearest);
+    ASSERT_FLOAT_EQ(10.0f, at);
+
+    // too short.
+    size_t count = 0;
+    t.ray_cast(origin, dir, 5.0f, [&](int, float const tv) { ++count; return tv; });
+    ASSERT_EQ(0u, count);
+
+    // starting inside.
+    t.ray_cast(point {10.5f, 0}, tree::vector {0, 1}, 1.0f, [&](int const v, float const tv) {
+        nearest = v;
+        at      = tv;
+        return -1.0f;
+    });
+
+    ASSERT_EQ(1, nearest);
+    ASSERT_FLOAT_EQ(0.0f, at);
+}
+
+TEST(AabbTree, StaysBalanced) {
+    tree t {0.0f};
+
+    // sorted insertion is the worst case without rotations.
+    std::vector<tree::handle> handles;
+    for (int i = 0; i < 4096; ++i) {
+        auto const x = static_cast<float>(i);
+        handles.push_back(t.insert(rect {x, 0, x + 0.5f, 1}, i));
+    }
+
+    ASSERT_TRUE(is_balanced(t)) << t.height();
+
+    for (int i = 0; i < 4096; i += 2) {
+        t.remove(handles[i]);
+    }
+
+    ASSERT_EQ(2048u, t.size());
+    ASSERT_TRUE(is_balanced(t)) << t.height();
+}
+
+TEST(AabbTree, FindPairsAndCircles) {
+    tree t {2.0f};
+    bklib::task_pool pool {3};
+
+    spatial_test::random_scene<tree> scene {t, 11, 0.5f};
+    for (int i = 0; i < 2000; ++i) {
+        scene.add();
+    }
+
+    for (int frame = 0; frame < 5; ++frame) {
+        scene.step();
+        ASSERT_TRUE(is_balanced(t)) << t.height();
+
+        auto const expected = scene.expected_pairs();
+
+        // by handle, in parallel.
+        pairs found;
+        for (auto const& p : t.find_pairs(pool)) {
+            ASSERT_LT(p.first, p.second);
+            auto const a = t.value(p.first);
+            auto const b = t.value(p.second);
+            found.emplace_back(std::min(a, b), std::max(a, b));
+        }
+
+        std::sort(found.begin(), found.end());
+        ASSERT_EQ(expected, found);
+
+        for (int q = 0; q < 50; ++q) {
+            auto const r = scene.random_rect();
+            circle const c {r.center(), r.width()};
+
+            ASSERT_EQ(in_circle(scene, c), sorted_query(t, c));
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "circle_collision.hpp"
+#include "aabb_tree.hpp"
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using bklib::circle_array;
+using bklib::circle_contacts;
+using bklib::circle_pair;
+
+namespace {
+using circle = bklib::circle<float>;
+
+//! Every pair of circles whose bounds overlap, by the index of the circles.
+std::vector<circle_pair> broadphase(circle_array const& circles) {
+    bklib::aabb_tree<uint32_t> tree {0.0f};
+    for (size_t i = 0; i < circles.size(); ++i) {
+        // padded: resolved circles are left just touching, and the rounding
+        // of tight bounds could then miss those overlapping by an ulp.
+        auto const c = circles[i];
+        auto const r = c.r + 1.0f;
+        tree.insert(bklib::axis_aligned_rect<float> {
+            c.p.x - r, c.p.y - r, c.p.x + r, c.p.y + r
+        }, static_cast<uint32_t>(i));
+    }
+
+    std::vector<circle_pair> result;
+    tree.for_each_pair([&](uint32_t const a, uint32_t const b) {
+        result.emplace_back(std::min(a, b), std::max(a, b));
+    });
+
+    return result;
+}
+
+//! The sum of the penetrations of every intersecting pair.
+float total_penetration(circle_array const& circles) {
+    float result = 0.0f;
+    for (size_t i = 0; i < circles.size(); ++i) {
+        for (size_t j = i + 1; j < circles.size(); ++j) {
+            result += std::max(0.0f, -bklib::distance<float>(circles[i], circles[j]));
+        }
+    }
+
+    return result;
+}
+} //namespace
+
+TEST(CircleCollision, SeparationVector) {
+    std::mt19937 rng {3};
+    std::uniform_real_distribution<float> coord {-100, 100};
+    std::uniform_real_distribution<float> radius {0, 50};
+
+    // as the two square root form.
+    for (int i = 0; i < 1000; ++i) {
+        circle const a {{coord(rng), coord(rng)}, radius(rng)};
+        circle const b {{coord(rng), coord(rng)}, radius(rng)};
+
+        auto const v        = bklib::separation_vector(a, b);
+        auto const expected = -bklib::distance<float>(a, b) * bklib::direction<float>(a.p - b.p);
+
+        ASSERT_TRUE(bklib::is_equal(expected.x, v.x)) << i;
+        ASSERT_TRUE(bklib::is_equal(expected.y, v.y)) << i;
+    }
+
+    // concentric: no direction to separate in.
+    auto const v = bklib::separation_vector(circle {{1, 2}, 3}, circle {{1, 2}, 1});
+    ASSERT_EQ(0.0f, v.x);
+    ASSERT_EQ(0.0f, v.y);
+
+    // integer circles.
+    auto const w = bklib::separation_vector(bklib::circle<int> {{0, 0}, 5}, bklib::circle<int> {{0, 6}, 2});
+    ASSERT_FLOAT_EQ(0.0f,  w.x);
+    ASSERT_FLOAT_EQ(-1.0f, w.y);
+}
+
+TEST(CircleCollision, Basic) {
+    circle_array circles;
+    circles.push_back(circle {{0,  0},  5});
+    circles.push_back(circle {{6,  0},  2});  // 1 into 0.
+    circles.push_back(circle {{0,  8},  3});  // touching 0: not intersecting.
+    circles.push_back(circle {{0,  0},  1});  // within 0, and concentric.
+    circles.push_back(circle {{30, 30}, 1});
+
+    ASSERT_EQ(5u, circles.size());
+    ASSERT_EQ(2.0f, circles[1].r);
+
+    std::vector<circle_pair> const candidates {{0, 1}, {0, 2}, {2, 4}, {3, 0}};
+
+    circle_contacts contacts;
+    bklib::find_contacts(circles, candidates.data(), candidates.size(), contacts);
+
+    ASSERT_EQ(2u, contacts.size());
+    ASSERT_EQ((std::vector<circle_pair> {{0, 1}, {3, 0}}), contacts.pairs);
+    ASSERT_FLOAT_EQ(-1.0f, contacts.x[0]);
+    ASSERT_FLOAT_EQ(0.0f,  contacts.y[0]);
+    ASSERT_EQ(0.0f, contacts.x[1]);
+    ASSERT_EQ(0.0f, contacts.y[1]);
+
+    bklib::resolve_contacts(circles, contacts);
+
+    ASSERT_FLOAT_EQ(-0.5f, circles.x[0]);
+    ASSERT_FLOAT_EQ(6.5f,  circles.x[1]);
+    ASSERT_FLOAT_EQ(0.0f,  circles.x[3]);
+    ASSERT_FALSE(intersects(circles[0], circles[1]));
+
+    // the previous contacts are replaced.
+    bklib::find_contacts(circles, candidates.data(), candidates.size(), contacts);
+    ASSERT_EQ((std::vector<circle_pair> {{3, 0}}), contacts.pairs);
+
+    bklib::find_contacts(circles, nullptr, 0, contacts);
+    ASSERT_TRUE(contacts.empty());
+}
+
+TEST(CircleCollision, MatchesBruteForce) {
+    std::mt19937 rng {9};
+    std::uniform_real_distribution<float> coord  {0, 500};
+    std::uniform_real_distribution<float> radius {1, 6};
+
+    circle_array circles;
+    for (int i = 0; i < 1500; ++i) {
+        circles.push_back(circle {{coord(rng), coord(rng)}, radius(rng)});
+    }
+
+    bklib::task_pool pool {3};
+
+    auto const before = total_penetration(circles);
+    ASSERT_LT(0.0f, before);
+
+    circle_contacts contacts;
+    for (int step = 0; step < 10; ++step) {
+        auto const candidates = broadphase(circles);
+        bklib::find_contacts(circles, candidates.data(), candidates.size(), contacts);
+
+        std::vector<circle_pair> expected;
+        for (size_t i = 0; i < circles.size(); ++i) {
+            for (size_t j = i + 1; j < circles.size(); ++j) {
+                if (intersects(circles[i], circles[j])) {
+                    expected.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
+                }
+            }
+        }
+
+        auto found = contacts.pairs;
+        std::sort(found.begin(), found.end());
+        ASSERT_EQ(expected, found) << step;
+
+        for (size_t i = 0; i < contacts.size(); ++i) {
+            auto const p = contacts.pairs[i];
+            auto const v = bklib::separation_vector(circles[p.first], circles[p.second]);
+            ASSERT_TRUE(bklib::is_equal(v.x, contacts.x[i])) << step << " " << i;
+            ASSERT_TRUE(bklib::is_equal(v.y, contacts.y[i])) << step << " " << i;
+        }
+
+        // in parallel, exactly as in serial.
+        auto serial = circles;
+        bklib::resolve_contacts(serial, contacts);
+        bklib::resolve_contacts(circles, contacts, pool);
+
+        ASSERT_TRUE(serial.x == circles.x) << step;
+        ASSERT_TRUE(serial.y == circles.y) << step;
+    }
+
+    ASSERT_LT(total_penetration(circles), before * 0.1f);
+}
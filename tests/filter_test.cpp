@@ -0,0 +1,84 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "filter.hpp"
+
+#include <cmath>
+
+using bklib::ema_filter;
+using bklib::one_euro_filter;
+
+TEST(Filter, Ema) {
+    ema_filter<float> f {0.5f};
+
+    ASSERT_TRUE(f.empty());
+    ASSERT_FLOAT_EQ(10.0f, f(10.0f));
+    ASSERT_FLOAT_EQ(15.0f, f(20.0f));
+    ASSERT_FLOAT_EQ(17.5f, f(20.0f));
+
+    f.reset();
+    ASSERT_TRUE(f.empty());
+    ASSERT_FLOAT_EQ(4.0f, f(4.0f));
+
+    // points and vectors.
+    ema_filter<bklib::point2d<float>> p {0.25f};
+    p({0.0f, 0.0f});
+    auto const r = p({4.0f, -8.0f});
+    ASSERT_FLOAT_EQ(1.0f, r.x);
+    ASSERT_FLOAT_EQ(-2.0f, r.y);
+}
+
+TEST(Filter, LowPassAlpha) {
+    // higher cutoffs and longer periods follow the signal more closely.
+    ASSERT_LT(bklib::low_pass_alpha(1.0f, 0.01f), bklib::low_pass_alpha(10.0f, 0.01f));
+    ASSERT_LT(bklib::low_pass_alpha(1.0f, 0.01f), bklib::low_pass_alpha(1.0f, 0.1f));
+    ASSERT_GT(bklib::low_pass_alpha(1.0f, 0.01f), 0.0f);
+    ASSERT_LT(bklib::low_pass_alpha(1000.0f, 1.0f), 1.0f);
+}
+
+TEST(Filter, OneEuro) {
+    float const dt = 0.01f;
+
+    // slow: noise is smoothed.
+    one_euro_filter<float> slow;
+    float max_error = 0.0f;
+    for (int i = 0; i < 500; ++i) {
+        auto const y = slow(5.0f + ((i % 2) ? 0.5f : -0.5f), dt);
+        if (i > 100) {
+            max_error = std::max(max_error, std::abs(y - 5.0f));
+        }
+    }
+    ASSERT_LT(max_error, 0.1f);
+
+    // fast: the filter keeps up with a ramp much better than at rest.
+    one_euro_filter<float> tracking {{1.0f, 0.5f, 1.0f}};
+    one_euro_filter<float> fixed    {{1.0f, 0.0f, 1.0f}};
+
+    float x = 0.0f;
+    for (int i = 0; i < 100; ++i) {
+        x += 10.0f;
+        tracking(x, dt);
+        fixed(x, dt);
+    }
+
+    ASSERT_LT(std::abs(x - tracking.value()), std::abs(x - fixed.value()) / 4.0f);
+    ASSERT_NEAR(1000.0f, tracking.rate(), 50.0f);
+
+    // no time elapsed: unchanged.
+    auto const before = tracking.value();
+    ASSERT_FLOAT_EQ(before, tracking(x + 100.0f, 0.0f));
+}
+
+TEST(Filter, OneEuroPoint) {
+    one_euro_filter<bklib::point2d<float>> f;
+
+    f({1.0f, 2.0f}, 0.0f);
+    ASSERT_FLOAT_EQ(1.0f, f.value().x);
+    ASSERT_FLOAT_EQ(2.0f, f.value().y);
+
+    for (int i = 0; i < 1000; ++i) {
+        f({3.0f, -4.0f}, 0.01f);
+    }
+
+    ASSERT_NEAR(3.0f,  f.value().x, 1e-3f);
+    ASSERT_NEAR(-4.0f, f.value().y, 1e-3f);
+}
@@ -0,0 +1,111 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "histogram.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using bklib::hdr_histogram;
+using bklib::histogram_snapshot;
+
+TEST(Histogram, Buckets) {
+    using h = hdr_histogram;
+
+    ASSERT_EQ(0u, h::bucket(0));
+    ASSERT_EQ(h::BUCKETS - 1, h::bucket(std::numeric_limits<uint64_t>::max()));
+
+    for (size_t i = 0; i + 1 < h::BUCKETS; ++i) {
+        ASSERT_EQ(h::bucket_max(i) + 1, h::bucket_min(i + 1));
+    }
+
+    std::mt19937_64 rng {42};
+    for (int i = 0; i < 100000; ++i) {
+        auto const v = rng() >> (rng() % 64);
+        auto const b = h::bucket(v);
+
+        ASSERT_LE(h::bucket_min(b), v);
+        ASSERT_GE(h::bucket_max(b), v);
+
+        // within the stated precision.
+        auto const width = h::bucket_max(b) - h::bucket_min(b);
+        ASSERT_LE(static_cast<double>(width), static_cast<double>(v) / 32.0 + 1.0);
+    }
+}
+
+TEST(Histogram, Percentiles) {
+    hdr_histogram histogram;
+
+    ASSERT_TRUE(histogram.snapshot().empty());
+    ASSERT_EQ(0u, histogram.snapshot().percentile(50));
+
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        histogram.record(i * 1000);
+    }
+
+    auto const s = histogram.snapshot();
+    ASSERT_EQ(10000u, s.count());
+    ASSERT_DOUBLE_EQ(5000500.0, s.mean());
+
+    auto const near = [](uint64_t const actual, double const expected) {
+        return std::abs(static_cast<double>(actual) - expected) <= expected / 32.0;
+    };
+
+    ASSERT_TRUE(near(s.min(), 1000));
+    ASSERT_TRUE(near(s.max(), 10000000));
+    ASSERT_TRUE(near(s.percentile(50),   5000000));
+    ASSERT_TRUE(near(s.percentile(99),   9900000));
+    ASSERT_TRUE(near(s.percentile(99.9), 9990000));
+    ASSERT_GE(s.percentile(100), 10000000u);
+}
+
+TEST(Histogram, Reset) {
+    hdr_histogram histogram;
+
+    histogram.record(10);
+    histogram.record(20);
+
+    auto s = histogram.snapshot_and_reset();
+    ASSERT_EQ(2u, s.count());
+    ASSERT_TRUE(histogram.snapshot().empty());
+
+    histogram.record(30);
+    s += histogram.snapshot();
+
+    ASSERT_EQ(3u, s.count());
+    ASSERT_EQ(10u, s.min());
+    ASSERT_EQ(30u, s.max());
+    ASSERT_DOUBLE_EQ(20.0, s.mean());
+}
+
+TEST(Histogram, Concurrent) {
+    hdr_histogram histogram;
+
+    int const threads = 4;
+    int const values  = 100000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < values; ++i) {
+                histogram.record(static_cast<uint64_t>(t * values + i));
+            }
+        });
+    }
+
+    // snapshots while recording must not disturb it.
+    histogram_snapshot total;
+    for (int i = 0; i < 10; ++i) {
+        total += histogram.snapshot_and_reset();
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    total += histogram.snapshot_and_reset();
+
+    ASSERT_EQ(static_cast<uint64_t>(threads * values), total.count());
+}
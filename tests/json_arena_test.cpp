@@ -0,0 +1,128 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json.hpp"
+
+#include <string>
+
+namespace json   = bklib::json;
+namespace detail = bklib::json::detail;
+
+namespace {
+//==============================================================================
+//! {"k0": 0, "k1": 1, ...}
+std::string make_object(int const size) {
+    std::string result = "{";
+
+    for (int i = 0; i < size; ++i) {
+        if (i) result += ", ";
+        result += "\"k" + std::to_string(i) + "\": " + std::to_string(i);
+    }
+
+    return result + "}";
+}
+} //namespace
+
+//==============================================================================
+TEST(JsonArena, NodeSize) {
+    ASSERT_LE(sizeof(detail::node), 16u);
+}
+//==============================================================================
+TEST(JsonArena, Types) {
+    auto const doc = json::parse(R"(
+        [1, -2, 18446744073709551615, 1.5, 1e3, "s", true, false, null, [], {}]
+    )");
+
+    auto const root = doc.root();
+
+    ASSERT_EQ(json::type::signed_int,   root[0].type());
+    ASSERT_EQ(json::type::signed_int,   root[1].type());
+    ASSERT_EQ(json::type::unsigned_int, root[2].type());
+    ASSERT_EQ(json::type::real,         root[3].type());
+    ASSERT_EQ(json::type::real,         root[4].type());
+    ASSERT_EQ(json::type::string,       root[5].type());
+    ASSERT_EQ(json::type::boolean,      root[6].type());
+    ASSERT_EQ(json::type::boolean,      root[7].type());
+    ASSERT_EQ(json::type::null,         root[8].type());
+    ASSERT_EQ(json::type::array,        root[9].type());
+    ASSERT_EQ(json::type::object,       root[10].type());
+
+    ASSERT_TRUE(root[2].is_integral());
+    ASSERT_FALSE(root[4].is_integral());
+    ASSERT_TRUE(root[6].as_bool());
+    ASSERT_FALSE(root[7].as_bool());
+    ASSERT_EQ("1.5", root[3].raw());
+}
+//==============================================================================
+TEST(JsonArena, SortedMembers) {
+    auto const doc = json::parse(R"({"b": 2, "a": 1, "c": {"z": 0, "y": 1}, "a": 3})");
+    auto const root = doc.root();
+
+    ASSERT_EQ(4u, root.size());
+
+    std::string names;
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        names += it.key().to_string();
+    }
+
+    ASSERT_EQ("aabc", names);
+
+    // the first of duplicate names.
+    ASSERT_EQ(1, json::require_int(json::require_key(root, "a")));
+    ASSERT_EQ(1, json::require_int(json::require_key(root.find("c"), "y")));
+    ASSERT_FALSE(!!root.find(""));
+    ASSERT_FALSE(!!root.find("d"));
+}
+//==============================================================================
+TEST(JsonArena, HashIndex) {
+    for (auto const size : {detail::HASH_THRESHOLD, detail::HASH_THRESHOLD + 1, size_t {1000}}) {
+        auto const source = make_object(static_cast<int>(size));
+        auto const doc    = json::parse(source);
+        auto const root   = doc.root();
+
+        ASSERT_EQ(size, root.size());
+
+        for (size_t i = 0; i < size; ++i) {
+            auto const key = "k" + std::to_string(i);
+            ASSERT_EQ(static_cast<int>(i), json::require_int(json::require_key(root, key)));
+        }
+
+        ASSERT_FALSE(!!root.find("k"));
+        ASSERT_FALSE(!!root.find("missing"));
+    }
+
+    // duplicates in a hashed object.
+    auto source = make_object(40);
+    source.back() = ',';
+    source += R"( "k7": -1})";
+
+    auto const doc = json::parse(source);
+    ASSERT_EQ(41u, doc.root().size());
+    ASSERT_EQ(7, json::require_int(json::require_key(doc.root(), "k7")));
+}
+//==============================================================================
+TEST(JsonArena, DecodedStrings) {
+    auto const doc = json::parse(R"({"key": "tab\there", "plain": "text"})");
+    auto const root = doc.root();
+
+    auto const value = json::require_key(root, "key");
+    ASSERT_TRUE(value.has_escapes());
+    ASSERT_EQ("tab\there", json::require_string_ref(value));
+
+    auto const plain = json::require_key(root, "plain");
+    ASSERT_FALSE(plain.has_escapes());
+
+    // unescaped strings are views of the source.
+    auto const source = doc.source();
+    ASSERT_GE(plain.raw().data(), source.data());
+    ASSERT_LT(plain.raw().data(), source.data() + source.size());
+}
+//==============================================================================
+TEST(JsonArena, OwnedSource) {
+    json::document doc {bklib::utf8string {R"(["short"])"}};
+
+    auto const element = doc.root()[0];
+    auto const moved   = std::move(doc);
+
+    ASSERT_EQ("short", element.as_string());
+    ASSERT_EQ(R"(["short"])", moved.source());
+}
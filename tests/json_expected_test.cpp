@@ -0,0 +1,161 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json.hpp"
+#include "json_schema.hpp"
+
+#include <string>
+#include <vector>
+
+namespace json = bklib::json;
+
+using json::error_kind;
+
+namespace {
+//==============================================================================
+struct point_def {
+    int x;
+    int y;
+};
+} //namespace
+
+namespace bklib { namespace json {
+template <> struct schema<point_def> {
+    static auto fields() {
+        return json::make_fields(
+            BK_JSON_REQUIRED(point_def, x)
+          , BK_JSON_REQUIRED(point_def, y)
+        );
+    }
+};
+}} //namespace bklib::json
+
+//==============================================================================
+TEST(JsonExpected, TryFunctions) {
+    auto const doc = json::parse(R"({"a": [1, 2], "s": "text", "big": 4294967296})");
+    auto const root = doc.root();
+
+    auto const a = json::try_key(root, "a");
+    ASSERT_TRUE(!!a);
+    ASSERT_TRUE(!!json::try_array(*a));
+    ASSERT_TRUE(!!json::try_size(*a, 2));
+    ASSERT_EQ(2, *json::try_int(*json::try_key(*a, 1)));
+    ASSERT_EQ("text", *json::try_string_ref(root.find("s")));
+    ASSERT_EQ("text", *json::try_string(root.find("s")));
+
+    auto const missing = json::try_key(root, "missing");
+    ASSERT_FALSE(!!missing);
+    ASSERT_EQ(error_kind::bad_index, missing.error().kind);
+    ASSERT_TRUE(missing.error().has_key);
+    ASSERT_EQ("missing", missing.error().key);
+
+    auto const index = json::try_key(*a, 5);
+    ASSERT_EQ(error_kind::bad_index, index.error().kind);
+    ASSERT_EQ(5u, index.error().index);
+
+    auto const type = json::try_object(*a);
+    ASSERT_EQ(error_kind::bad_type, type.error().kind);
+    ASSERT_EQ(json::type::object, type.error().expected_type);
+    ASSERT_EQ(json::type::array,  type.error().actual_type);
+
+    auto const size = json::try_size(*a, 3, 4);
+    ASSERT_EQ(error_kind::bad_size, size.error().kind);
+    ASSERT_EQ(2u, size.error().actual_size);
+
+    auto const big = json::try_int(root.find("big"));
+    ASSERT_EQ(error_kind::bad_value, big.error().kind);
+    ASSERT_EQ("4294967296", big.error().value);
+}
+//==============================================================================
+TEST(JsonExpected, Raise) {
+    auto const doc = json::parse(R"({"a": [1, 2], "big": 4294967296})");
+    auto const root = doc.root();
+    auto const a    = root.find("a");
+
+    ASSERT_THROW(json::try_key(root, "missing").value(), json::error::bad_index);
+    ASSERT_THROW(json::try_size(a, 3).value(),           json::error::bad_size);
+    ASSERT_THROW(json::try_object(a).value(),            json::error::bad_type);
+    ASSERT_THROW(json::try_int(root.find("big")).value(), json::error::bad_value);
+
+    try {
+        auto record = json::try_key(root, "missing").error();
+        record.add_rule("inner");
+        record.add_rule("outer");
+        record.raise();
+        FAIL();
+    } catch (json::error::bad_index const& e) {
+        auto const index = boost::get_error_info<json::error::info_index>(e);
+        ASSERT_TRUE(index != nullptr);
+
+        auto const trace = boost::get_error_info<json::error::info_rule_trace>(e);
+        ASSERT_TRUE(trace != nullptr);
+        ASSERT_EQ(2u, trace->size());
+        ASSERT_EQ("inner", (*trace)[0]);
+        ASSERT_EQ("outer", (*trace)[1]);
+    }
+}
+//==============================================================================
+TEST(JsonExpected, TraceLimit) {
+    json::error_record record = json::error_record::make_bad_value("v");
+
+    for (size_t i = 0; i < json::error_record::MAX_TRACE + 2; ++i) {
+        record.add_rule("rule");
+    }
+
+    ASSERT_EQ(json::error_record::MAX_TRACE, record.trace_size);
+}
+//==============================================================================
+TEST(JsonExpected, ForEachElement) {
+    auto const doc = json::parse(R"([
+        {"x": 1, "y": 2}, {"x": 3}, {"x": 4, "y": 5}, [], {"x": 1.5, "y": 0}
+    ])");
+
+    std::vector<point_def>           points;
+    std::vector<json::element_error> errors;
+
+    auto const result = json::for_each_element_try(doc.root(), [&](json::cref element) {
+        json::error_record error {};
+        point_def p;
+
+        if (json::try_decode(element, p, error)) {
+            points.push_back(p);
+        }
+
+        return error;
+    }, errors);
+
+    ASSERT_FALSE(!!result);
+    ASSERT_EQ(2u, points.size());
+    ASSERT_EQ(4, points[1].x);
+
+    ASSERT_EQ(3u, errors.size());
+
+    ASSERT_EQ(1u, errors[0].index);
+    ASSERT_EQ(error_kind::bad_index, errors[0].error.kind);
+    ASSERT_EQ("y", errors[0].error.key);
+
+    ASSERT_EQ(3u, errors[1].index);
+    ASSERT_EQ(error_kind::bad_type, errors[1].error.kind);
+
+    ASSERT_EQ(4u, errors[2].index);
+    ASSERT_EQ(error_kind::bad_type, errors[2].error.kind);
+    ASSERT_EQ(1u, errors[2].error.trace_size);
+    ASSERT_EQ("x", errors[2].error.trace[0]);
+
+    auto const not_array = json::for_each_element_try(doc.root()[0], [](json::cref) {
+        return json::error_record {};
+    }, errors);
+
+    ASSERT_EQ(error_kind::bad_type, not_array.kind);
+}
+//==============================================================================
+TEST(JsonExpected, TryDecode) {
+    auto const doc = json::parse(R"([{"x": 1, "y": 2}, {"x": 1}])");
+
+    auto const good = json::try_decode<point_def>(doc.root()[0]);
+    ASSERT_TRUE(!!good);
+    ASSERT_EQ(2, good->y);
+
+    auto const bad = json::try_decode<std::vector<point_def>>(doc.root());
+    ASSERT_FALSE(!!bad);
+    ASSERT_EQ(error_kind::bad_index, bad.error().kind);
+}
@@ -0,0 +1,176 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json.hpp"
+#include "json_index.hpp"
+
+#include <random>
+
+namespace json   = bklib::json;
+namespace detail = bklib::json::detail;
+
+using bklib::string_ref;
+
+namespace {
+//==============================================================================
+std::vector<bklib::uint32_t> structurals(string_ref const str, bool& ok) {
+    std::vector<bklib::uint32_t> result;
+    ok = detail::find_structurals(str, result);
+    return result;
+}
+
+std::vector<bklib::uint32_t> structurals_scalar(string_ref const str, bool& ok) {
+    std::vector<bklib::uint32_t> result;
+    ok = detail::find_structurals_scalar(str, result);
+    return result;
+}
+
+//! Whether json::reader accepts @c str; the reference for the tape builder.
+bool reader_accepts(string_ref const str) {
+    try {
+        json::reader reader {str};
+        while (reader.next() != json::token::end) {
+        }
+    } catch (json::error::parse_error const&) {
+        return false;
+    }
+
+    return true;
+}
+
+bool document_accepts(string_ref const str) {
+    try {
+        json::document doc {str};
+    } catch (json::error::parse_error const&) {
+        return false;
+    }
+
+    return true;
+}
+} //namespace
+
+//==============================================================================
+TEST(JsonIndex, Structurals) {
+    string_ref const str {R"({"a\"b" : [1, -2.5e3,true], "c":null})"};
+
+    bool ok = false;
+    auto const result = structurals(str, ok);
+
+    std::vector<bklib::uint32_t> const expected {
+        0, 1, 8, 10, 11, 12, 14, 20, 21, 25, 26, 28, 31, 32, 36
+    };
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(expected, result);
+
+    ASSERT_FALSE(structurals(string_ref{"[\"abc"}, ok).empty());
+    ASSERT_FALSE(ok);
+}
+//==============================================================================
+TEST(JsonIndex, BackslashRunsAcrossBlocks) {
+    // runs of backslashes ending on either side of the 64 byte boundary.
+    for (size_t run = 1; run < 8; ++run) {
+        for (size_t start = 56; start < 66; ++start) {
+            std::string str = "[\"" + std::string(start - 2, 'x');
+            str.append(run, '\\');
+            str += "\"], 1]";
+
+            bool simd_ok   = false;
+            bool scalar_ok = false;
+
+            auto const a = structurals(str, simd_ok);
+            auto const b = structurals_scalar(str, scalar_ok);
+
+            ASSERT_EQ(scalar_ok, simd_ok) << str;
+            ASSERT_EQ(b, a) << str;
+        }
+    }
+}
+//==============================================================================
+TEST(JsonIndex, FuzzStructurals) {
+    std::mt19937 random {4321};
+
+    static char const alphabet[] = "{}[]:, \t\n\"\"\"\\\\ax1-";
+
+    std::uniform_int_distribution<size_t> size_dist {0, 300};
+    std::uniform_int_distribution<size_t> char_dist {0, sizeof(alphabet) - 2};
+
+    for (int n = 0; n < 5000; ++n) {
+        std::string str(size_dist(random), ' ');
+        for (auto& c : str) {
+            c = alphabet[char_dist(random)];
+        }
+
+        bool simd_ok   = false;
+        bool scalar_ok = false;
+
+        auto const a = structurals(str, simd_ok);
+        auto const b = structurals_scalar(str, scalar_ok);
+
+        ASSERT_EQ(scalar_ok, simd_ok) << str;
+        ASSERT_EQ(b, a) << str;
+    }
+}
+//==============================================================================
+TEST(JsonIndex, TapeLinks) {
+    auto doc = json::parse(R"([[1, 2], {"a": []}, "x"])");
+
+    auto const root = doc.root();
+    ASSERT_EQ(3u, root.size());
+    ASSERT_EQ(2u, root[0].size());
+    ASSERT_EQ(1u, root[1].size());
+    ASSERT_EQ(0u, root[1].find("a").size());
+    ASSERT_EQ(1, root[0][0].as_double());
+    ASSERT_EQ(2, root[0][1].as_double());
+    ASSERT_EQ("x", root[2].raw());
+    ASSERT_FALSE(!!root[3]);
+
+    // values stay valid when the document moves.
+    auto const element = root[2];
+    auto const moved   = std::move(doc);
+    ASSERT_EQ("x", element.as_string());
+}
+//==============================================================================
+TEST(JsonIndex, ScalarEnds) {
+    ASSERT_THROW(json::parse("[1x]"),     json::error::parse_error);
+    ASSERT_THROW(json::parse("[truex]"),  json::error::parse_error);
+    ASSERT_THROW(json::parse("[\"a\"b]"), json::error::parse_error);
+    ASSERT_THROW(json::parse("[1 2]"),    json::error::parse_error);
+    ASSERT_THROW(json::parse("[\"a\\q\"]"), json::error::parse_error);
+    ASSERT_THROW(json::parse(""),         json::error::parse_error);
+
+    auto const doc = json::parse(" [ 1 , 2.5 ,\ttrue\n] ");
+    ASSERT_EQ("1",    doc.root()[0].raw());
+    ASSERT_EQ("2.5",  doc.root()[1].raw());
+    ASSERT_EQ("true", doc.root()[2].raw());
+}
+//==============================================================================
+TEST(JsonIndex, FuzzAgreesWithReader) {
+    std::mt19937 random {8765};
+
+    std::string const valid = R"({"list": [10, [20, -21.5e1], {"x": "y\"z\\"}, null],)"
+                              R"( "key": true, "f": 0.25, "e": {}, "a": []})";
+
+    static char const alphabet[] = "{}[]:,\" \\0123456789.eE+-tfnulrsax";
+
+    std::uniform_int_distribution<size_t> pos_dist  {0, valid.size() - 1};
+    std::uniform_int_distribution<size_t> char_dist {0, sizeof(alphabet) - 2};
+    std::uniform_int_distribution<int>    edit_dist {1, 3};
+
+    ASSERT_TRUE(document_accepts(valid));
+
+    for (int n = 0; n < 20000; ++n) {
+        auto str = valid;
+
+        for (auto edits = edit_dist(random); edits > 0; --edits) {
+            auto const pos = pos_dist(random) % str.size();
+
+            switch (edit_dist(random)) {
+            case 1 : str[pos] = alphabet[char_dist(random)]; break;
+            case 2 : str.erase(pos, 1); break;
+            case 3 : str.insert(pos, 1, alphabet[char_dist(random)]); break;
+            }
+        }
+
+        ASSERT_EQ(reader_accepts(str), document_accepts(str)) << str;
+    }
+}
@@ -0,0 +1,213 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json.hpp"
+
+#include <clocale>
+#include <string>
+
+namespace json = bklib::json;
+
+using json::token;
+
+namespace {
+    std::vector<token> tokens_of(bklib::string_ref const source) {
+        std::vector<token> result;
+
+        json::reader reader {source};
+        while (reader.next() != token::end) {
+            result.push_back(reader.current());
+        }
+
+        return result;
+    }
+} //namespace
+
+//==============================================================================
+TEST(JsonReader, Tokens) {
+    auto const result = tokens_of(R"( {"a": [1, -2.5e3, "x"], "b": {}, "c": [true, false, null]} )");
+
+    std::vector<token> const expected {
+        token::begin_object
+      , token::key, token::begin_array
+      , token::number, token::number, token::string
+      , token::end_array
+      , token::key, token::begin_object, token::end_object
+      , token::key, token::begin_array
+      , token::true_value, token::false_value, token::null_value
+      , token::end_array
+      , token::end_object
+    };
+
+    ASSERT_EQ(expected, result);
+}
+//==============================================================================
+TEST(JsonReader, Values) {
+    char const data[] {R"({"key\n": "va\"lue", "n": -0.5})"};
+
+    json::reader reader {data};
+
+    ASSERT_EQ(token::begin_object, reader.next());
+    ASSERT_EQ(1u, reader.depth());
+
+    ASSERT_EQ(token::key, reader.next());
+    ASSERT_EQ("key\\n", reader.value());
+    ASSERT_TRUE(reader.has_escapes());
+    ASSERT_EQ(data + 2, reader.value().data()); // a view, not a copy
+
+    ASSERT_EQ(token::string, reader.next());
+    ASSERT_EQ("va\\\"lue", reader.value());
+    ASSERT_EQ("va\"lue", json::unescape(reader.value()));
+
+    ASSERT_EQ(token::key, reader.next());
+    ASSERT_EQ("n", reader.value());
+    ASSERT_FALSE(reader.has_escapes());
+
+    ASSERT_EQ(token::number, reader.next());
+    ASSERT_EQ("-0.5", reader.value());
+
+    ASSERT_EQ(token::end_object, reader.next());
+    ASSERT_EQ(token::end, reader.next());
+    ASSERT_EQ(token::end, reader.next());
+}
+//==============================================================================
+TEST(JsonReader, Skip) {
+    json::reader reader {R"([{"a": [1, {"b": 2}]}, 3])"};
+
+    ASSERT_EQ(token::begin_array, reader.next());
+    ASSERT_EQ(token::begin_object, reader.next());
+
+    reader.skip();
+    ASSERT_EQ(token::end_object, reader.current());
+
+    ASSERT_EQ(token::number, reader.next());
+    ASSERT_EQ("3", reader.value());
+}
+//==============================================================================
+TEST(JsonReader, Unescape) {
+    ASSERT_EQ("\"\\/\b\f\n\r\t", json::unescape(R"(\"\\\/\b\f\n\r\t)"));
+    ASSERT_EQ("\xC3\xA9", json::unescape(R"(\u00e9)"));
+    ASSERT_EQ("\xE2\x82\xAC", json::unescape(R"(\u20AC)"));
+    ASSERT_EQ("\xF0\x9F\x98\x80", json::unescape(R"(\ud83d\ude00)"));
+    ASSERT_EQ("\xEF\xBF\xBD" "x", json::unescape(R"(\ud83dx)"));
+}
+//==============================================================================
+TEST(JsonReader, Errors) {
+    char const* const bad[] = {
+        ""
+      , "   "
+      , "{"
+      , "[1,]"
+      , "{\"a\" 1}"
+      , "{\"a\": 1,}"
+      , "{1: 2}"
+      , "[01]"
+      , "[1.]"
+      , "[.5]"
+      , "[1e]"
+      , "[-]"
+      , "[tru]"
+      , "[\"abc]"
+      , "[\"\\x\"]"
+      , "[\"\\u12G4\"]"
+      , "[\"a\tb\"]"
+      , "[1] 2"
+      , "]"
+    };
+
+    for (auto const source : bad) {
+        ASSERT_THROW(tokens_of(source), json::error::parse_error) << source;
+    }
+}
+//==============================================================================
+TEST(JsonReader, MaxDepth) {
+    std::string deep(json::reader::MAX_DEPTH, '[');
+    deep.append(json::reader::MAX_DEPTH, ']');
+    ASSERT_NO_THROW(tokens_of(deep));
+
+    std::string too_deep(json::reader::MAX_DEPTH + 1, '[');
+    too_deep.append(json::reader::MAX_DEPTH + 1, ']');
+    ASSERT_THROW(tokens_of(too_deep), json::error::parse_error);
+}
+//==============================================================================
+TEST(JsonReader, ValueRefNavigation) {
+    auto const doc = json::parse(R"(
+        {"list": [10, [20, 21], {"x": "y"}, null], "k\u0065y": true, "f": 0.25}
+    )");
+
+    auto const root = doc.root();
+    ASSERT_EQ(json::type::object, root.type());
+    ASSERT_EQ(3u, root.size());
+
+    auto const list = root.find("list");
+    ASSERT_TRUE(list.is_array());
+    ASSERT_EQ(4u, list.size());
+    ASSERT_EQ(json::type::signed_int, list[0].type());
+    ASSERT_EQ(2u, list[1].size());
+    ASSERT_EQ("y", list[2].find("x").as_string());
+    ASSERT_TRUE(list[3].is_null());
+    ASSERT_FALSE(!!list[4]);
+
+    ASSERT_TRUE(root.find("key").as_bool()); // escaped member name
+    ASSERT_FALSE(!!root.find("missing"));
+    ASSERT_DOUBLE_EQ(0.25, root.find("f").as_double());
+
+    std::vector<bklib::string_ref> keys;
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        keys.push_back(it.key());
+    }
+
+    // members are sorted by name.
+    ASSERT_EQ(3u, keys.size());
+    ASSERT_EQ("f",    keys[0]);
+    ASSERT_EQ("key",  keys[1]);
+    ASSERT_EQ("list", keys[2]);
+}
+//==============================================================================
+TEST(JsonReader, ScalarDocument) {
+    char const data[] = {'4', '2'}; // not null terminated
+
+    auto const doc = json::parse(bklib::string_ref{data, sizeof(data)});
+    ASSERT_EQ(json::type::signed_int, doc.root().type());
+
+    bklib::int64_t value = 0;
+    ASSERT_TRUE(doc.root().as_int(value));
+    ASSERT_EQ(42, value);
+}
+//==============================================================================
+TEST(JsonReader, RealsIgnoreTheLocale) {
+    // a locale whose decimal point is ',', where there is one.
+    char const* const names[] = {
+        "de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR", "German"
+    };
+
+    std::string const old_locale {std::setlocale(LC_ALL, nullptr)};
+    struct restore_t {
+        ~restore_t() { std::setlocale(LC_ALL, name.c_str()); }
+        std::string const& name;
+    } const restore {old_locale};
+
+    bool found = false;
+    for (auto const name : names) {
+        if (std::setlocale(LC_ALL, name) && *std::localeconv()->decimal_point == ',') {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        GTEST_SKIP() << "no locale with a ',' decimal point";
+    }
+
+    // longer than any buffer on the stack, too.
+    std::string const long_real = "0." + std::string(200, '0') + "1e201";
+
+    std::string const source = "[1.5, 2.25e1, -0.125, " + long_real + "]";
+
+    auto const doc  = json::parse(source);
+    auto const root = doc.root();
+
+    ASSERT_DOUBLE_EQ(1.5,    root[0].as_double());
+    ASSERT_DOUBLE_EQ(22.5,   root[1].as_double());
+    ASSERT_DOUBLE_EQ(-0.125, root[2].as_double());
+    ASSERT_DOUBLE_EQ(1.0,    root[3].as_double());
+}
@@ -0,0 +1,137 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json_schema.hpp"
+
+namespace json = bklib::json;
+
+using bklib::string_ref;
+using bklib::utf8string;
+
+namespace {
+//==============================================================================
+struct stats_def {
+    int      health = 0;
+    unsigned speed  = 0;
+    float    scale  = 1.0f;
+};
+
+struct item_def {
+    string_ref                id;
+    utf8string                name;
+    bool                      stackable = false;
+    bklib::uint8_t            count     = 1;
+    std::array<int, 2>        size;
+    std::vector<string_ref>   tags;
+    stats_def                 stats;
+};
+} //namespace
+
+namespace bklib { namespace json {
+template <> struct schema<stats_def> {
+    static auto fields() {
+        return json::make_fields(
+            BK_JSON_REQUIRED(stats_def, health)
+          , BK_JSON_REQUIRED(stats_def, speed)
+          , BK_JSON_OPTIONAL(stats_def, scale)
+        );
+    }
+};
+
+template <> struct schema<item_def> {
+    static auto fields() {
+        return json::make_fields(
+            BK_JSON_REQUIRED(item_def, id)
+          , BK_JSON_REQUIRED(item_def, name)
+          , BK_JSON_OPTIONAL(item_def, stackable)
+          , BK_JSON_OPTIONAL(item_def, count)
+          , BK_JSON_REQUIRED(item_def, size)
+          , BK_JSON_OPTIONAL(item_def, tags)
+          , BK_JSON_REQUIRED(item_def, stats)
+        );
+    }
+};
+}} //namespace bklib::json
+
+//==============================================================================
+TEST(JsonSchema, Decode) {
+    auto const doc = json::parse(R"({
+        "stats":  {"speed": 3, "health": 10},
+        "name":   "Sword!",
+        "id":     "sword",
+        "size":   [1, 3],
+        "unused": {"ignored": true},
+        "tags":   ["weapon", "melee"],
+        "count":  5
+    })");
+
+    auto const item = json::decode<item_def>(doc.root());
+
+    ASSERT_EQ("sword",  item.id);
+    ASSERT_EQ("Sword!", item.name);
+    ASSERT_FALSE(item.stackable);
+    ASSERT_EQ(5, item.count);
+    ASSERT_EQ(1, item.size[0]);
+    ASSERT_EQ(3, item.size[1]);
+    ASSERT_EQ(2u, item.tags.size());
+    ASSERT_EQ("melee", item.tags[1]);
+    ASSERT_EQ(10, item.stats.health);
+    ASSERT_EQ(3u, item.stats.speed);
+    ASSERT_EQ(1.0f, item.stats.scale);
+}
+//==============================================================================
+TEST(JsonSchema, Errors) {
+    auto const decode = [](string_ref const source) {
+        auto const doc = json::parse(source);
+        json::decode<item_def>(doc.root());
+    };
+
+    // missing
+    try {
+        decode(R"({"id": "a", "name": "b", "size": [1, 2]})");
+        FAIL();
+    } catch (json::error::bad_index const& e) {
+        auto const ptr = boost::get_error_info<json::error::info_index>(e);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(json::index {utf8string {"stats"}}, *ptr);
+    }
+
+    // bad type, nested
+    try {
+        decode(R"({"id": "a", "name": "b", "size": [1, 2], "stats": {"health": "x", "speed": 1}})");
+        FAIL();
+    } catch (json::error::bad_type const& e) {
+        auto const ptr = boost::get_error_info<json::error::info_rule_trace>(e);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(2u, ptr->size());
+        ASSERT_EQ("health", (*ptr)[0]);
+        ASSERT_EQ("stats",  (*ptr)[1]);
+    }
+
+    // out of range
+    ASSERT_THROW(
+        decode(R"({"id": "a", "name": "b", "size": [1, 2], "count": 256, "stats": {"health": 1, "speed": 1}})")
+      , json::error::bad_value
+    );
+    ASSERT_THROW(
+        decode(R"({"id": "a", "name": "b", "size": [1, 2], "stats": {"health": 1, "speed": -1}})")
+      , json::error::bad_value
+    );
+
+    // wrong size
+    ASSERT_THROW(
+        decode(R"({"id": "a", "name": "b", "size": [1], "stats": {"health": 1, "speed": 1}})")
+      , json::error::bad_size
+    );
+}
+//==============================================================================
+TEST(JsonSchema, Integers) {
+    auto const doc = json::parse("[18446744073709551615, -9223372036854775808, 1.5]");
+    auto const root = doc.root();
+
+    ASSERT_EQ(18446744073709551615ull, json::decode<bklib::uint64_t>(root[0]));
+    ASSERT_EQ(std::numeric_limits<bklib::int64_t>::min(), json::decode<bklib::int64_t>(root[1]));
+    ASSERT_THROW(json::decode<bklib::int64_t>(root[0]), json::error::bad_value);
+    ASSERT_THROW(json::decode<bklib::uint64_t>(root[1]), json::error::bad_value);
+    ASSERT_THROW(json::decode<int>(root[2]), json::error::bad_type);
+    ASSERT_EQ(1.5, json::decode<double>(root[2]));
+}
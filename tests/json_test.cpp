@@ -2,21 +2,27 @@
 #include <gtest/gtest.h>
 #include "json.hpp"
 
+#include <numeric>
+#include <algorithm>
+
 namespace json = bklib::json;
 
 struct JsonTest : public  ::testing::Test {
     template <size_t N>
     void parse(char const (&data)[N]) {
-        auto const result = reader.parse(data, data + N, root);
-        ASSERT_TRUE(result);
+        ASSERT_NO_THROW(
+            doc = json::parse(bklib::string_ref{data, N - 1})
+        );
+
+        root = doc.root();
 
         ASSERT_NO_THROW(
             json::require_object(root)
         );
     }
 
-    Json::Reader reader;
-    Json::Value  root;
+    json::document doc;
+    json::cref     root;
 };
 
 #define ASSERT_THROW_AND(expr, type, then)\
@@ -107,8 +113,161 @@ TEST_F(JsonTest, RequireArrayFail) {
             ASSERT_NE(ptr_expected, nullptr);
             ASSERT_NE(ptr_actual, nullptr);
 
-            ASSERT_EQ(ptr_expected->type, Json::arrayValue);
-            ASSERT_EQ(ptr_actual->type, Json::stringValue);
+            ASSERT_EQ(ptr_expected->type, json::type::array);
+            ASSERT_EQ(ptr_actual->type, json::type::string);
+        }
+    );
+}
+//==============================================================================
+// Test strings; views into the source and decoded copies.
+//==============================================================================
+TEST_F(JsonTest, RequireString) {
+    char const data[] {R"({
+        "plain":   "test",
+        "escaped": "a\"b\u00e9",
+        "number":  1
+    })"};
+
+    parse(data);
+
+    ASSERT_EQ(json::require_string(json::require_key(root, "plain")), "test");
+    ASSERT_EQ(json::require_string(json::require_key(root, "escaped")), "a\"b\xC3\xA9");
+
+    auto const view = json::require_string_ref(json::require_key(root, "plain"));
+    ASSERT_EQ(view, "test");
+    ASSERT_GT(view.data(), data);
+    ASSERT_LT(view.data(), data + sizeof(data));
+
+    // escaped strings are decoded into the document.
+    ASSERT_EQ(json::require_string_ref(json::require_key(root, "escaped")), "a\"b\xC3\xA9");
+    ASSERT_THROW(
+        json::require_string(json::require_key(root, "number")), json::error::bad_type
+    );
+}
+//==============================================================================
+// Test integers.
+//==============================================================================
+TEST_F(JsonTest, RequireInt) {
+    char const data[] {R"({
+        "a": -12,
+        "b": 1.5,
+        "c": 99999999999,
+        "d": [1, 2, 3]
+    })"};
+
+    parse(data);
+
+    ASSERT_EQ(json::require_int(json::require_key(root, "a")), -12);
+
+    ASSERT_THROW(json::require_int(json::require_key(root, "b")), json::error::bad_type);
+    ASSERT_THROW(json::require_int(json::require_key(root, "c")), json::error::bad_value);
+
+    auto const d = json::require_key(root, "d");
+    ASSERT_EQ(json::require_int(json::require_key(d, size_t{2})), 3);
+    ASSERT_THROW(json::require_key(d, size_t{3}), json::error::bad_index);
+    ASSERT_TRUE(json::optional_key(d, size_t{3}).is_null());
+
+    ASSERT_NO_THROW(json::require_size(d, 3));
+    ASSERT_THROW(json::require_size(d, 4), json::error::bad_size);
+}
+//==============================================================================
+// Test that failing elements are skipped.
+//==============================================================================
+TEST_F(JsonTest, ForEachElementSkipOnFail) {
+    char const data[] {R"({
+        "test": [1, "two", 3, {"four": 4}, 5]
+    })"};
+
+    parse(data);
+
+    std::vector<int> values;
+
+    json::for_each_element_skip_on_fail(json::require_key(root, "test"), [&](json::cref element) {
+        values.push_back(json::require_int(element));
+    });
+
+    ASSERT_EQ(values, (std::vector<int>{1, 3, 5}));
+}
+//==============================================================================
+// Test that results are combined in element order and failures skipped.
+//==============================================================================
+TEST_F(JsonTest, ParallelForEachElement) {
+    std::string source = "[";
+    for (int i = 0; i < 10000; ++i) {
+        if (i) source += ",";
+        source += (i % 1000 == 7) ? "\"bad\"" : std::to_string(i);
+    }
+    source += "]";
+
+    auto const array = json::parse(source);
+
+    using values_t = std::vector<int>;
+
+    auto const values = json::parallel_for_each_element(array.root(), values_t {}
+      , [](json::cref element) {
+            return values_t {json::require_int(element)};
+        }
+      , [](values_t a, values_t const& b) {
+            a.insert(end(a), begin(b), end(b));
+            return a;
+        }
+      , 4
+    );
+
+    ASSERT_EQ(10000u - 10u, values.size());
+    ASSERT_TRUE(std::is_sorted(begin(values), end(values)));
+    ASSERT_EQ(values.end(), std::find(begin(values), end(values), 1007));
+
+    auto const sum = json::parallel_for_each_element(array.root(), int64_t {0}
+      , [](json::cref element) { return int64_t {json::require_int(element)}; }
+      , [](int64_t a, int64_t b) { return a + b; }
+    );
+
+    ASSERT_EQ(std::accumulate(begin(values), end(values), int64_t {0}), sum);
+
+    // other exceptions propagate.
+    auto const fatal = [&] {
+        json::parallel_for_each_element(array.root(), 0
+          , [](json::cref element) -> int {
+                if (json::require_int(element) == 5000) throw std::runtime_error {"fatal"};
+                return 0;
+            }
+          , [](int a, int b) { return a + b; }
+          , 4
+        );
+    };
+
+    ASSERT_THROW(fatal(), std::runtime_error);
+
+    // as do json errors of reduce: they are not those of an element.
+    auto const bad_reduce = [&] {
+        json::parallel_for_each_element(array.root(), 0
+          , [](json::cref element) { return json::require_int(element) == 5000 ? -1 : 0; }
+          , [](int a, int b) -> int {
+                if (b == -1) throw json::error::make_bad_type(json::type::array, json::type::null);
+                return a + b;
+            }
+          , 4
+        );
+    };
+
+    ASSERT_THROW(bad_reduce(), json::error::bad_type);
+}
+//==============================================================================
+// Test malformed documents.
+//==============================================================================
+TEST_F(JsonTest, ParseFail) {
+    ASSERT_THROW(json::parse("{\"test\": }"), json::error::parse_error);
+    ASSERT_THROW(json::parse("[1, 2"), json::error::parse_error);
+    ASSERT_THROW(json::parse("{} {}"), json::error::parse_error);
+    ASSERT_THROW(json::parse("\"\xC0\xAF\""), json::error::parse_error);
+
+    ASSERT_THROW_AND(
+        json::parse("[1, 2 3]")
+      , json::error::parse_error, {
+            auto const ptr = boost::get_error_info<json::error::info_offset>(e);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_EQ(*ptr, 6u);
         }
     );
 }
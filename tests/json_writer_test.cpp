@@ -0,0 +1,239 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "json.hpp"
+#include "json_writer.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace json = bklib::json;
+
+namespace {
+//==============================================================================
+std::string format(double const value) {
+    char buffer[json::MAX_NUMBER_SIZE];
+    return std::string(buffer, json::format_double(value, buffer));
+}
+
+std::string format(float const value) {
+    char buffer[json::MAX_NUMBER_SIZE];
+    return std::string(buffer, json::format_float(value, buffer));
+}
+
+std::string write(json::cref value, json::writer::style const style) {
+    json::output_buffer out;
+    json::writer {out, style}.value(value);
+    return out.to_string();
+}
+
+//! Structural equality of two parsed values; numbers by their text.
+void expect_equal(json::cref a, json::cref b) {
+    ASSERT_EQ(a.type(), b.type());
+    ASSERT_EQ(a.size(), b.size());
+
+    if (a.is_object()) {
+        for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+            ASSERT_EQ(i.key(), j.key());
+            expect_equal(*i, *j);
+        }
+    } else if (a.is_array()) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            expect_equal(a[i], b[i]);
+        }
+    } else {
+        ASSERT_EQ(a.raw(), b.raw());
+    }
+}
+} //namespace
+
+//==============================================================================
+TEST(JsonWriter, FormatDouble) {
+    ASSERT_EQ("0.0",   format(0.0));
+    ASSERT_EQ("-0.0",  format(-0.0));
+    ASSERT_EQ("1.0",   format(1.0));
+    ASSERT_EQ("-1.5",  format(-1.5));
+    ASSERT_EQ("0.1",   format(0.1));
+    ASSERT_EQ("100.0", format(100.0));
+    ASSERT_EQ("123456.789", format(123456.789));
+    ASSERT_EQ("0.000001",   format(1e-6));
+    ASSERT_EQ("1e-7",       format(1e-7));
+    ASSERT_EQ("1e21",       format(1e21));
+    ASSERT_EQ("1.5e300",    format(1.5e300));
+    ASSERT_EQ("5e-324",     format(std::numeric_limits<double>::denorm_min()));
+    ASSERT_EQ("1.7976931348623157e308", format(std::numeric_limits<double>::max()));
+
+    ASSERT_EQ("0.1",   format(0.1f));
+    ASSERT_EQ("3.1415927", format(3.14159265f));
+    ASSERT_EQ("1e-45", format(std::numeric_limits<float>::denorm_min()));
+    ASSERT_EQ("3.4028235e38", format(std::numeric_limits<float>::max()));
+}
+//==============================================================================
+TEST(JsonWriter, FormatRoundTrip) {
+    std::mt19937_64 random {0x5eed};
+
+    for (int i = 0; i < 100000; ++i) {
+        auto const bits = random();
+
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+
+        if (std::isfinite(d)) {
+            auto const str = format(d);
+            ASSERT_EQ(d, std::strtod(str.c_str(), nullptr)) << str;
+        }
+
+        auto const bits32 = static_cast<bklib::uint32_t>(bits);
+
+        float f;
+        std::memcpy(&f, &bits32, sizeof(f));
+
+        if (std::isfinite(f)) {
+            auto const str = format(f);
+            ASSERT_EQ(f, std::strtof(str.c_str(), nullptr)) << str;
+        }
+    }
+}
+//==============================================================================
+TEST(JsonWriter, FormatInt) {
+    char buffer[json::MAX_NUMBER_SIZE];
+
+    auto const check = [&](bklib::int64_t const value) {
+        ASSERT_EQ(std::to_string(value), std::string(buffer, json::format_int(value, buffer)));
+    };
+
+    for (bklib::int64_t i = -1000; i <= 1000; ++i) {
+        check(i);
+    }
+
+    check(std::numeric_limits<bklib::int64_t>::min());
+    check(std::numeric_limits<bklib::int64_t>::max());
+
+    ASSERT_EQ("18446744073709551615", std::string(buffer,
+        json::format_uint(std::numeric_limits<bklib::uint64_t>::max(), buffer)));
+}
+//==============================================================================
+TEST(JsonWriter, Compact) {
+    json::output_buffer out;
+    json::writer w {out};
+
+    w.begin_object()
+        .key("a").begin_array().value(1).value(-2).value(2.5).value(true).value(nullptr).end_array()
+        .key("b").begin_object().end_object()
+        .key("c").value("x\"\\\n\x01y")
+        .key("d").value(std::numeric_limits<bklib::uint64_t>::max())
+     .end_object();
+
+    ASSERT_TRUE(w.is_complete());
+    ASSERT_EQ(
+        R"({"a":[1,-2,2.5,true,null],"b":{},"c":"x\"\\\n\u0001y","d":18446744073709551615})"
+      , out.to_string()
+    );
+}
+//==============================================================================
+TEST(JsonWriter, Pretty) {
+    json::output_buffer out;
+    json::writer w {out, json::writer::style::pretty};
+
+    w.begin_object()
+        .key("a").begin_array().value(1).value(2).end_array()
+        .key("b").begin_array().end_array()
+        .key("c").begin_object().key("d").value(false).end_object()
+     .end_object();
+
+    ASSERT_EQ(
+        "{\n"
+        "    \"a\": [\n"
+        "        1,\n"
+        "        2\n"
+        "    ],\n"
+        "    \"b\": [],\n"
+        "    \"c\": {\n"
+        "        \"d\": false\n"
+        "    }\n"
+        "}"
+      , out.to_string()
+    );
+}
+//==============================================================================
+TEST(JsonWriter, NonFinite) {
+    json::output_buffer out;
+    json::writer w {out};
+
+    ASSERT_THROW(w.value(std::numeric_limits<double>::quiet_NaN()), json::error::bad_value);
+    ASSERT_THROW(w.value(std::numeric_limits<float>::infinity()),   json::error::bad_value);
+}
+//==============================================================================
+TEST(JsonWriter, RoundTrip) {
+    auto const source = R"({
+        "name": "tab\there é 😀",
+        "values": [0, -1, 18446744073709551615, 1.5e-300, 2.0, [], {}, [[null]]],
+        "nested": {"z": true, "a": {"b": "\u0000"}}
+    })";
+
+    auto const doc = json::parse(source);
+
+    for (auto const style : {json::writer::style::compact, json::writer::style::pretty}) {
+        auto const text = write(doc.root(), style);
+        auto const copy = json::parse(text);
+
+        expect_equal(doc.root(), copy.root());
+
+        // and written again, identically.
+        ASSERT_EQ(text, write(copy.root(), style));
+    }
+
+    // doubles written by the writer read back exactly.
+    std::mt19937_64 random {42};
+    std::uniform_real_distribution<double> dist {-1e10, 1e10};
+
+    json::output_buffer out;
+    json::writer w {out};
+
+    std::vector<double> values;
+    w.begin_array();
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(dist(random));
+        w.value(values.back());
+    }
+    w.end_array();
+
+    auto const text  = out.to_string();
+    auto const array = json::parse(text);
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(json::type::real, array.root()[i].type());
+        ASSERT_EQ(values[i], array.root()[i].as_double());
+    }
+}
+//==============================================================================
+TEST(JsonWriter, Chunks) {
+    json::output_buffer out;
+
+    std::string const long_string(json::output_buffer::CHUNK_SIZE * 2 + 17, 'x');
+
+    for (int pass = 0; pass < 2; ++pass) {
+        out.clear();
+
+        json::writer w {out};
+        w.begin_array();
+        for (int i = 0; i < 50000; ++i) {
+            w.value(i);
+        }
+        w.value(long_string);
+        w.end_array();
+
+        auto const text = out.to_string();
+        ASSERT_EQ(text.size(), out.size());
+
+        size_t chunks = 0;
+        out.for_each_chunk([&](bklib::string_ref) { ++chunks; });
+        ASSERT_GT(chunks, 1u);
+
+        auto const doc = json::parse(text);
+        ASSERT_EQ(50001u, doc.root().size());
+        ASSERT_EQ(49999, json::require_int(doc.root()[49999]));
+        ASSERT_EQ(long_string, doc.root()[50000].as_string());
+    }
+}
@@ -37,26 +37,25 @@ TEST(Keyboard, KeyCode) {
 TEST(Keyboard, SetState) {
     keyboard kb;
 
-    ASSERT_FALSE(kb.set_state(keycode::SPACE, true));
-    ASSERT_TRUE(kb.set_state(keycode::SPACE, true));
-
+    ASSERT_FALSE(kb.set_down(keycode::SPACE));
+    ASSERT_TRUE(kb.set_down(keycode::SPACE));
 
     ASSERT_TRUE(!!kb[keycode::SPACE]);
+    ASSERT_TRUE(kb.state().includes(keycode::SPACE));
+
+    ASSERT_FALSE(kb.set_up(keycode::SPACE));
+    ASSERT_TRUE(kb.set_up(keycode::SPACE));
 
-    ASSERT_FALSE(kb.set_state(keycode::SPACE, false));
-    ASSERT_TRUE(kb.set_state(keycode::SPACE, false));
+    ASSERT_FALSE(kb.state().includes(keycode::SPACE));
 }
 //==============================================================================
 TEST(Keyboard, Clear) {
     keyboard kb;
 
-    kb.set_state(keycode::SPACE, true);
-
-    auto const on_key_up = [](keyboard& k, keycode key) {
-        ASSERT_EQ(key, keycode::SPACE);
-    };
+    kb.set_down(keycode::SPACE);
 
-    kb.clear(on_key_up);
+    kb.clear();
     ASSERT_FALSE(!!kb[keycode::SPACE]);
+    ASSERT_TRUE(kb.state().empty());
 }
 //==============================================================================
@@ -1,5 +1,7 @@
 #include "pch.hpp"
 #include <gtest/gtest.h>
 
-#pragma comment(lib, "gtestd.lib")
-#pragma comment(lib, "gtest_maind.lib")
+#if BOOST_COMP_MSVC
+#   pragma comment(lib, "gtestd.lib")
+#   pragma comment(lib, "gtest_maind.lib")
+#endif
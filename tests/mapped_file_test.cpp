@@ -0,0 +1,140 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "mapped_file.hpp"
+#include "json.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#if BOOST_OS_WINDOWS
+#   include <process.h>
+#   define BK_GETPID ::_getpid
+#else
+#   include <unistd.h>
+#   define BK_GETPID ::getpid
+#endif
+
+using bklib::mapped_file;
+using bklib::access_hint;
+
+namespace json = bklib::json;
+
+namespace {
+//==============================================================================
+//! A path in the temporary directory unique to the running test and process:
+//! ctest runs each test as a process of its own, possibly in parallel.
+std::string unique_temp_path() {
+    char const* dir = std::getenv("TMPDIR");
+    if (!dir) { dir = std::getenv("TEMP"); }
+    if (!dir) { dir = BOOST_OS_WINDOWS ? "." : "/tmp"; }
+
+    auto const info = ::testing::UnitTest::GetInstance()->current_test_info();
+
+    return std::string {dir} + "/bklib_" + info->test_suite_name() + "_" + info->name()
+         + "_" + std::to_string(BK_GETPID()) + ".tmp";
+}
+
+//==============================================================================
+//! A file with the given contents, removed again on destruction.
+struct temp_file {
+    explicit temp_file(std::string const& contents)
+      : path {unique_temp_path()}
+    {
+        std::ofstream out {path, std::ios::binary | std::ios::trunc};
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    ~temp_file() { std::remove(path.c_str()); }
+
+    std::string path;
+};
+} //namespace
+
+TEST(MappedFile, Contents) {
+    std::string const contents = R"({"name": "tiles", "size": [16, 16]})";
+    temp_file const tmp {contents};
+
+    mapped_file const file {tmp.path};
+
+    ASSERT_FALSE(file.empty());
+    ASSERT_EQ(contents.size(), file.size());
+    ASSERT_EQ(contents, file.str().to_string());
+
+    file.all().advise(access_hint::sequential);
+
+    auto const doc = json::parse(file.str());
+    auto const root = doc.root();
+    ASSERT_EQ("tiles", json::require_string(json::require_key(root, "name")));
+    ASSERT_EQ(16, json::require_int(json::require_key(json::require_key(root, "size"), 1u)));
+}
+
+TEST(MappedFile, Views) {
+    std::string contents;
+    for (int i = 0; contents.size() < 3 * mapped_file::page_size(); ++i) {
+        contents += std::to_string(i) + "\n";
+    }
+
+    temp_file const tmp {contents};
+    mapped_file const file {tmp.path};
+
+    auto const page = mapped_file::page_size();
+    ASSERT_EQ(0u, page & (page - 1));
+
+    auto const v = file.sub(page + 10, 100);
+    ASSERT_EQ(100u, v.size());
+    ASSERT_EQ(contents.substr(page + 10, 100), v.str().to_string());
+
+    // clamped to the view.
+    ASSERT_EQ(5u, v.sub(95).size());
+    ASSERT_TRUE(v.sub(500).empty());
+    ASSERT_EQ(contents.size() - 10, file.sub(10).size());
+
+    auto const aligned = v.page_aligned(file);
+    ASSERT_LE(aligned.data(), v.data());
+    ASSERT_GE(aligned.data() + aligned.size(), v.data() + v.size());
+    ASSERT_EQ(page, aligned.size());
+
+    // the last page is clamped to the end of the file.
+    auto const tail = file.sub(contents.size() - 1).page_aligned(file);
+    ASSERT_EQ(file.data() + file.size(), tail.data() + tail.size());
+
+    for (auto const hint : {access_hint::normal, access_hint::random
+                          , access_hint::will_need, access_hint::dont_need}) {
+        v.advise(hint);
+    }
+
+    ASSERT_EQ(contents, file.str().to_string());
+}
+
+TEST(MappedFile, Empty) {
+    temp_file const tmp {""};
+    mapped_file const file {tmp.path};
+
+    ASSERT_TRUE(file.empty());
+    ASSERT_TRUE(file.str().empty());
+    ASSERT_TRUE(file.sub(10).empty());
+
+    file.all().advise(access_hint::will_need);
+}
+
+TEST(MappedFile, Missing) {
+    ASSERT_THROW(mapped_file {"bklib_no_such_file.tmp"}, bklib::platform_error);
+}
+
+TEST(MappedFile, Move) {
+    temp_file const tmp {"contents"};
+
+    mapped_file a {tmp.path};
+    auto const data = a.data();
+
+    mapped_file b {std::move(a)};
+    ASSERT_TRUE(a.empty());
+    ASSERT_EQ(nullptr, a.data());
+    ASSERT_EQ(data, b.data());
+
+    a = std::move(b);
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ("contents", a.str().to_string());
+}
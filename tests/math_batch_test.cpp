@@ -0,0 +1,230 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "math_batch.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using bklib::point2d;
+using bklib::vector2d;
+using bklib::simd_level;
+using bklib::transform2d;
+
+namespace {
+//! Every level this build and processor support; the scalar one always.
+std::vector<simd_level> supported_levels() {
+    std::vector<simd_level> result;
+
+    for (int i = 0; i <= static_cast<int>(bklib::detected_simd_level()); ++i) {
+        auto const level = static_cast<simd_level>(i);
+        if (bklib::set_simd_level(level) == level) {
+            result.push_back(level);
+        }
+    }
+
+    bklib::set_simd_level(bklib::detected_simd_level());
+    return result;
+}
+
+//! Random vectors, with some zero and some tiny (within is_equal of zero).
+std::vector<vector2d<float>> random_vectors(size_t const n) {
+    std::mt19937 rng {static_cast<unsigned>(n)};
+    std::uniform_real_distribution<float> value {-1000.0f, 1000.0f};
+
+    std::vector<vector2d<float>> result;
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 7) {
+        case 3  : result.push_back({0.0f, 0.0f}); break;
+        case 5  : result.push_back({1.0e-45f, 0.0f}); break;
+        default : result.push_back({value(rng), value(rng)}); break;
+        }
+    }
+
+    return result;
+}
+
+//! Sizes around every vector width, for the tails.
+std::vector<size_t> const& sizes() {
+    static std::vector<size_t> const result = [] {
+        std::vector<size_t> r;
+        for (size_t n = 0; n <= 70; ++n) {
+            r.push_back(n);
+        }
+        r.push_back(1000);
+        return r;
+    }();
+
+    return result;
+}
+
+transform2d const TRANSFORM = [] {
+    transform2d m;
+    m.a  =  0.8660254f; m.b = 0.5f;
+    m.c  = -0.5f;       m.d = 0.8660254f;
+    m.tx =  12.5f;      m.ty = -3.25f;
+    return m;
+}();
+
+struct level_guard {
+    explicit level_guard(simd_level const level) {
+        EXPECT_EQ(level, bklib::set_simd_level(level));
+    }
+
+    ~level_guard() {
+        bklib::set_simd_level(bklib::detected_simd_level());
+    }
+};
+} //namespace
+
+TEST(MathBatch, Levels) {
+    auto const levels = supported_levels();
+
+    ASSERT_FALSE(levels.empty());
+    ASSERT_EQ(simd_level::scalar, levels.front());
+    ASSERT_EQ(bklib::detected_simd_level(), levels.back());
+    ASSERT_EQ(bklib::detected_simd_level(), bklib::current_simd_level());
+}
+
+TEST(MathBatch, MakeTransform) {
+    // column major, as glm::mat3: translate by (5, 7) then scale by 2.
+    float const m[3][3] = {
+        {2.0f, 0.0f, 0.0f}
+      , {0.0f, 2.0f, 0.0f}
+      , {5.0f, 7.0f, 1.0f}
+    };
+
+    auto const t = bklib::make_transform2d(m);
+    auto const p = bklib::transform(t, point2d<float> {1.0f, 2.0f});
+
+    ASSERT_FLOAT_EQ(7.0f,  p.x);
+    ASSERT_FLOAT_EQ(11.0f, p.y);
+}
+
+TEST(MathBatch, TransformPoints) {
+    for (auto const level : supported_levels()) {
+        level_guard const guard {level};
+
+        for (auto const n : sizes()) {
+            auto const vs = random_vectors(n);
+
+            std::vector<point2d<float>> in;
+            std::vector<float> x, y;
+            for (auto const v : vs) {
+                in.push_back({v.x, v.y});
+                x.push_back(v.x);
+                y.push_back(v.y);
+            }
+
+            std::vector<point2d<float>> out(n);
+            bklib::transform_points(in.data(), n, TRANSFORM, out.data());
+
+            std::vector<float> out_x(n), out_y(n);
+            bklib::transform_points(x.data(), y.data(), n, TRANSFORM, out_x.data(), out_y.data());
+
+            for (size_t i = 0; i < n; ++i) {
+                auto const expected = bklib::transform(TRANSFORM, in[i]);
+                ASSERT_TRUE(bklib::is_equal(expected.x, out[i].x)) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.y, out[i].y)) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.x, out_x[i])) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.y, out_y[i])) << static_cast<int>(level) << " " << n << " " << i;
+            }
+
+            // in place.
+            bklib::transform_points(in.data(), n, TRANSFORM, in.data());
+            ASSERT_TRUE(in == out);
+        }
+    }
+}
+
+TEST(MathBatch, Magnitudes) {
+    for (auto const level : supported_levels()) {
+        level_guard const guard {level};
+
+        for (auto const n : sizes()) {
+            auto const vs = random_vectors(n);
+
+            std::vector<float> x, y;
+            for (auto const v : vs) {
+                x.push_back(v.x);
+                y.push_back(v.y);
+            }
+
+            std::vector<float> aos(n), soa(n);
+            bklib::magnitudes(vs.data(), n, aos.data());
+            bklib::magnitudes(x.data(), y.data(), n, soa.data());
+
+            for (size_t i = 0; i < n; ++i) {
+                auto const expected = bklib::magnitude<float>(vs[i]);
+                ASSERT_TRUE(bklib::is_equal(expected, aos[i])) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected, soa[i])) << static_cast<int>(level) << " " << n << " " << i;
+            }
+        }
+    }
+}
+
+TEST(MathBatch, Directions) {
+    for (auto const level : supported_levels()) {
+        level_guard const guard {level};
+
+        for (auto const n : sizes()) {
+            auto vs = random_vectors(n);
+
+            std::vector<float> x, y;
+            for (auto const v : vs) {
+                x.push_back(v.x);
+                y.push_back(v.y);
+            }
+
+            std::vector<vector2d<float>> aos(n);
+            bklib::directions(vs.data(), n, aos.data());
+
+            bklib::directions(x.data(), y.data(), n, x.data(), y.data());
+
+            for (size_t i = 0; i < n; ++i) {
+                auto const expected = bklib::direction<float>(vs[i]);
+                ASSERT_TRUE(bklib::is_equal(expected.x, aos[i].x)) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.y, aos[i].y)) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.x, x[i])) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.y, y[i])) << static_cast<int>(level) << " " << n << " " << i;
+            }
+        }
+    }
+}
+
+TEST(MathBatch, SeparationVectors) {
+    for (auto const level : supported_levels()) {
+        level_guard const guard {level};
+
+        for (auto const n : sizes()) {
+            // the centers of b are those of a moved by random vectors, some
+            // zero (concentric circles).
+            auto const offsets = random_vectors(n);
+            auto const centers = random_vectors(n + 1);
+
+            std::vector<float> ax, ay, ar, bx, by, br;
+            for (size_t i = 0; i < n; ++i) {
+                ax.push_back(centers[i].x);
+                ay.push_back(centers[i].y);
+                ar.push_back(std::abs(centers[i + 1].x));
+                bx.push_back(centers[i].x + offsets[i].x * 0.01f);
+                by.push_back(centers[i].y + offsets[i].y * 0.01f);
+                br.push_back(std::abs(centers[i + 1].y));
+            }
+
+            std::vector<float> x(n), y(n);
+            bklib::separation_vectors(
+                ax.data(), ay.data(), ar.data(), bx.data(), by.data(), br.data(), n, x.data(), y.data()
+            );
+
+            for (size_t i = 0; i < n; ++i) {
+                auto const expected = bklib::separation_vector(
+                    bklib::circle<float> {{ax[i], ay[i]}, ar[i]}
+                  , bklib::circle<float> {{bx[i], by[i]}, br[i]}
+                );
+                ASSERT_TRUE(bklib::is_equal(expected.x, x[i])) << static_cast<int>(level) << " " << n << " " << i;
+                ASSERT_TRUE(bklib::is_equal(expected.y, y[i])) << static_cast<int>(level) << " " << n << " " << i;
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "math_codec.hpp"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace binary = bklib::binary;
+
+using point  = bklib::point2d<int>;
+using circle = bklib::circle<float>;
+using rect   = bklib::axis_aligned_rect<int>;
+
+//==============================================================================
+TEST(MathCodec, Scalars) {
+    std::vector<char> buffer;
+    binary::writer out {buffer};
+
+    out.write(bklib::uint32_t {0x01020304});
+    out.write(-1.5);
+    out.write_varint(300);
+    out.write_svarint(-3);
+    out.write_varint(std::numeric_limits<bklib::uint64_t>::max());
+
+    // little-endian whatever the host.
+    ASSERT_EQ(4, buffer[0]);
+    ASSERT_EQ(1, buffer[3]);
+    // 300 = 0b10'0101100
+    ASSERT_EQ(static_cast<char>(0xAC), buffer[12]);
+    ASSERT_EQ(0x02, buffer[13]);
+    // zigzag(-3) = 5
+    ASSERT_EQ(0x05, buffer[14]);
+    ASSERT_EQ(15u + binary::MAX_VARINT_SIZE, buffer.size());
+
+    binary::reader in {bklib::string_ref {buffer.data(), buffer.size()}};
+
+    ASSERT_EQ(0x01020304u, in.read<bklib::uint32_t>());
+    ASSERT_EQ(-1.5, in.read<double>());
+    ASSERT_EQ(300u, in.read_varint());
+    ASSERT_EQ(-3, in.read_svarint());
+    ASSERT_EQ(std::numeric_limits<bklib::uint64_t>::max(), in.read_varint());
+    ASSERT_EQ(0u, in.remaining());
+
+    ASSERT_THROW(in.read<char>(), binary::error::bad_input);
+
+    std::vector<char> const too_long(11, static_cast<char>(0x80));
+    binary::reader bad {bklib::string_ref {too_long.data(), too_long.size()}};
+    ASSERT_THROW(bad.read_varint(), binary::error::bad_input);
+}
+//==============================================================================
+TEST(MathCodec, Values) {
+    std::vector<char> buffer;
+    binary::writer out {buffer};
+
+    binary::encode(out, point {1, -2});
+    binary::encode(out, bklib::vector2d<short> {3, 4});
+    binary::encode(out, circle {{0.5f, 1.5f}, 2.0f});
+    binary::encode(out, rect {1, 2, 3, 4});
+
+    ASSERT_EQ(8u + 4u + 12u + 16u, buffer.size());
+
+    binary::reader in {bklib::string_ref {buffer.data(), buffer.size()}};
+
+    auto const p = binary::decode<point>(in);
+    ASSERT_EQ(1, p.x);
+    ASSERT_EQ(-2, p.y);
+
+    auto const v = binary::decode<bklib::vector2d<short>>(in);
+    ASSERT_EQ(4, v.y);
+
+    auto const c = binary::decode<circle>(in);
+    ASSERT_EQ(1.5f, c.p.y);
+    ASSERT_EQ(2.0f, c.r);
+
+    rect r;
+    binary::decode(in, r);
+    ASSERT_EQ(1, r.left());
+    ASSERT_EQ(2, r.top());
+    ASSERT_EQ(3, r.right());
+    ASSERT_EQ(4, r.bottom());
+}
+//==============================================================================
+TEST(MathCodec, Spans) {
+    std::vector<rect> rects;
+    for (int i = 0; i < 1000; ++i) {
+        rects.emplace_back(i, -i, i + 10, -i + 5);
+    }
+
+    std::vector<char> bulk;
+    std::vector<char> single;
+
+    binary::writer bulk_out {bulk};
+    binary::writer single_out {single};
+
+    binary::encode_span(bulk_out, rects.data(), rects.size());
+    for (auto const& r : rects) {
+        binary::encode(single_out, r);
+    }
+
+    // the memcpy path gives the same bytes.
+    ASSERT_EQ(single, bulk);
+
+    std::vector<rect> result(rects.size());
+    binary::reader in {bklib::string_ref {bulk.data(), bulk.size()}};
+    binary::decode_span(in, result.data(), result.size());
+
+    ASSERT_EQ(0u, in.remaining());
+    for (size_t i = 0; i < rects.size(); ++i) {
+        ASSERT_EQ(rects[i].left(),   result[i].left());
+        ASSERT_EQ(rects[i].bottom(), result[i].bottom());
+    }
+
+    ASSERT_EQ(binary::HOST_IS_LITTLE_ENDIAN, binary::is_raw_layout<rect>::value);
+    ASSERT_EQ(binary::HOST_IS_LITTLE_ENDIAN, binary::is_raw_layout<circle>::value);
+}
+//==============================================================================
+TEST(MathCodec, Delta) {
+    std::mt19937 random {7};
+    std::uniform_int_distribution<int> step {-50, 50};
+
+    std::vector<point> points;
+    point p {1000000, -1000000};
+    for (int i = 0; i < 10000; ++i) {
+        p.x += step(random);
+        p.y += step(random);
+        points.push_back(p);
+    }
+
+    // and the extremes.
+    points.push_back(point {std::numeric_limits<int>::min(), std::numeric_limits<int>::max()});
+    points.push_back(point {std::numeric_limits<int>::max(), std::numeric_limits<int>::min()});
+
+    std::vector<char> buffer;
+    binary::writer out {buffer};
+    binary::encode_delta(out, points.data(), points.size());
+
+    // one byte per component for the small steps.
+    ASSERT_LT(buffer.size(), points.size() * 2 + 64);
+
+    std::vector<point> result(points.size());
+    binary::reader in {bklib::string_ref {buffer.data(), buffer.size()}};
+    binary::decode_delta(in, result.data(), result.size());
+
+    ASSERT_EQ(0u, in.remaining());
+    for (size_t i = 0; i < points.size(); ++i) {
+        ASSERT_EQ(points[i].x, result[i].x);
+        ASSERT_EQ(points[i].y, result[i].y);
+    }
+
+    std::vector<bklib::axis_aligned_rect<bklib::uint64_t>> big {
+        {0, 0, std::numeric_limits<bklib::uint64_t>::max(), 1}
+    };
+    std::vector<char> big_buffer;
+    binary::writer big_out {big_buffer};
+    binary::encode_delta(big_out, big.data(), big.size());
+
+    auto big_result = big;
+    binary::reader big_in {bklib::string_ref {big_buffer.data(), big_buffer.size()}};
+    binary::decode_delta(big_in, big_result.data(), big_result.size());
+    ASSERT_EQ(std::numeric_limits<bklib::uint64_t>::max(), big_result[0].right());
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "math.hpp"
 
+#include <random>
+
 #define BK_STATIC_ASSERT_TYPE_EQ(TYPE, VAR)
 //\
 //    static_assert(\
@@ -215,3 +217,116 @@ TEST(Math, AARectIntersectionsInvalid) {
     ASSERT_FALSE(intersects(r, r2));
     ASSERT_FALSE(intersects(r, r3));
 }
+
+//==============================================================================
+// The int16_t / int32_t paths agree with the generic (floating point) ones.
+//==============================================================================
+namespace {
+template <typename T>
+void check_integral_coordinates(T const lo, T const hi) {
+    using namespace bklib;
+
+    using rect = axis_aligned_rect<T>;
+    using circ = circle<T>;
+
+    std::mt19937 rng {42};
+    auto const value = [&](T const a, T const b) {
+        return static_cast<T>(std::uniform_int_distribution<int>{a, b}(rng));
+    };
+
+    auto const to_double = [](rect const r) {
+        using result = axis_aligned_rect<double>;
+        return result {result::allow_malformed{}
+          , static_cast<double>(r.left()),  static_cast<double>(r.top())
+          , static_cast<double>(r.right()), static_cast<double>(r.bottom())};
+    };
+    auto const to_double_circle = [](circ const c) {
+        return circle<double>{to_type<double>(c.p), static_cast<double>(c.r)};
+    };
+
+    auto const size = static_cast<T>((hi - lo) / 4);
+
+    for (int i = 0; i < 10000; ++i) {
+        auto const x = value(lo, static_cast<T>(hi - size));
+        auto const y = value(lo, static_cast<T>(hi - size));
+
+        rect const ra {x, y, static_cast<T>(x + value(1, size)), static_cast<T>(y + value(1, size))};
+        rect const rb {y, x, static_cast<T>(y + value(1, size)), static_cast<T>(x + value(1, size))};
+        circ const ca {{value(lo, hi), value(lo, hi)}, value(0, size / 2)};
+        circ const cb {{value(lo, hi), value(lo, hi)}, value(0, size / 2)};
+        point2d<T> const p {value(lo, hi), value(lo, hi)};
+
+        ASSERT_EQ(intersects(to_double(ra), to_double(rb)), intersects(ra, rb));
+        ASSERT_EQ(intersects(to_double_circle(ca), to_double_circle(cb)), intersects(ca, cb));
+        ASSERT_EQ(intersects(to_double_circle(ca), to_type<double>(p)), intersects(ca, p));
+        ASSERT_EQ(intersects(to_double(ra), to_double_circle(ca)), intersects(ra, ca));
+
+        auto const ir = intersection_of(ra, rb);
+        auto const id = intersection_of(to_double(ra), to_double(rb));
+        ASSERT_EQ(id.valid, ir.valid);
+        ASSERT_EQ(to_double(ir.result), id.result);
+
+        // the smallest integer radius that contains every corner.
+        auto const c  = bounding_circle<T>(ra);
+        auto const r2 = square_of(static_cast<double>(c.r));
+        auto const d2 = std::max({
+            distance2(to_type<double>(c.p), to_type<double>(ra.top_left()))
+          , distance2(to_type<double>(c.p), to_type<double>(ra.top_right()))
+          , distance2(to_type<double>(c.p), to_type<double>(ra.bottom_left()))
+          , distance2(to_type<double>(c.p), to_type<double>(ra.bottom_right()))
+        });
+
+        ASSERT_LE(d2, r2);
+        ASSERT_GT(d2, square_of(c.r - 1.0));
+    }
+}
+} //namespace
+
+TEST(Math, IntegralCoordinates) {
+    check_integral_coordinates<int16_t>(-16000, 16000);
+    check_integral_coordinates<int32_t>(-1000000, 1000000);
+}
+
+TEST(Math, IntegralCoordinatesNoOverflow) {
+    using namespace bklib;
+
+    using circ = circle<int32_t>;
+
+    int32_t const big = 1000000000;
+
+    circ const a {{-big, 0}, big};
+    circ const b {{ big, 0}, big};
+    circ const c {{ big - 1, 0}, big};
+
+    ASSERT_FALSE(intersects(a, b));
+    ASSERT_TRUE(intersects(a, c));
+    ASSERT_TRUE(intersects(a, point2d<int32_t>{-1, 0}));
+    ASSERT_FALSE(intersects(a, point2d<int32_t>{1, 0}));
+    ASSERT_FALSE(intersects(a, point2d<int32_t>{-big, big}));
+
+    auto const r = axis_aligned_rect<int32_t>{-big, -big, big, big};
+    auto const bc = bounding_circle<int32_t>(r);
+    ASSERT_EQ(0, bc.p.x);
+    ASSERT_EQ(0, bc.p.y);
+    ASSERT_EQ(1414213563, bc.r); // ceil(sqrt(2) * 1e9)
+
+    auto const far = axis_aligned_rect<int32_t>{big - 2, big - 2, big, big};
+    ASSERT_EQ(2 * square_of(int64_t {big - 1}), distance2(r, far));
+}
+
+TEST(Math, IsEqualUlps) {
+    using bklib::is_equal;
+
+    auto const one  = 1.0f;
+    auto const next = std::nextafter(one, 2.0f);
+
+    ASSERT_TRUE(is_equal(one, one));
+    ASSERT_TRUE(is_equal(one, next));
+    ASSERT_TRUE(is_equal(0.0f, -0.0f));
+    ASSERT_TRUE(is_equal(-one, -next));
+
+    ASSERT_FALSE(is_equal(one, 2.0f));
+    ASSERT_FALSE(is_equal(one, -one));
+    ASSERT_FALSE(is_equal(std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()));
+    ASSERT_FALSE(is_equal(std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()));
+}
@@ -0,0 +1,163 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "memory.hpp"
+
+#include <list>
+#include <cstdint>
+
+using bklib::frame_arena;
+using bklib::fixed_pool;
+
+namespace {
+bool is_aligned(void const* const p, size_t const align) {
+    return (reinterpret_cast<std::uintptr_t>(p) & (align - 1)) == 0;
+}
+} //namespace
+
+TEST(FrameArena, Allocate) {
+    frame_arena arena {1024};
+
+    auto const a = arena.allocate(3, 1);
+    auto const b = arena.allocate(8, 8);
+    auto const c = arena.allocate(1, 64);
+
+    ASSERT_TRUE(is_aligned(b, 8));
+    ASSERT_TRUE(is_aligned(c, 64));
+    ASSERT_LT(a, b);
+    ASSERT_LT(b, c);
+
+    // only the latest allocation can be given back.
+    auto const used = arena.used();
+    arena.deallocate(b, 8);
+    ASSERT_EQ(used, arena.used());
+    arena.deallocate(c, 1);
+    ASSERT_GT(used, arena.used());
+
+    auto const p = arena.make<std::pair<int, double>>(1, 2.0);
+    ASSERT_EQ(1, p->first);
+    ASSERT_EQ(2.0, p->second);
+
+    arena.reset();
+    ASSERT_EQ(0u, arena.used());
+    ASSERT_EQ(a, arena.allocate(3, 1));
+}
+
+TEST(FrameArena, SteadyState) {
+    frame_arena arena {256};
+
+    auto const frame = [&] {
+        for (int i = 0; i < 100; ++i) {
+            auto const p = arena.allocate_array<int>(10);
+            p[0] = p[9] = i;
+        }
+
+        // larger than a block.
+        arena.allocate(1000);
+        arena.reset();
+    };
+
+    frame();
+    auto const stats = arena.stats();
+    ASSERT_GT(stats.heap_allocations, 1u);
+    ASSERT_GE(stats.high_water, 100 * 10 * sizeof(int) + 1000);
+    ASSERT_GE(arena.capacity(), stats.high_water);
+
+    // subsequent frames fit the single, coalesced, block.
+    for (int i = 0; i < 10; ++i) {
+        frame();
+    }
+
+    ASSERT_EQ(stats.heap_allocations, arena.stats().heap_allocations);
+    ASSERT_EQ(stats.high_water, arena.stats().high_water);
+}
+
+TEST(FrameArena, Allocator) {
+    frame_arena arena {4096};
+
+    {
+        bklib::frame_vector<int> v {arena};
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+
+        ASSERT_EQ(999, v.back());
+
+        bklib::frame_string s {"a string long enough to not fit the small buffer", arena};
+        s += s;
+        ASSERT_EQ(96u, s.size());
+    }
+
+    arena.reset();
+    auto const allocations = arena.stats().heap_allocations;
+
+    {
+        bklib::frame_vector<int> v {arena};
+        v.reserve(1000);
+        ASSERT_EQ(allocations, arena.stats().heap_allocations);
+    }
+}
+
+TEST(Pool, Reuse) {
+    struct object {
+        object(int a, int b) : a {a}, b {b} {}
+        int a, b;
+        char pad[20];
+    };
+
+    bklib::pool<object> pool {4};
+
+    auto const a = pool.make(1, 2);
+    auto const b = pool.make(3, 4);
+
+    ASSERT_EQ(1, a->a);
+    ASSERT_EQ(4, b->b);
+    ASSERT_TRUE(is_aligned(a, alignof(object)));
+    ASSERT_TRUE(is_aligned(b, alignof(object)));
+
+    pool.destroy(a);
+    ASSERT_EQ(a, pool.make(5, 6));
+
+    std::vector<object*> objects;
+    for (int i = 0; i < 10; ++i) {
+        objects.push_back(pool.make(i, i));
+    }
+
+    auto const stats = pool.stats();
+    ASSERT_EQ(3u, stats.heap_allocations);
+
+    if (BK_MEMORY_STATS) {
+        ASSERT_EQ(12u, stats.in_use);
+        ASSERT_EQ(12u, stats.high_water);
+    }
+
+    for (auto const p : objects) {
+        pool.destroy(p);
+    }
+
+    if (BK_MEMORY_STATS) {
+        ASSERT_EQ(2u, pool.stats().in_use);
+        ASSERT_EQ(12u, pool.stats().high_water);
+    }
+}
+
+TEST(Pool, Allocator) {
+    fixed_pool pool {64, alignof(std::max_align_t)};
+
+    ASSERT_GE(pool.object_size(), 64u);
+
+    std::list<int, bklib::pool_allocator<int>> list {pool};
+    for (int i = 0; i < 100; ++i) {
+        list.push_back(i);
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        list.pop_front();
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        list.push_back(i);
+    }
+
+    ASSERT_EQ(100u, list.size());
+    ASSERT_EQ(2u, pool.stats().heap_allocations);
+}
@@ -0,0 +1,182 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "profiler.hpp"
+#include "json.hpp"
+#include "json_writer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace json     = bklib::json;
+namespace profiler = bklib::profiler;
+
+namespace {
+struct zone_info {
+    double begin;
+    double end;
+    size_t tid;
+};
+
+//! The complete ("X") events of the trace, by name.
+std::multimap<std::string, zone_info> read_zones(json::cref root) {
+    std::multimap<std::string, zone_info> result;
+
+    auto const events = json::require_array(json::require_key(root, "traceEvents"));
+
+    for (size_t i = 0; i < events.size(); ++i) {
+        auto const e = events[i];
+        if (json::require_string(json::require_key(e, "ph")) != "X") {
+            continue;
+        }
+
+        auto const ts = json::require_key(e, "ts").as_double();
+        auto const d  = json::require_key(e, "dur").as_double();
+
+        result.emplace(
+            json::require_string(json::require_key(e, "name"))
+          , zone_info {ts, ts + d, static_cast<size_t>(json::require_int(json::require_key(e, "tid")))}
+        );
+    }
+
+    return result;
+}
+} //namespace
+
+TEST(Profiler, Disabled) {
+    profiler::enable(false);
+    profiler::clear();
+
+    {
+        BK_PROFILE_ZONE("disabled");
+    }
+
+    json::output_buffer out;
+    profiler::write_chrome_trace(out);
+
+    auto const text = out.to_string();
+    auto const doc  = json::parse(text);
+
+    ASSERT_EQ(0u, read_zones(doc.root()).count("disabled"));
+}
+
+TEST(Profiler, ChromeTrace) {
+    profiler::clear();
+    profiler::enable();
+
+    auto const work = [] {
+        BK_PROFILE_ZONE("outer");
+        for (int i = 0; i < 3; ++i) {
+            BK_PROFILE_ZONE("inner");
+            std::this_thread::sleep_for(std::chrono::microseconds {100});
+        }
+    };
+
+    std::thread worker {[&] {
+        profiler::set_thread_name("worker");
+        work();
+    }};
+
+    work();
+    worker.join();
+
+    profiler::enable(false);
+
+    json::output_buffer out;
+    profiler::write_chrome_trace(out);
+
+    auto const text = out.to_string();
+    auto const doc  = json::parse(text);
+    auto const root = doc.root();
+
+    ASSERT_EQ("ms", json::require_string(json::require_key(root, "displayTimeUnit")));
+
+    auto const zones = read_zones(root);
+    ASSERT_EQ(2u, zones.count("outer"));
+    ASSERT_EQ(6u, zones.count("inner"));
+
+    // every inner zone nests inside the outer zone of its thread.
+    auto const outers = zones.equal_range("outer");
+    ASSERT_NE(outers.first->second.tid, std::next(outers.first)->second.tid);
+
+    auto const inners = zones.equal_range("inner");
+    for (auto i = inners.first; i != inners.second; ++i) {
+        auto const& inner = i->second;
+
+        auto const outer = std::find_if(outers.first, outers.second, [&](std::pair<std::string const, zone_info> const& o) {
+            return o.second.tid == inner.tid;
+        });
+
+        ASSERT_NE(outers.second, outer);
+        ASSERT_LE(outer->second.begin, inner.begin);
+        ASSERT_GE(outer->second.end, inner.end);
+        ASSERT_GE(inner.end - inner.begin, 100.0);
+    }
+
+    // the named thread is reported.
+    ASSERT_NE(std::string::npos, text.find("\"worker\""));
+}
+
+TEST(Profiler, Overflow) {
+    profiler::clear();
+    profiler::enable();
+
+    for (size_t i = 0; i < profiler::BUFFER_SIZE + 10; ++i) {
+        BK_PROFILE_ZONE("many");
+    }
+
+    profiler::enable(false);
+
+    json::output_buffer out;
+    profiler::write_chrome_trace(out);
+
+    auto const text = out.to_string();
+    auto const doc  = json::parse(text);
+
+    ASSERT_EQ(profiler::BUFFER_SIZE - 1, read_zones(doc.root()).count("many"));
+}
+
+TEST(Profiler, ExportWhileRecording) {
+    profiler::clear();
+
+    // zone k spans [k, k + 0.5) microseconds, so an event read while being
+    // overwritten (with the begin of one zone and the end of another) shows.
+    std::atomic<bool> started {false};
+    std::atomic<bool> stop    {false};
+    std::thread recorder {[&] {
+        for (uint64_t k = 0; !stop.load(std::memory_order_relaxed); ++k) {
+            profiler::detail::record("racing", 1000 * k, 1000 * k + 500);
+            started.store(true, std::memory_order_relaxed);
+        }
+    }};
+
+    while (!started.load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+    }
+
+    size_t seen = 0;
+    for (int i = 0; i < 20; ++i) {
+        json::output_buffer out;
+        profiler::write_chrome_trace(out);
+
+        auto const text  = out.to_string();
+        auto const doc   = json::parse(text);
+        auto const all   = read_zones(doc.root());
+        auto const zones = all.equal_range("racing");
+
+        for (auto z = zones.first; z != zones.second; ++z) {
+            ASSERT_LE(z->second.begin, z->second.end);
+            ASSERT_EQ(0.5, z->second.end - z->second.begin);
+            ++seen;
+        }
+    }
+
+    stop = true;
+    recorder.join();
+    profiler::clear();
+
+    ASSERT_LT(0u, seen);
+}
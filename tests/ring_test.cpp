@@ -0,0 +1,66 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "ring.hpp"
+
+using bklib::ring;
+
+TEST(Ring, Empty) {
+    ring<int, 4> r;
+
+    ASSERT_TRUE(r.empty());
+    ASSERT_EQ(0u, r.size());
+    ASSERT_EQ(4u, r.capacity());
+
+    // unpushed slots are value initialized.
+    for (size_t i = 0; i < r.capacity(); ++i) {
+        ASSERT_EQ(0, r[i]);
+    }
+}
+
+TEST(Ring, PushWrap) {
+    ring<int, 4> r;
+
+    r.push(1);
+    r.push(2);
+
+    ASSERT_EQ(2u, r.size());
+    ASSERT_EQ(2, r.front());
+    ASSERT_EQ(1, r[1]);
+    ASSERT_EQ(0, r[2]);
+
+    for (int i = 3; i <= 10; ++i) {
+        r.push(i);
+    }
+
+    ASSERT_TRUE(r.full());
+    ASSERT_EQ(4u, r.size());
+
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(10 - static_cast<int>(i), r[i]);
+    }
+
+    r.clear();
+    ASSERT_TRUE(r.empty());
+    ASSERT_EQ(0, r[0]);
+    ASSERT_EQ(0, r[3]);
+}
+
+TEST(Ring, Cursor) {
+    bklib::ring_cursor<8> c;
+
+    // parallel columns advance together.
+    std::array<int, 8> a {};
+    std::array<char, 8> b {};
+
+    for (int i = 0; i < 20; ++i) {
+        auto const s = c.push();
+        a[s] = i;
+        b[s] = static_cast<char>('a' + i);
+    }
+
+    ASSERT_EQ(8u, c.size());
+    ASSERT_EQ(19, a[c.slot(0)]);
+    ASSERT_EQ('a' + 19, b[c.slot(0)]);
+    ASSERT_EQ(12, a[c.slot(7)]);
+    ASSERT_EQ('a' + 12, b[c.slot(7)]);
+}
@@ -0,0 +1,79 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "slot_map.hpp"
+
+#include <memory>
+#include <string>
+#include <algorithm>
+
+using bklib::slot_map;
+using bklib::slot_handle;
+
+TEST(SlotMap, InsertErase) {
+    slot_map<std::string> map;
+
+    auto const a = map.insert("a");
+    auto const b = map.insert("b");
+    auto const c = map.emplace(3, 'c');
+
+    ASSERT_EQ(3u, map.size());
+    ASSERT_EQ("a",   map[a]);
+    ASSERT_EQ("b",   map[b]);
+    ASSERT_EQ("ccc", map[c]);
+
+    ASSERT_TRUE(map.erase(a));
+    ASSERT_FALSE(map.erase(a));
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_EQ(nullptr, map.get(a));
+
+    // the remaining values moved, their handles did not.
+    ASSERT_EQ(2u, map.size());
+    ASSERT_EQ("b",   *map.get(b));
+    ASSERT_EQ("ccc", *map.get(c));
+
+    // the slot is reused, but the stale handle stays stale.
+    auto const d = map.insert("d");
+    ASSERT_EQ(a.index, d.index);
+    ASSERT_NE(a, d);
+    ASSERT_FALSE(map.contains(a));
+    ASSERT_EQ("d", map[d]);
+
+    ASSERT_FALSE(map.contains(slot_handle {}));
+    ASSERT_FALSE(map.contains(slot_handle {100, 1}));
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_FALSE(map.contains(b));
+    ASSERT_FALSE(map.contains(d));
+}
+
+TEST(SlotMap, Iteration) {
+    slot_map<std::unique_ptr<int>> map;
+
+    std::vector<slot_handle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(map.emplace(new int {i}));
+    }
+
+    for (int i = 0; i < 100; i += 3) {
+        ASSERT_TRUE(map.erase(handles[i]));
+    }
+
+    ASSERT_EQ(66u, map.size());
+    ASSERT_EQ(66, std::distance(map.begin(), map.end()));
+
+    // every value is reachable from the dense array, and maps back to itself.
+    int sum = 0;
+    for (size_t i = 0; i < map.size(); ++i) {
+        auto const& p = map.data()[i];
+        ASSERT_NE(0, *p % 3);
+        ASSERT_EQ(p.get(), map[map.handle_at(i)].get());
+        sum += *p;
+    }
+
+    ASSERT_EQ(4950 - 1683, sum);
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i % 3 != 0, map.contains(handles[i]));
+    }
+}
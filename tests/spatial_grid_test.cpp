@@ -0,0 +1,55 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "spatial_grid.hpp"
+#include "spatial_index_test.hpp"
+
+#include <vector>
+
+using bklib::spatial_grid;
+using spatial_test::pairs;
+using spatial_test::sorted_pairs;
+using spatial_test::sorted_query;
+
+namespace {
+using grid  = spatial_grid<int>;
+using rect  = grid::rect;
+using point = grid::point;
+} //namespace
+
+TEST(SpatialGrid, Update) {
+    grid g {rect {0, 0, 128, 128}, 16};
+
+    auto const a = g.insert(rect {0, 0, 16, 16}, 1);   // one cell.
+    auto const b = g.insert(rect {8, 8, 40, 40}, 2);   // nine cells, overlapping a and c.
+    auto const c = g.insert(rect {32, 32, 48, 48}, 3);
+
+    ASSERT_EQ((pairs {{1, 2}, {2, 3}}), sorted_pairs(g));
+    ASSERT_EQ(16, g.cell_size());
+
+    // within the same cells, and then across.
+    ASSERT_FALSE(g.update(a, rect {1, 1, 15, 15}));
+    ASSERT_EQ((std::vector<int> {1}), sorted_query(g, point {1, 1}));
+    ASSERT_EQ((std::vector<int> {2}), sorted_query(g, point {15, 15}));
+    ASSERT_TRUE(sorted_query(g, point {0, 0}).empty());
+    ASSERT_TRUE(g.update(c, rect {80, 80, 96, 96}));
+    ASSERT_EQ((pairs {{1, 2}}), sorted_pairs(g));
+
+    // a move within the cells of a value that moved across them, before the
+    // lists are rebuilt.
+    ASSERT_TRUE(g.update(b, rect {64, 64, 72, 72}));
+    ASSERT_FALSE(g.update(b, rect {65, 65, 72, 72}));
+    ASSERT_EQ((std::vector<int> {2}), sorted_query(g, point {65, 65}));
+    ASSERT_TRUE(sorted_query(g, point {64, 64}).empty());
+}
+
+TEST(SpatialGrid, OutsideTheWorld) {
+    grid g {rect {0, 0, 64, 64}, 16};
+
+    g.insert(rect {-50, -50, -40, -40}, 1);
+    g.insert(rect {-45, -45, 1, 1}, 2);
+    g.insert(rect {100, 100, 120, 120}, 3);
+
+    ASSERT_EQ((pairs {{1, 2}}), sorted_pairs(g));
+    ASSERT_EQ((std::vector<int> {1, 2}), sorted_query(g, point {-42, -42}));
+    ASSERT_EQ((std::vector<int> {3}),    sorted_query(g, rect {110, 0, 200, 200}));
+}
@@ -0,0 +1,126 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "spatial_grid.hpp"
+#include "aabb_tree.hpp"
+#include "sweep_and_prune.hpp"
+#include "spatial_index_test.hpp"
+
+#include <vector>
+
+using spatial_test::pairs;
+using spatial_test::sorted_pairs;
+using spatial_test::sorted_query;
+
+namespace {
+//==============================================================================
+//! How to make each index, and the smallest rects it is tested with.
+//==============================================================================
+struct grid_traits {
+    using index = bklib::spatial_grid<int>;
+
+    static index make()     { return index {index::rect {0, 0, 512, 512}, 16}; }
+    static int   min_size() { return 1; }
+};
+
+struct tree_traits {
+    using index = bklib::aabb_tree<int>;
+
+    static index make()     { return index {2.0f}; }
+    static float min_size() { return 0.5f; }
+};
+
+struct sap_traits {
+    using index = bklib::sweep_and_prune<int, int>;
+
+    static index make()     { return index {}; }
+    static int   min_size() { return 0; } //!< Empty rects too.
+};
+
+template <typename Traits>
+class SpatialIndex : public ::testing::Test {
+protected:
+    using index = typename Traits::index;
+    using rect  = typename index::rect;
+    using point = typename index::point;
+};
+
+using spatial_indices = ::testing::Types<grid_traits, tree_traits, sap_traits>;
+} //namespace
+
+TYPED_TEST_SUITE(SpatialIndex, spatial_indices);
+
+TYPED_TEST(SpatialIndex, Basic) {
+    using rect  = typename TestFixture::rect;
+    using point = typename TestFixture::point;
+
+    auto index = TypeParam::make();
+
+    auto const a = index.insert(rect {0, 0, 10, 10}, 1);
+    auto const b = index.insert(rect {5, 5, 25, 25}, 2);
+    auto const c = index.insert(rect {20, 20, 30, 30}, 3);
+    auto const d = index.insert(rect {10, 0, 20, 10}, 4);  // touching a: half open, so not.
+
+    ASSERT_EQ(4u, index.size());
+    ASSERT_TRUE(index.contains(d));
+    ASSERT_EQ(2, index.value(b));
+    ASSERT_EQ((rect {20, 20, 30, 30}), index.bounds(c));
+
+    ASSERT_EQ((pairs {{1, 2}, {2, 3}, {2, 4}}), sorted_pairs(index));
+
+    ASSERT_EQ((std::vector<int> {1, 2}),    sorted_query(index, point {7, 7}));
+    ASSERT_EQ((std::vector<int> {4}),       sorted_query(index, point {10, 0}));
+    ASSERT_EQ((std::vector<int> {1, 2, 4}), sorted_query(index, rect {0, 0, 15, 15}));
+
+    index.update(d, rect {50, 50, 60, 60});
+    ASSERT_EQ((rect {50, 50, 60, 60}), index.bounds(d));
+    ASSERT_EQ((pairs {{1, 2}, {2, 3}}), sorted_pairs(index));
+
+    index.remove(b);
+    ASSERT_FALSE(index.contains(b));
+    ASSERT_EQ(3u, index.size());
+    ASSERT_TRUE(sorted_pairs(index).empty());
+    ASSERT_EQ((std::vector<int> {1, 3, 4}), sorted_query(index, rect {0, 0, 100, 100}));
+
+    // the slot is reused, but the old handle stays stale.
+    auto const e = index.insert(rect {55, 55, 56, 56}, 5);
+    ASSERT_EQ(b.index, e.index);
+    ASSERT_NE(b, e);
+    ASSERT_FALSE(index.contains(b));
+    ASSERT_EQ(5, index.value(e));
+    ASSERT_EQ((pairs {{4, 5}}), sorted_pairs(index));
+
+    index.clear();
+    ASSERT_TRUE(index.empty());
+    ASSERT_FALSE(index.contains(a));
+    ASSERT_FALSE(index.contains(e));
+    ASSERT_TRUE(sorted_query(index, rect {0, 0, 100, 100}).empty());
+}
+
+TYPED_TEST(SpatialIndex, MatchesBruteForce) {
+    auto index = TypeParam::make();
+    spatial_test::random_scene<typename TestFixture::index> scene {index, 7, TypeParam::min_size()};
+
+    for (int i = 0; i < 2000; ++i) {
+        scene.add();
+    }
+
+    for (int frame = 0; frame < 5; ++frame) {
+        scene.step();
+
+        // a few insertions each frame, and once many.
+        for (int i = (frame == 2) ? 1500 : 10; i > 0; --i) {
+            scene.add();
+        }
+
+        ASSERT_EQ(scene.expected_pairs(), sorted_pairs(index));
+
+        for (int q = 0; q < 50; ++q) {
+            auto const r = scene.random_rect();
+            auto const p = r.top_left();
+
+            using rect = typename TestFixture::rect;
+            ASSERT_EQ(scene.expected([&](rect const& b) { return intersects(b, r); }), sorted_query(index, r));
+            ASSERT_EQ(scene.expected([&](rect const& b) { return intersects(b, p); }), sorted_query(index, p));
+        }
+    }
+}
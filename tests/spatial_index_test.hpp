@@ -0,0 +1,156 @@
+//==============================================================================
+//! Helpers shared by the tests of the spatial indices.
+//!
+//! The indices are given values of type int; the helpers report values, not
+//! handles, sorted so that results compare independently of the order in
+//! which an index finds them.
+//==============================================================================
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "math.hpp"
+
+namespace spatial_test {
+
+using pairs = std::vector<std::pair<int, int>>;
+
+//! The pairs of values for_each_pair reports, each {lower, higher}, sorted.
+template <typename Index>
+pairs sorted_pairs(Index const& index) {
+    pairs result;
+    index.for_each_pair([&](int const a, int const b) {
+        result.emplace_back(std::min(a, b), std::max(a, b));
+    });
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//! The values a query reports, sorted.
+template <typename Index, typename Query>
+std::vector<int> sorted_query(Index const& index, Query const q) {
+    std::vector<int> result;
+    index.query(q, [&](int const v) { result.push_back(v); });
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//==============================================================================
+//! Random rects in and around [0, 500)^2, moved, replaced, removed and added
+//! frame by frame; the scene keeps the bounds of each (by value) to check the
+//! index against by brute force.
+//==============================================================================
+template <typename Index>
+class random_scene {
+public:
+    using rect   = typename Index::rect;
+    using point  = typename Index::point;
+    using handle = typename Index::handle;
+    using coord  = decltype(std::declval<rect>().left());
+
+    //! @param min_size The least width and height of the rects: 0 for some
+    //!        to be empty.
+    random_scene(Index& index, unsigned const seed, coord const min_size)
+      : index_    (index)
+      , rng_      {seed}
+      , min_size_ {min_size}
+    {
+    }
+
+    //! A rect, mostly small; one side in ten is large.
+    rect random_rect() {
+        auto const x = uniform_(coord (-20), coord (520));
+        auto const y = uniform_(coord (-20), coord (520));
+        auto const w = (rng_() % 10 == 0) ? uniform_(coord (1), coord (100)) : uniform_(min_size_, coord (12));
+        auto const h = (rng_() % 10 == 0) ? uniform_(coord (1), coord (100)) : uniform_(min_size_, coord (12));
+
+        return rect {typename rect::allow_malformed {}, x, y, x + w, y + h};
+    }
+
+    //! Insert a random rect; its value is its number in the scene.
+    void add() {
+        auto const r = random_rect();
+        auto const i = static_cast<int>(bounds.size());
+
+        handles.push_back(index_.insert(r, i));
+        bounds.push_back(r);
+        alive.push_back(true);
+    }
+
+    //! Remove one rect in 50, replace one in 10 and move the rest a little.
+    void step() {
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            if (!alive[i]) {
+                continue;
+            }
+
+            if (rng_() % 50 == 0) {
+                index_.remove(handles[i]);
+                alive[i] = false;
+                continue;
+            }
+
+            auto r = bounds[i];
+            if (rng_() % 10 == 0) {
+                r = random_rect();
+            } else {
+                r.translate(uniform_(coord (-2), coord (2)), uniform_(coord (-2), coord (2)));
+            }
+
+            index_.update(handles[i], r);
+            bounds[i] = r;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    pairs expected_pairs() const {
+        pairs result;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            for (size_t j = i + 1; j < bounds.size(); ++j) {
+                if (alive[i] && alive[j] && intersects(bounds[i], bounds[j])) {
+                    result.emplace_back(static_cast<int>(i), static_cast<int>(j));
+                }
+            }
+        }
+
+        return result;
+    }
+
+    //! The values whose bounds satisfy @c pred, sorted.
+    template <typename Predicate>
+    std::vector<int> expected(Predicate&& pred) const {
+        std::vector<int> result;
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            if (alive[i] && pred(bounds[i])) {
+                result.push_back(static_cast<int>(i));
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<handle> handles;
+    std::vector<rect>   bounds;
+    std::vector<bool>   alive;
+private:
+    using distribution = typename std::conditional<std::is_integral<coord>::value
+      , std::uniform_int_distribution<coord>
+      , std::uniform_real_distribution<coord>
+    >::type;
+
+    coord uniform_(coord const lo, coord const hi) {
+        return distribution {lo, hi}(rng_);
+    }
+
+    Index&       index_;
+    std::mt19937 rng_;
+    coord        min_size_;
+};
+
+} //namespace spatial_test
@@ -0,0 +1,112 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "sweep_and_prune.hpp"
+#include "spatial_index_test.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+using bklib::sweep_and_prune;
+using spatial_test::pairs;
+using spatial_test::sorted_pairs;
+
+namespace {
+using sap  = sweep_and_prune<int, int>;
+using rect = sap::rect;
+} //namespace
+
+TEST(SweepAndPrune, Events) {
+    sap s;
+
+    pairs began;
+    pairs ended;
+    s.listen(bklib::on_overlap_begin {[&](bklib::spatial_handle const a, bklib::spatial_handle const b) {
+        began.emplace_back(static_cast<int>(a.index), static_cast<int>(b.index));
+    }});
+    s.listen(bklib::on_overlap_end {[&](bklib::spatial_handle const a, bklib::spatial_handle const b) {
+        ended.emplace_back(static_cast<int>(a.index), static_cast<int>(b.index));
+    }});
+
+    auto const a = s.insert(rect {0, 0, 10, 10}, 1);
+    auto const b = s.insert(rect {5, 5, 25, 25}, 2);
+    auto const c = s.insert(rect {20, 20, 30, 30}, 3);
+    auto const d = s.insert(rect {10, 0, 20, 10}, 4);  // touching a: half open, so not.
+
+    s.sweep();
+    ASSERT_EQ(3u, s.pair_count());
+    ASSERT_EQ(3u, s.added().size());
+
+    std::sort(began.begin(), began.end());
+    ASSERT_EQ((pairs {{0, 1}, {1, 2}, {1, 3}}), began);
+    ASSERT_TRUE(ended.empty());
+
+    // a and d come to touch, then to overlap; b moves away from c.
+    began.clear();
+    ASSERT_FALSE(s.update(a, rect {0, 0, 10, 10}));
+    ASSERT_TRUE(s.update(a, rect {1, 0, 11, 10}));
+    ASSERT_TRUE(s.update(b, rect {5, 5, 15, 15}));
+    s.sweep();
+
+    ASSERT_EQ((pairs {{0, 3}}), began);
+    ASSERT_EQ((pairs {{1, 2}}), ended);
+    ASSERT_EQ((std::vector<bklib::spatial_pair> {{a, d}}), s.added());
+    ASSERT_EQ((std::vector<bklib::spatial_pair> {{b, c}}), s.removed());
+    ASSERT_EQ((pairs {{1, 2}, {1, 4}, {2, 4}}), sorted_pairs(s));
+
+    // nothing changed: no events.
+    began.clear();
+    ended.clear();
+    s.sweep();
+    ASSERT_TRUE(began.empty() && ended.empty());
+
+    // removal ends the pairs, told with the handle b had.
+    s.remove(b);
+    s.sweep();
+
+    std::sort(ended.begin(), ended.end());
+    ASSERT_EQ((pairs {{0, 1}, {1, 3}}), ended);
+    ASSERT_EQ((std::vector<bklib::spatial_pair> {{a, b}, {b, d}}), s.removed());
+}
+
+TEST(SweepAndPrune, EventsMatchPairs) {
+    sap s;
+
+    // the pairs (of handles) as told by the events alone.
+    std::set<bklib::spatial_pair> told;
+    s.listen(bklib::on_overlap_begin {[&](bklib::spatial_handle const a, bklib::spatial_handle const b) {
+        ASSERT_LT(a, b);
+        ASSERT_TRUE(told.emplace(a, b).second);
+    }});
+    s.listen(bklib::on_overlap_end {[&](bklib::spatial_handle const a, bklib::spatial_handle const b) {
+        ASSERT_LT(a, b);
+        ASSERT_EQ(1u, told.erase(bklib::spatial_pair {a, b}));
+    }});
+
+    spatial_test::random_scene<sap> scene {s, 5, 0};
+    for (int i = 0; i < 1000; ++i) {
+        scene.add();
+    }
+
+    for (int frame = 0; frame < 10; ++frame) {
+        scene.step();
+
+        // a few insertions sort in; many start over.
+        for (int i = (frame == 5) ? 800 : 10; i > 0; --i) {
+            scene.add();
+        }
+
+        s.sweep();
+
+        pairs from_events;
+        for (auto const& p : told) {
+            auto const a = s.value(p.first);
+            auto const b = s.value(p.second);
+            from_events.emplace_back(std::min(a, b), std::max(a, b));
+        }
+
+        std::sort(from_events.begin(), from_events.end());
+        ASSERT_EQ(scene.expected_pairs(), from_events);
+    }
+}
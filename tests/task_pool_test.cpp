@@ -0,0 +1,130 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "task_pool.hpp"
+
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+using bklib::task_pool;
+using bklib::task_group;
+using bklib::task_graph;
+
+TEST(TaskPool, Run) {
+    task_pool pool {3};
+    ASSERT_EQ(3u, pool.size());
+
+    std::atomic<int> count {0};
+    task_group group;
+
+    for (int i = 0; i < 1000; ++i) {
+        pool.run(group, [&] { ++count; });
+    }
+
+    pool.wait(group);
+    ASSERT_TRUE(group.done());
+    ASSERT_EQ(1000, count);
+}
+
+TEST(TaskPool, Nested) {
+    task_pool pool {4};
+
+    // tasks that spawn and wait on tasks must not deadlock.
+    std::atomic<int> count {0};
+    task_group outer;
+
+    for (int i = 0; i < 16; ++i) {
+        pool.run(outer, [&] {
+            task_group inner;
+            for (int j = 0; j < 64; ++j) {
+                pool.run(inner, [&] { ++count; });
+            }
+            pool.wait(inner);
+        });
+    }
+
+    pool.wait(outer);
+    ASSERT_EQ(16 * 64, count);
+}
+
+TEST(TaskPool, Exception) {
+    task_pool pool {2};
+    task_group group;
+
+    std::atomic<int> count {0};
+    for (int i = 0; i < 100; ++i) {
+        pool.run(group, [&, i] {
+            ++count;
+            if (i == 50) throw std::runtime_error {"fail"};
+        });
+    }
+
+    ASSERT_THROW(pool.wait(group), std::runtime_error);
+    ASSERT_EQ(100, count);
+
+    // the error is reported once.
+    pool.wait(group);
+}
+
+TEST(TaskPool, ParallelFor) {
+    task_pool pool {3};
+
+    std::vector<int> values(10007, 0);
+    pool.parallel_for(0, values.size(), [&](size_t const i) {
+        values[i] += static_cast<int>(i);
+    });
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(static_cast<int>(i), values[i]);
+    }
+
+    ASSERT_THROW(pool.parallel_for(0, 100, [](size_t const i) {
+        if (i == 99) throw std::runtime_error {"fail"};
+    }), std::runtime_error);
+
+    pool.parallel_for(5, 5, [](size_t) { FAIL(); });
+}
+
+TEST(TaskGraph, Order) {
+    task_pool pool {3};
+    task_graph graph;
+
+    // a diamond, a -> {b, c} -> d, with a chain after d.
+    std::atomic<int> step {0};
+    int a = -1, b = -1, c = -1, d = -1, e = -1;
+
+    auto const na = graph.add([&] { a = step++; });
+    auto const nb = graph.add([&] { b = step++; });
+    auto const nc = graph.add([&] { c = step++; });
+    auto const nd = graph.add([&] { d = step++; });
+
+    graph.precede(na, nb);
+    graph.precede(na, nc);
+    graph.precede(nb, nd);
+    graph.precede(nc, nd);
+    graph.then(nd, [&] { e = step++; });
+
+    for (int run = 0; run < 100; ++run) {
+        step = 0;
+        graph.run(pool);
+
+        ASSERT_EQ(0, a);
+        ASSERT_LT(a, b);
+        ASSERT_LT(a, c);
+        ASSERT_LT(b, d);
+        ASSERT_LT(c, d);
+        ASSERT_EQ(4, e);
+    }
+}
+
+TEST(TaskGraph, Exception) {
+    task_pool pool {2};
+    task_graph graph;
+
+    bool ran = false;
+    auto const first = graph.add([] { throw std::runtime_error {"fail"}; });
+    graph.then(first, [&] { ran = true; });
+
+    ASSERT_THROW(graph.run(pool), std::runtime_error);
+    ASSERT_FALSE(ran);
+}
@@ -0,0 +1,221 @@
+#include "pch.hpp"
+#include <gtest/gtest.h>
+#include "utf8.hpp"
+#include "util.hpp"
+
+using bklib::string_ref;
+
+namespace {
+//==============================================================================
+// Straightforward decoder used as the reference for the fuzz tests: decode
+// each code point then reject overlong forms, surrogates and out of range
+// values after the fact.
+//==============================================================================
+bool reference_validate(std::vector<unsigned char> const& in) {
+    size_t i = 0;
+
+    while (i < in.size()) {
+        unsigned const c = in[i];
+
+        size_t   len = 0;
+        uint32_t cp  = 0;
+
+        if      ((c & 0x80) == 0x00) { len = 1; cp = c; }
+        else if ((c & 0xE0) == 0xC0) { len = 2; cp = c & 0x1F; }
+        else if ((c & 0xF0) == 0xE0) { len = 3; cp = c & 0x0F; }
+        else if ((c & 0xF8) == 0xF0) { len = 4; cp = c & 0x07; }
+        else return false;
+
+        if (i + len > in.size()) return false;
+
+        for (size_t j = 1; j < len; ++j) {
+            unsigned const cc = in[i + j];
+            if ((cc & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (cc & 0x3F);
+        }
+
+        static uint32_t const min_value[] = {0, 0, 0x80, 0x800, 0x10000};
+
+        if (cp < min_value[len])               return false;
+        if (cp > 0x10FFFF)                     return false;
+        if (cp >= 0xD800 && cp <= 0xDFFF)      return false;
+
+        i += len;
+    }
+
+    return true;
+}
+
+bool reference_is_ascii(std::vector<unsigned char> const& in) {
+    return std::all_of(std::begin(in), std::end(in), [](unsigned char c) {
+        return c < 0x80;
+    });
+}
+
+void append_code_point(std::vector<unsigned char>& out, uint32_t const cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<unsigned char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<unsigned char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<unsigned char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<unsigned char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<unsigned char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<unsigned char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<unsigned char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+string_ref as_string_ref(std::vector<unsigned char> const& v) {
+    return {reinterpret_cast<char const*>(v.data()), v.size()};
+}
+
+#define BK_CHECK_ALL(BUFFER)\
+    do {\
+        auto const str_ = as_string_ref(BUFFER);\
+        auto const utf8_ = reference_validate(BUFFER);\
+        auto const ascii_ = reference_is_ascii(BUFFER);\
+        ASSERT_EQ(utf8_, bklib::validate_utf8(str_));\
+        ASSERT_EQ(utf8_, bklib::detail::validate_utf8_scalar(str_));\
+        ASSERT_EQ(ascii_, bklib::is_ascii(str_));\
+        ASSERT_EQ(ascii_, bklib::detail::is_ascii_scalar(str_));\
+    } while (false)
+} //namespace
+
+//==============================================================================
+TEST(Utf8, IsAscii) {
+    ASSERT_TRUE(bklib::is_ascii(string_ref{}));
+    ASSERT_TRUE(bklib::is_ascii("hello world"));
+    ASSERT_FALSE(bklib::is_ascii("caf\xC3\xA9"));
+
+    // embedded nulls are fine when the length is given.
+    char const data[] = "abc\0def";
+    ASSERT_TRUE(bklib::is_ascii(string_ref{data, sizeof(data) - 1}));
+
+    // a single high byte anywhere in a long run.
+    std::vector<unsigned char> buffer(300, 'a');
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = 0x80;
+        ASSERT_FALSE(bklib::is_ascii(as_string_ref(buffer)));
+        buffer[i] = 'a';
+    }
+}
+//==============================================================================
+TEST(Utf8, KnownSequences) {
+    struct test_case { char const* str; bool valid; };
+
+    test_case const cases[] = {
+        {"",                 true}
+      , {"\x7F",             true}
+      , {"\xC2\x80",         true}  // U+0080
+      , {"\xDF\xBF",         true}  // U+07FF
+      , {"\xE0\xA0\x80",     true}  // U+0800
+      , {"\xED\x9F\xBF",     true}  // U+D7FF
+      , {"\xEE\x80\x80",     true}  // U+E000
+      , {"\xEF\xBF\xBF",     true}  // U+FFFF
+      , {"\xF0\x90\x80\x80", true}  // U+10000
+      , {"\xF4\x8F\xBF\xBF", true}  // U+10FFFF
+      , {"\x80",             false} // lone continuation
+      , {"\xC0\xAF",         false} // overlong '/'
+      , {"\xC1\xBF",         false} // overlong
+      , {"\xE0\x9F\xBF",     false} // overlong
+      , {"\xF0\x8F\xBF\xBF", false} // overlong
+      , {"\xED\xA0\x80",     false} // U+D800
+      , {"\xED\xBF\xBF",     false} // U+DFFF
+      , {"\xF4\x90\x80\x80", false} // U+110000
+      , {"\xF5\x80\x80\x80", false}
+      , {"\xFF",             false}
+      , {"\xC2",             false} // truncated
+      , {"\xE0\xA0",         false} // truncated
+      , {"\xF0\x90\x80",     false} // truncated
+      , {"\xC2\x80\x80",     false} // too long
+    };
+
+    for (auto const& c : cases) {
+        std::vector<unsigned char> buffer(c.str, c.str + std::strlen(c.str));
+        ASSERT_EQ(c.valid, bklib::validate_utf8(as_string_ref(buffer))) << "case: " << c.str;
+        BK_CHECK_ALL(buffer);
+
+        // and again at every offset across a vector boundary.
+        for (size_t pad = 1; pad < 70; ++pad) {
+            std::vector<unsigned char> padded(pad, 'x');
+            padded.insert(std::end(padded), std::begin(buffer), std::end(buffer));
+            BK_CHECK_ALL(padded);
+
+            padded.insert(std::end(padded), 40, 'y');
+            BK_CHECK_ALL(padded);
+        }
+    }
+}
+//==============================================================================
+TEST(Utf8, FuzzRandomBytes) {
+    std::mt19937 random {1234};
+    std::uniform_int_distribution<int> byte_dist {0, 255};
+    std::uniform_int_distribution<size_t> size_dist {0, 200};
+
+    for (int n = 0; n < 20000; ++n) {
+        std::vector<unsigned char> buffer(size_dist(random));
+        for (auto& c : buffer) {
+            c = static_cast<unsigned char>(byte_dist(random));
+        }
+
+        BK_CHECK_ALL(buffer);
+    }
+}
+//==============================================================================
+TEST(Utf8, FuzzMutatedText) {
+    std::mt19937 random {5678};
+
+    std::uniform_int_distribution<int>      class_dist {0, 3};
+    std::uniform_int_distribution<uint32_t> ascii_dist {0x00, 0x7F};
+    std::uniform_int_distribution<uint32_t> cp2_dist   {0x80, 0x7FF};
+    std::uniform_int_distribution<uint32_t> cp3_dist   {0x800, 0xFFFF};
+    std::uniform_int_distribution<uint32_t> cp4_dist   {0x10000, 0x10FFFF};
+    std::uniform_int_distribution<size_t>   count_dist {0, 150};
+    std::uniform_int_distribution<int>      byte_dist  {0, 255};
+
+    auto const random_code_point = [&]() -> uint32_t {
+        switch (class_dist(random)) {
+        default:
+        case 0: return ascii_dist(random);
+        case 1: return cp2_dist(random);
+        case 2: for (;;) {
+                    auto const cp = cp3_dist(random);
+                    if (cp < 0xD800 || cp > 0xDFFF) return cp;
+                }
+        case 3: return cp4_dist(random);
+        }
+    };
+
+    for (int n = 0; n < 20000; ++n) {
+        std::vector<unsigned char> buffer;
+
+        auto const count = count_dist(random);
+        for (size_t i = 0; i < count; ++i) {
+            append_code_point(buffer, random_code_point());
+        }
+
+        ASSERT_TRUE(bklib::validate_utf8(as_string_ref(buffer)));
+        BK_CHECK_ALL(buffer);
+
+        if (buffer.empty()) {
+            continue;
+        }
+
+        // corrupt a single byte, or truncate.
+        std::uniform_int_distribution<size_t> pos_dist {0, buffer.size() - 1};
+
+        auto mutated = buffer;
+        mutated[pos_dist(random)] = static_cast<unsigned char>(byte_dist(random));
+        BK_CHECK_ALL(mutated);
+
+        mutated = buffer;
+        mutated.resize(pos_dist(random));
+        BK_CHECK_ALL(mutated);
+    }
+}
+//==============================================================================
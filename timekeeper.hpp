@@ -5,6 +5,7 @@
 #include <functional>
 
 #include "config.hpp"
+#include "slot_map.hpp"
 
 namespace bklib {
 
@@ -17,7 +18,7 @@ public:
     using callback   = std::function<void (delta dt)>;
 
 
-    struct handle { size_t id; };
+    using handle = slot_handle;
 
     struct record {
         timekeeper::handle     handle;
@@ -40,16 +41,21 @@ public:
     //! Update the time and execute all callbacks which have met or exceeded
     //! their deadlines.
     void update();
+
+    //! Stop calling the callback for @c h; stale handles are ignored.
+    //! @pre not called from within a callback.
+    //! @returns true if @c h referred to a registered callback.
+    bool unregister_event(handle h);
 private:
     //! predicate to maintain a min heap.
-    bool heap_predidate_(uint16_t a, uint16_t b) const BK_NOEXCEPT {
+    bool heap_predidate_(handle a, handle b) const BK_NOEXCEPT {
         return records_[a].deadline > records_[b].deadline;
     }
 
     handle register_event_(duration period, callback f);
 
-    std::vector<record>   records_; //!< unsorted records
-    std::vector<uint16_t> heap_;    //!< sorted (heap) of indicies into records_
+    slot_map<record>    records_; //!< unsorted records
+    std::vector<handle> heap_;    //!< sorted (heap) of handles into records_
 };
 
 } // namespace bklib
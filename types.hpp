@@ -31,7 +31,7 @@ namespace bklib {
 
     using boost::container::flat_map;
     using boost::container::flat_set;
-#if defined(BOOST_OS_WINDOWS)
+#if BOOST_OS_WINDOWS
     using platform_char   = wchar_t;
     using platform_string = std::basic_string<platform_char>;
 #else
@@ -0,0 +1,72 @@
+//==============================================================================
+//! ASCII and UTF-8 validation.
+//! @file
+//==============================================================================
+#pragma once
+
+#include "types.hpp"
+#include "config.hpp"
+
+namespace bklib {
+
+//==============================================================================
+//! @returns true if every byte in @c str is in [0x00, 0x7F].
+//! Unlike is_ascii(char const*), embedded nulls are permitted.
+//==============================================================================
+bool is_ascii(string_ref str) BK_NOEXCEPT;
+
+//==============================================================================
+//! @returns true if @c str is well formed UTF-8; that is, every sequence is
+//! of minimal length, encodes a scalar value <= U+10FFFF and is not a
+//! surrogate.
+//==============================================================================
+bool validate_utf8(string_ref str) BK_NOEXCEPT;
+
+namespace detail {
+    //! Byte at a time reference implementations; always available.
+    bool is_ascii_scalar(string_ref str) BK_NOEXCEPT;
+    bool validate_utf8_scalar(string_ref str) BK_NOEXCEPT;
+
+    //--------------------------------------------------------------------------
+    //! @returns The length of the sequence starting at @c first or 0 if the
+    //! sequence is malformed or truncated by @c last.
+    //! @pre first < last.
+    //--------------------------------------------------------------------------
+    inline size_t utf8_sequence_length(
+        unsigned char const* const first
+      , unsigned char const* const last
+    ) BK_NOEXCEPT {
+        auto const avail = static_cast<size_t>(last - first);
+        auto const is_cont = [](unsigned char const c) { return (c & 0xC0) == 0x80; };
+
+        auto const c0 = first[0];
+
+        if (c0 < 0x80) {
+            return 1;
+        } else if (c0 < 0xC2) {
+            return 0; //continuation or overlong 2 byte lead
+        } else if (c0 < 0xE0) {
+            return (avail >= 2 && is_cont(first[1])) ? 2 : 0;
+        } else if (c0 < 0xF0) {
+            if (avail < 3) return 0;
+
+            auto const c1 = first[1];
+            auto const lo = (c0 == 0xE0) ? 0xA0 : 0x80; //overlong
+            auto const hi = (c0 == 0xED) ? 0x9F : 0xBF; //surrogates
+
+            return (c1 >= lo && c1 <= hi && is_cont(first[2])) ? 3 : 0;
+        } else if (c0 < 0xF5) {
+            if (avail < 4) return 0;
+
+            auto const c1 = first[1];
+            auto const lo = (c0 == 0xF0) ? 0x90 : 0x80; //overlong
+            auto const hi = (c0 == 0xF4) ? 0x8F : 0xBF; //> U+10FFFF
+
+            return (c1 >= lo && c1 <= hi && is_cont(first[2]) && is_cont(first[3])) ? 4 : 0;
+        }
+
+        return 0;
+    }
+} //namespace detail
+
+} //namespace bklib
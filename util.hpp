@@ -1,18 +1,24 @@
 #pragma once
 
+#include <cstring>
+
 #include "types.hpp"
 #include "assert.hpp"
+#include "utf8.hpp"
+
+#if BOOST_COMP_MSVC
+#   include <intrin.h>
+#endif
 
 namespace bklib {
 
+//==============================================================================
+//! @see is_ascii(string_ref).
+//! @pre str is null terminated.
+//==============================================================================
 inline bool is_ascii(char const* str) {
     BK_ASSERT(str != nullptr);
-
-    while (char const c = *str++) {
-        if (c != (c & char{0x7F})) return false;
-    }
-
-    return true;
+    return is_ascii(string_ref{str, std::strlen(str)});
 }
 
 template <typename T>
@@ -90,6 +96,43 @@ inline auto get_enum_value(Enum const e) BK_NOEXCEPT {
     return static_cast<std::underlying_type_t<Enum>>(e);
 }
 
+//==============================================================================
+//! @returns The index of the lowest set bit in @c x.
+//! @pre x != 0.
+//==============================================================================
+inline unsigned count_trailing_zeros(uint64_t const x) BK_NOEXCEPT {
+#if BOOST_COMP_MSVC
+    unsigned long result;
+    _BitScanForward64(&result, x);
+    return static_cast<unsigned>(result);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+//==============================================================================
+//! @returns The index of the highest set bit in @c x.
+//! @pre x != 0.
+//==============================================================================
+inline unsigned highest_set_bit(uint64_t const x) BK_NOEXCEPT {
+#if BOOST_COMP_MSVC
+    unsigned long result;
+    _BitScanReverse64(&result, x);
+    return static_cast<unsigned>(result);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+//==============================================================================
+//! @returns The number of set bits in @c x.
+//==============================================================================
+inline unsigned count_set_bits(uint64_t const x) BK_NOEXCEPT {
+#if BOOST_COMP_MSVC
+    return static_cast<unsigned>(__popcnt64(x));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#endif
+}
+
 //==============================================================================
 // Enum -> Bit flags helper.
 //==============================================================================
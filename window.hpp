@@ -1,11 +1,13 @@
 #pragma once
 
+#include <array>
 #include <memory>
 
 #include "types.hpp"
 #include "callback.hpp"
 #include "math.hpp"
 #include "util.hpp"
+#include "histogram.hpp"
 
 #include "keyboard.hpp"
 #include "mouse.hpp"
@@ -14,13 +16,13 @@
 
 namespace bklib {
 //==============================================================================
-#if defined(BOOST_OS_WINDOWS)
+#if BOOST_OS_WINDOWS
     struct platform_window_handle {
         operator HWND() const { return value; }
         HWND value;
     };
 #else
-#   error "define me"
+#   error "platform_window is only implemented for Windows"
 #endif
 //==============================================================================
 BK_DECLARE_EVENT(on_create, void());
@@ -28,6 +30,33 @@ BK_DECLARE_EVENT(on_paint,  void());
 BK_DECLARE_EVENT(on_close,  void());
 BK_DECLARE_EVENT(on_resize, void(unsigned w, unsigned h));
 //==============================================================================
+//! Kinds of input event; @see input_statistics.
+//==============================================================================
+enum class input_event : uint8_t {
+    raw_mouse   //!< WM_INPUT from a mouse.
+  , mouse_move  //!< WM_MOUSEMOVE.
+  , keyboard    //!< WM_INPUT from a keyboard.
+};
+
+static BK_CONSTEXPR size_t const INPUT_EVENT_TYPES = 3;
+
+//==============================================================================
+//! Input latency and queueing, for platform_window::get_input_statistics.
+//==============================================================================
+struct input_statistics {
+    //! Nanoseconds from an event's capture on the window thread to the
+    //! dispatch of its callbacks in do_events(); indexed by input_event.
+    std::array<histogram_snapshot, INPUT_EVENT_TYPES> latency;
+
+    //! The number of events waiting for do_events(), the new one included,
+    //! each time an event is queued.
+    histogram_snapshot queue_depth;
+
+    histogram_snapshot const& operator[](input_event const e) const BK_NOEXCEPT {
+        return latency[static_cast<size_t>(e)];
+    }
+};
+//==============================================================================
 //! Abstraction of a native window.
 //==============================================================================
 class platform_window {
@@ -55,6 +84,9 @@ public:
     void do_events();
 
     platform_window_handle get_handle() const;
+
+    //! Recording continues regardless; with @c reset, from empty histograms.
+    input_statistics get_input_statistics(bool reset = false);
     //--------------------------------------------------------------------------
     void listen(on_create        callback);
     void listen(on_paint         callback);
@@ -63,6 +95,9 @@ public:
 
     void listen(on_mouse_enter   callback);
     void listen(on_mouse_exit    callback);
+    void listen(on_mouse_hover   callback);
+    void listen(on_mouse_click   callback);
+    void listen(on_mouse_dbl_click callback);
     void listen(on_mouse_move    callback);
     void listen(on_mouse_move_to callback);
     void listen(on_mouse_down    callback);